@@ -14,6 +14,15 @@ Settings::Settings(const Settings& other) = default;
 
 Settings::~Settings() = default;
 
+static std::string ThreadConfigToString(const fml::ThreadConfig& config) {
+  std::stringstream stream;
+  stream << "policy=" << static_cast<int>(config.policy)
+         << " nice=" << config.nice
+         << " realtime_priority=" << config.realtime_priority
+         << " cpu_affinity_mask=0x" << std::hex << config.cpu_affinity_mask;
+  return stream.str();
+}
+
 std::string Settings::ToString() const {
   std::stringstream stream;
   stream << "Settings: " << std::endl;
@@ -44,8 +53,32 @@ std::string Settings::ToString() const {
   stream << "use_test_fonts: " << use_test_fonts << std::endl;
   stream << "enable_software_rendering: " << enable_software_rendering
          << std::endl;
+  stream << "enable_async_raster_cache: " << enable_async_raster_cache
+         << std::endl;
+  stream << "layer_tree_pipeline_depth: " << layer_tree_pipeline_depth
+         << std::endl;
+  stream << "drop_superseded_frames: " << drop_superseded_frames << std::endl;
+  stream << "frame_timings_report_count: " << frame_timings_report_count
+         << std::endl;
+  stream << "frame_timings_report_interval_ms: "
+         << frame_timings_report_interval_ms << std::endl;
+  stream << "slow_frame_capture_threshold: " << slow_frame_capture_threshold
+         << std::endl;
+  stream << "slow_frame_capture_path: " << slow_frame_capture_path
+         << std::endl;
+  stream << "slow_frame_capture_count: " << slow_frame_capture_count
+         << std::endl;
+  stream << "enable_layer_profiling: " << enable_layer_profiling << std::endl;
   stream << "log_tag: " << log_tag << std::endl;
   stream << "icu_data_path: " << icu_data_path << std::endl;
+  stream << "platform_thread_config: "
+         << ThreadConfigToString(platform_thread_config) << std::endl;
+  stream << "ui_thread_config: " << ThreadConfigToString(ui_thread_config)
+         << std::endl;
+  stream << "gpu_thread_config: " << ThreadConfigToString(gpu_thread_config)
+         << std::endl;
+  stream << "io_thread_config: " << ThreadConfigToString(io_thread_config)
+         << std::endl;
   stream << "assets_dir: " << assets_dir << std::endl;
   stream << "assets_path: " << assets_path << std::endl;
   return stream.str();
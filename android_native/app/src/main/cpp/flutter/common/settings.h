@@ -8,11 +8,14 @@
 #include <fcntl.h>
 #include <stdint.h>
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "flutter/fml/closure.h"
+#include "flutter/fml/thread.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/unique_fd.h"
 
 namespace blink {
@@ -21,6 +24,37 @@ using TaskObserverAdd =
     std::function<void(intptr_t /* key */, fml::closure /* callback */)>;
 using TaskObserverRemove = std::function<void(intptr_t /* key */)>;
 
+// When each phase of a frame happened. The build phases are recorded on the
+// UI thread and the raster phases on the GPU thread. Frames that were built
+// but dropped in favor of a newer frame before they could be rasterized have
+// zero raster and submit times.
+class FrameTiming {
+ public:
+  enum Phase {
+    // The vsync the frame was built for.
+    kVsyncStart,
+    kBuildStart,
+    kBuildFinish,
+    kRasterStart,
+    kRasterFinish,
+    // The frame was handed to the surface.
+    kSubmit,
+    kCount
+  };
+
+  fml::TimePoint Get(Phase phase) const { return data_[phase]; }
+
+  fml::TimePoint Set(Phase phase, fml::TimePoint value) {
+    return data_[phase] = value;
+  }
+
+ private:
+  fml::TimePoint data_[kCount];
+};
+
+using FrameTimingsCallback =
+    std::function<void(const std::vector<FrameTiming>& /* timings */)>;
+
 struct Settings {
   Settings();
 
@@ -78,11 +112,45 @@ struct Settings {
   // call is made.
   fml::closure root_isolate_shutdown_callback;
   bool enable_software_rendering = false;
+  // Rasterize pictures for the raster cache of software surfaces on the
+  // concurrent workers instead of during preroll on the GPU thread.
+  bool enable_async_raster_cache = false;
+  // The number of layer trees the UI thread may produce ahead of the GPU
+  // thread.
+  uint32_t layer_tree_pipeline_depth = 2;
+  // Once the GPU thread falls behind, rasterize only the latest layer tree
+  // and drop the ones it supersedes instead of catching up frame by frame.
+  bool drop_superseded_frames = false;
+  // Called on the platform thread with the timings of the frames rasterized
+  // since the previous call. The timings are also reported to the UI library.
+  FrameTimingsCallback frame_timings_callback;
+  // Frame timings are reported in batches of this many frames, or once the
+  // oldest unreported one is |frame_timings_report_interval_ms| old.
+  uint32_t frame_timings_report_count = 100;
+  uint32_t frame_timings_report_interval_ms = 100;
+  // Frames that take more than this many frame intervals from their vsync
+  // till they are submitted are captured to |slow_frame_capture_path|. Zero
+  // disables capturing.
+  uint32_t slow_frame_capture_threshold = 0;
+  // The directory slow frames are captured to. Capturing is disabled if
+  // empty. See |shell::FrameCaptureRing|.
+  std::string slow_frame_capture_path;
+  // Only the most recent captures are kept.
+  uint32_t slow_frame_capture_count = 10;
+  // Measure the time each layer takes to preroll and paint. The profile of a
+  // frame is added to its slow frame capture. See |flow::LayerProfile|.
+  bool enable_layer_profiling = false;
   bool skia_deterministic_rendering_on_cpu = false;
   bool verbose_logging = false;
   std::string log_tag = "flutter";
   std::string icu_data_path;
 
+  // Thread settings. Applied to the threads the shell creates for an engine.
+  fml::ThreadConfig platform_thread_config;
+  fml::ThreadConfig ui_thread_config;
+  fml::ThreadConfig gpu_thread_config;
+  fml::ThreadConfig io_thread_config;
+
   // Assets settings
   fml::UniqueFD::element_type assets_dir =
       fml::UniqueFD::traits_type::InvalidValue();
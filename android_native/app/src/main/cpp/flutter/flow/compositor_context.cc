@@ -6,10 +6,22 @@
 
 #include "flutter/flow/layers/layer_tree.h"
 #include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkRegion.h"
 
 namespace flow {
 
-CompositorContext::CompositorContext() = default;
+// Rasterizing new raster cache entries may take up about a quarter of a 60Hz
+// frame and a couple of screens worth of pixels. The rest is deferred.
+static constexpr int64_t kRasterCachePopulationMillis = 4;
+static constexpr int64_t kRasterCachePopulationPixels = 2 * 1920 * 1080;
+
+CompositorContext::CompositorContext() {
+  RasterCache::PopulationBudget budget;
+  budget.max_time =
+      fml::TimeDelta::FromMilliseconds(kRasterCachePopulationMillis);
+  budget.max_pixels = kRasterCachePopulationPixels;
+  raster_cache_.SetPopulationBudget(budget);
+}
 
 CompositorContext::~CompositorContext() = default;
 
@@ -22,8 +34,11 @@ void CompositorContext::BeginFrame(ScopedFrame& frame,
 }
 
 void CompositorContext::EndFrame(ScopedFrame& frame,
-                                 bool enable_instrumentation) {
-  raster_cache_.SweepAfterFrame();
+                                 bool enable_instrumentation,
+                                 bool sweep_raster_cache) {
+  if (sweep_raster_cache) {
+    raster_cache_.SweepAfterFrame();
+  }
   if (enable_instrumentation) {
     frame_time_.Stop();
   }
@@ -34,10 +49,11 @@ std::unique_ptr<CompositorContext::ScopedFrame> CompositorContext::AcquireFrame(
     SkCanvas* canvas,
     ExternalViewEmbedder* view_embedder,
     const SkMatrix& root_surface_transformation,
-    bool instrumentation_enabled) {
-  return std::make_unique<ScopedFrame>(*this, gr_context, canvas, view_embedder,
-                                       root_surface_transformation,
-                                       instrumentation_enabled);
+    bool instrumentation_enabled,
+    bool sweep_raster_cache) {
+  return std::make_unique<ScopedFrame>(
+      *this, gr_context, canvas, view_embedder, root_surface_transformation,
+      instrumentation_enabled, sweep_raster_cache);
 }
 
 CompositorContext::ScopedFrame::ScopedFrame(
@@ -46,23 +62,46 @@ CompositorContext::ScopedFrame::ScopedFrame(
     SkCanvas* canvas,
     ExternalViewEmbedder* view_embedder,
     const SkMatrix& root_surface_transformation,
-    bool instrumentation_enabled)
+    bool instrumentation_enabled,
+    bool sweep_raster_cache)
     : context_(context),
       gr_context_(gr_context),
       canvas_(canvas),
       view_embedder_(view_embedder),
       root_surface_transformation_(root_surface_transformation),
-      instrumentation_enabled_(instrumentation_enabled) {
+      instrumentation_enabled_(instrumentation_enabled),
+      sweep_raster_cache_(sweep_raster_cache) {
+  if (instrumentation_enabled_ && context_.layer_profiling_enabled()) {
+    layer_profile_ = std::make_unique<LayerProfile>();
+  }
   context_.BeginFrame(*this, instrumentation_enabled_);
 }
 
 CompositorContext::ScopedFrame::~ScopedFrame() {
-  context_.EndFrame(*this, instrumentation_enabled_);
+  context_.EndFrame(*this, instrumentation_enabled_, sweep_raster_cache_);
 }
 
 bool CompositorContext::ScopedFrame::Raster(flow::LayerTree& layer_tree,
-                                            bool ignore_raster_cache) {
+                                            bool ignore_raster_cache,
+                                            FrameDamage* frame_damage) {
   layer_tree.Preroll(*this, ignore_raster_cache);
+  layer_tree.Optimize(*this, ignore_raster_cache);
+
+  SkAutoCanvasRestore save(canvas(), frame_damage != nullptr);
+  if (frame_damage != nullptr) {
+    FML_DCHECK(frame_damage->tracker != nullptr);
+    frame_damage->buffer_damage = frame_damage->tracker->ComputeDamage(
+        layer_tree.CollectPaintRegions(root_surface_transformation()),
+        layer_tree.frame_size(), frame_damage->buffer_age);
+    if (frame_damage->buffer_damage.isEmpty()) {
+      // Nothing changed.
+      return true;
+    }
+    // The damage is in device space. So avoid the current matrix.
+    canvas()->clipRegion(SkRegion(frame_damage->buffer_damage));
+    canvas()->clear(SK_ColorTRANSPARENT);
+  }
+
   layer_tree.Paint(*this, ignore_raster_cache);
   return true;
 }
@@ -77,4 +116,12 @@ void CompositorContext::OnGrContextDestroyed() {
   raster_cache_.Clear();
 }
 
+FrameStatistics CompositorContext::GetFrameStatistics() const {
+  FrameStatistics statistics;
+  statistics.frame = vsync_to_submit_time_.statistics();
+  statistics.raster = frame_time_.statistics();
+  statistics.ui = engine_time_.statistics();
+  return statistics;
+}
+
 }  // namespace flow
@@ -8,8 +8,10 @@
 #include <memory>
 #include <string>
 
+#include "flutter/flow/damage_tracker.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/instrumentation.h"
+#include "flutter/flow/layers/layer_profile.h"
 #include "flutter/flow/raster_cache.h"
 #include "flutter/flow/texture.h"
 #include "flutter/fml/macros.h"
@@ -29,7 +31,8 @@ class CompositorContext {
                 SkCanvas* canvas,
                 ExternalViewEmbedder* view_embedder,
                 const SkMatrix& root_surface_transformation,
-                bool instrumentation_enabled);
+                bool instrumentation_enabled,
+                bool sweep_raster_cache);
 
     virtual ~ScopedFrame();
 
@@ -45,7 +48,20 @@ class CompositorContext {
 
     GrContext* gr_context() const { return gr_context_; }
 
-    virtual bool Raster(LayerTree& layer_tree, bool ignore_raster_cache);
+    // Null unless layer profiling is enabled and this is an instrumented
+    // frame.
+    LayerProfile* layer_profile() { return layer_profile_.get(); }
+
+    std::unique_ptr<LayerProfile> TakeLayerProfile() {
+      return std::move(layer_profile_);
+    }
+
+    // If |frame_damage| is specified, only the parts of the canvas that
+    // changed since the frame it was last presented with are repainted.
+    // Everything else is expected to still hold the contents of that frame.
+    virtual bool Raster(LayerTree& layer_tree,
+                        bool ignore_raster_cache,
+                        FrameDamage* frame_damage = nullptr);
 
    private:
     CompositorContext& context_;
@@ -54,6 +70,8 @@ class CompositorContext {
     ExternalViewEmbedder* view_embedder_;
     const SkMatrix& root_surface_transformation_;
     const bool instrumentation_enabled_;
+    const bool sweep_raster_cache_;
+    std::unique_ptr<LayerProfile> layer_profile_;
 
     FML_DISALLOW_COPY_AND_ASSIGN(ScopedFrame);
   };
@@ -62,12 +80,16 @@ class CompositorContext {
 
   virtual ~CompositorContext();
 
+  // Frames that are not presented, like screenshots and slow frame captures,
+  // should not |sweep_raster_cache|. They rasterize without the cache, so a
+  // sweep would evict the entries the presented frames still use.
   virtual std::unique_ptr<ScopedFrame> AcquireFrame(
       GrContext* gr_context,
       SkCanvas* canvas,
       ExternalViewEmbedder* view_embedder,
       const SkMatrix& root_surface_transformation,
-      bool instrumentation_enabled);
+      bool instrumentation_enabled,
+      bool sweep_raster_cache = true);
 
   void OnGrContextCreated();
 
@@ -83,16 +105,36 @@ class CompositorContext {
 
   Stopwatch& engine_time() { return engine_time_; }
 
+  // The time from the vsync a frame was built for till it was submitted.
+  Stopwatch& vsync_to_submit_time() { return vsync_to_submit_time_; }
+
+  // Makes instrumented frames measure the time each layer takes to preroll
+  // and paint. Costs a couple of clock reads per layer. See
+  // |ScopedFrame::layer_profile|.
+  void set_layer_profiling_enabled(bool enabled) {
+    layer_profiling_enabled_ = enabled;
+  }
+
+  bool layer_profiling_enabled() const { return layer_profiling_enabled_; }
+
+  // The statistics of every frame so far. Those of the frames within a
+  // window are the ones at its end minus the ones at its start.
+  FrameStatistics GetFrameStatistics() const;
+
  private:
   RasterCache raster_cache_;
   TextureRegistry texture_registry_;
   Counter frame_count_;
   Stopwatch frame_time_;
   Stopwatch engine_time_;
+  Stopwatch vsync_to_submit_time_;
+  bool layer_profiling_enabled_ = false;
 
   void BeginFrame(ScopedFrame& frame, bool enable_instrumentation);
 
-  void EndFrame(ScopedFrame& frame, bool enable_instrumentation);
+  void EndFrame(ScopedFrame& frame,
+                bool enable_instrumentation,
+                bool sweep_raster_cache);
 
   FML_DISALLOW_COPY_AND_ASSIGN(CompositorContext);
 };
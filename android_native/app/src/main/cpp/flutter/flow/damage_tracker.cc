@@ -0,0 +1,242 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/damage_tracker.h"
+
+#include <string.h>
+
+#include <unordered_map>
+
+#include "flutter/fml/logging.h"
+
+namespace flow {
+
+static uint64_t ScalarBits(SkScalar value) {
+  uint32_t bits;
+  static_assert(sizeof(bits) == sizeof(value), "");
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+DamageContext::DamageContext(const SkIRect& frame_rect) {
+  states_.push_back({frame_rect, 0});
+}
+
+DamageContext::~DamageContext() = default;
+
+uint64_t DamageContext::Mix(uint64_t seed, uint64_t value) {
+  return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+
+void DamageContext::Save() {
+  states_.push_back(states_.back());
+}
+
+void DamageContext::Restore() {
+  FML_DCHECK(states_.size() > 1);
+  states_.pop_back();
+}
+
+void DamageContext::MixState(uint64_t value) {
+  states_.back().fingerprint = Mix(states_.back().fingerprint, value);
+}
+
+void DamageContext::MixScalarState(SkScalar value) {
+  MixState(ScalarBits(value));
+}
+
+void DamageContext::MixState(const SkRect& rect) {
+  MixScalarState(rect.left());
+  MixScalarState(rect.top());
+  MixScalarState(rect.right());
+  MixScalarState(rect.bottom());
+}
+
+void DamageContext::MixState(const SkRRect& rrect) {
+  MixState(rrect.rect());
+  for (int corner = 0; corner < 4; corner++) {
+    const SkVector radii = rrect.radii(static_cast<SkRRect::Corner>(corner));
+    MixScalarState(radii.x());
+    MixScalarState(radii.y());
+  }
+}
+
+void DamageContext::MixState(const SkPath& path) {
+  // The generation ID is not stable across paths with the same contents and
+  // paths are usually recreated on every frame. So use the contents instead.
+  MixState(static_cast<uint64_t>(path.getFillType()));
+  const int point_count = path.countPoints();
+  for (int i = 0; i < point_count; i++) {
+    const SkPoint point = path.getPoint(i);
+    MixScalarState(point.x());
+    MixScalarState(point.y());
+  }
+  const int verb_count = path.countVerbs();
+  std::vector<uint8_t> verbs(verb_count);
+  path.getVerbs(verbs.data(), verb_count);
+  for (uint8_t verb : verbs) {
+    MixState(verb);
+  }
+}
+
+void DamageContext::ClipRect(const SkRect& rect, const SkMatrix& matrix) {
+  SkIRect device_clip = matrix.mapRect(rect).roundOut();
+  if (!states_.back().clip.intersect(device_clip)) {
+    states_.back().clip.setEmpty();
+  }
+}
+
+bool DamageContext::DeviceBounds(const SkRect& bounds,
+                                 const SkMatrix& matrix,
+                                 SkIRect* device_bounds) const {
+  if (bounds.isEmpty()) {
+    return false;
+  }
+  *device_bounds = matrix.mapRect(bounds).roundOut();
+  // Account for anti-aliasing bleeding into the neighboring pixels.
+  device_bounds->outset(1, 1);
+  return device_bounds->intersect(states_.back().clip);
+}
+
+void DamageContext::AddPaintRegion(const SkRect& bounds,
+                                   const SkMatrix& matrix,
+                                   uint64_t content_id) {
+  SkIRect device_bounds;
+  if (!DeviceBounds(bounds, matrix, &device_bounds)) {
+    return;
+  }
+  uint64_t fingerprint = Mix(states_.back().fingerprint, content_id);
+  for (int i = 0; i < 9; i++) {
+    fingerprint = Mix(fingerprint, ScalarBits(matrix[i]));
+  }
+  regions_.push_back({device_bounds, fingerprint, false});
+}
+
+void DamageContext::AddVolatileRegion(const SkRect& bounds,
+                                      const SkMatrix& matrix) {
+  SkIRect device_bounds;
+  if (!DeviceBounds(bounds, matrix, &device_bounds)) {
+    return;
+  }
+  regions_.push_back({device_bounds, 0, true});
+}
+
+void DamageContext::AddVolatileClipRegion() {
+  if (states_.back().clip.isEmpty()) {
+    return;
+  }
+  regions_.push_back({states_.back().clip, 0, true});
+}
+
+std::vector<PaintRegion> DamageContext::TakeRegions() {
+  return std::move(regions_);
+}
+
+DamageTracker::DamageTracker()
+    : frame_size_(SkISize::MakeEmpty()),
+      has_previous_frame_(false),
+      last_frame_damage_(SkIRect::MakeEmpty()) {}
+
+DamageTracker::~DamageTracker() = default;
+
+void DamageTracker::Reset() {
+  has_previous_frame_ = false;
+  previous_regions_.clear();
+  damage_history_.clear();
+}
+
+SkIRect DamageTracker::DiffRegions(const std::vector<PaintRegion>& previous,
+                                   const std::vector<PaintRegion>& current) {
+  SkIRect damage = SkIRect::MakeEmpty();
+
+  // Regions of the previous frame by fingerprint in paint order.
+  std::unordered_map<uint64_t, std::vector<size_t>> previous_by_fingerprint;
+  for (size_t i = 0; i < previous.size(); i++) {
+    if (!previous[i].is_volatile) {
+      previous_by_fingerprint[previous[i].fingerprint].push_back(i);
+    }
+  }
+
+  std::vector<bool> matched(previous.size(), false);
+  // The paint order of matched regions must be preserved. Otherwise, regions
+  // that overlap could end up painted in the wrong order. So regions that
+  // match a previous region painted before the last match are damaged too.
+  size_t next_in_order = 0;
+
+  for (const auto& region : current) {
+    if (region.is_volatile) {
+      damage.join(region.bounds);
+      continue;
+    }
+
+    auto found = previous_by_fingerprint.find(region.fingerprint);
+    bool did_match = false;
+    if (found != previous_by_fingerprint.end()) {
+      for (size_t index : found->second) {
+        if (!matched[index] && previous[index].bounds == region.bounds) {
+          matched[index] = true;
+          did_match = index >= next_in_order;
+          if (did_match) {
+            next_in_order = index + 1;
+          }
+          break;
+        }
+      }
+    }
+
+    if (!did_match) {
+      damage.join(region.bounds);
+    }
+  }
+
+  // Whatever is left of the previous frame has to be erased.
+  for (size_t i = 0; i < previous.size(); i++) {
+    if (!matched[i]) {
+      damage.join(previous[i].bounds);
+    }
+  }
+
+  return damage;
+}
+
+SkIRect DamageTracker::ComputeDamage(std::vector<PaintRegion> regions,
+                                     const SkISize& frame_size,
+                                     int buffer_age) {
+  const SkIRect frame_rect = SkIRect::MakeSize(frame_size);
+
+  SkIRect damage;
+  if (!has_previous_frame_ || frame_size != frame_size_) {
+    damage = frame_rect;
+    damage_history_.clear();
+  } else {
+    damage = DiffRegions(previous_regions_, regions);
+    if (!damage.intersect(frame_rect)) {
+      damage.setEmpty();
+    }
+  }
+
+  previous_regions_ = std::move(regions);
+  frame_size_ = frame_size;
+  has_previous_frame_ = true;
+  last_frame_damage_ = damage;
+
+  damage_history_.push_front(damage);
+  if (damage_history_.size() > static_cast<size_t>(kMaxBufferAge)) {
+    damage_history_.pop_back();
+  }
+
+  if (buffer_age <= 0 ||
+      static_cast<size_t>(buffer_age) > damage_history_.size()) {
+    return frame_rect;
+  }
+
+  // The buffer is missing the changes of all frames presented after it.
+  SkIRect buffer_damage = SkIRect::MakeEmpty();
+  for (int i = 0; i < buffer_age; i++) {
+    buffer_damage.join(damage_history_[i]);
+  }
+  return buffer_damage;
+}
+
+}  // namespace flow
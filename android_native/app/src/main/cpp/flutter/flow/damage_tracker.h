@@ -0,0 +1,152 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_DAMAGE_TRACKER_H_
+#define FLUTTER_FLOW_DAMAGE_TRACKER_H_
+
+#include <stdint.h>
+
+#include <deque>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkMatrix.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkRRect.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+namespace flow {
+
+// A device space rectangle touched by a layer during paint along with a
+// fingerprint of everything that affects the pixels painted there (the
+// content, the transform and the state of all ancestor layers). Regions with
+// equal bounds and fingerprints in successive frames paint the same pixels.
+struct PaintRegion {
+  SkIRect bounds;
+  uint64_t fingerprint;
+  // Volatile regions (textures, platform views, ...) may change without the
+  // layer tree changing and are damaged on every frame.
+  bool is_volatile;
+};
+
+// Collects the paint regions of a layer tree. See |Layer::CollectPaintRegions|.
+class DamageContext {
+ public:
+  explicit DamageContext(const SkIRect& frame_rect);
+
+  ~DamageContext();
+
+  // Saves the current clip and state fingerprint. Must be balanced by a call
+  // to |Restore|.
+  void Save();
+
+  void Restore();
+
+  // Mixes |value| into the fingerprint of all regions added till the matching
+  // |Restore|. Layers call this with the properties that affect how their
+  // children are painted (opacity, clips, filters, ...).
+  void MixState(uint64_t value);
+
+  void MixScalarState(SkScalar value);
+
+  void MixState(const SkRect& rect);
+
+  void MixState(const SkRRect& rrect);
+
+  void MixState(const SkPath& path);
+
+  // Intersects the current clip with the given local rect.
+  void ClipRect(const SkRect& rect, const SkMatrix& matrix);
+
+  // Adds a region whose pixels are fully determined by |content_id|, the
+  // transform and the current state.
+  void AddPaintRegion(const SkRect& bounds,
+                      const SkMatrix& matrix,
+                      uint64_t content_id);
+
+  // Adds a region that has to be repainted on every frame.
+  void AddVolatileRegion(const SkRect& bounds, const SkMatrix& matrix);
+
+  // Marks everything under the current clip as needing a repaint on every
+  // frame. Used by layers that read back what is painted below them.
+  void AddVolatileClipRegion();
+
+  std::vector<PaintRegion> TakeRegions();
+
+  static uint64_t Mix(uint64_t seed, uint64_t value);
+
+ private:
+  struct State {
+    SkIRect clip;
+    uint64_t fingerprint;
+  };
+
+  std::vector<State> states_;
+  std::vector<PaintRegion> regions_;
+
+  bool DeviceBounds(const SkRect& bounds,
+                    const SkMatrix& matrix,
+                    SkIRect* device_bounds) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DamageContext);
+};
+
+// Tracks the paint regions of successive frames rendered to a surface to
+// determine which parts of each frame actually need to be repainted.
+class DamageTracker {
+ public:
+  // Damage is only tracked for buffers at most this many frames old. Older
+  // buffers are repainted fully.
+  static constexpr int kMaxBufferAge = 4;
+
+  DamageTracker();
+
+  ~DamageTracker();
+
+  // Records the paint regions of a new frame and returns the rect that has
+  // to be repainted in a buffer that holds the frame presented |buffer_age|
+  // frames ago. A buffer age of 0 means the buffer contents are undefined
+  // and the whole frame is returned.
+  SkIRect ComputeDamage(std::vector<PaintRegion> regions,
+                        const SkISize& frame_size,
+                        int buffer_age);
+
+  // The rect that changed between the last two frames given to
+  // |ComputeDamage|.
+  const SkIRect& last_frame_damage() const { return last_frame_damage_; }
+
+  // Forgets all previous frames. The next frame will be fully damaged.
+  void Reset();
+
+ private:
+  SkISize frame_size_;
+  bool has_previous_frame_;
+  std::vector<PaintRegion> previous_regions_;
+  // The damage of the most recent frames. Most recent first.
+  std::deque<SkIRect> damage_history_;
+  SkIRect last_frame_damage_;
+
+  static SkIRect DiffRegions(const std::vector<PaintRegion>& previous,
+                             const std::vector<PaintRegion>& current);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DamageTracker);
+};
+
+// The damage tracking parameters and results of a single frame. See
+// |CompositorContext::ScopedFrame::Raster|.
+struct FrameDamage {
+  // Tracks the frames previously rendered to the target surface.
+  DamageTracker* tracker = nullptr;
+
+  // The number of frames since the target buffer was last presented. See
+  // |DamageTracker::ComputeDamage|.
+  int buffer_age = 0;
+
+  // The rect of the buffer that was repainted.
+  SkIRect buffer_damage = SkIRect::MakeEmpty();
+};
+
+}  // namespace flow
+
+#endif  // FLUTTER_FLOW_DAMAGE_TRACKER_H_
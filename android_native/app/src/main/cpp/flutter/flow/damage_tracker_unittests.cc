@@ -0,0 +1,120 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/damage_tracker.h"
+#include "gtest/gtest.h"
+
+static std::vector<flow::PaintRegion> CollectRegions(
+    const std::vector<std::pair<SkRect, uint64_t>>& contents) {
+  flow::DamageContext context(SkIRect::MakeWH(1000, 1000));
+  for (const auto& content : contents) {
+    context.AddPaintRegion(content.first, SkMatrix::I(), content.second);
+  }
+  return context.TakeRegions();
+}
+
+static const SkISize kFrameSize = SkISize::Make(1000, 1000);
+
+TEST(DamageTracker, FirstFrameIsFullyDamaged) {
+  flow::DamageTracker tracker;
+  auto damage = tracker.ComputeDamage(
+      CollectRegions({{SkRect::MakeWH(10, 10), 1}}), kFrameSize, 1);
+  ASSERT_EQ(damage, SkIRect::MakeSize(kFrameSize));
+}
+
+TEST(DamageTracker, UnchangedFrameHasNoDamage) {
+  flow::DamageTracker tracker;
+  tracker.ComputeDamage(CollectRegions({{SkRect::MakeWH(10, 10), 1}}),
+                        kFrameSize, 1);
+  auto damage = tracker.ComputeDamage(
+      CollectRegions({{SkRect::MakeWH(10, 10), 1}}), kFrameSize, 1);
+  ASSERT_TRUE(damage.isEmpty());
+}
+
+TEST(DamageTracker, ChangedContentIsDamaged) {
+  flow::DamageTracker tracker;
+  tracker.ComputeDamage(
+      CollectRegions({{SkRect::MakeWH(10, 10), 1},
+                      {SkRect::MakeXYWH(100, 100, 10, 10), 2}}),
+      kFrameSize, 1);
+  auto damage = tracker.ComputeDamage(
+      CollectRegions({{SkRect::MakeWH(10, 10), 1},
+                      {SkRect::MakeXYWH(100, 100, 10, 10), 3}}),
+      kFrameSize, 1);
+  // Outset by a pixel for anti-aliasing.
+  ASSERT_EQ(damage, SkIRect::MakeXYWH(99, 99, 12, 12));
+}
+
+TEST(DamageTracker, MovedContentDamagesOldAndNewBounds) {
+  flow::DamageTracker tracker;
+  tracker.ComputeDamage(CollectRegions({{SkRect::MakeXYWH(10, 10, 10, 10), 1}}),
+                        kFrameSize, 1);
+  auto damage = tracker.ComputeDamage(
+      CollectRegions({{SkRect::MakeXYWH(30, 10, 10, 10), 1}}), kFrameSize, 1);
+  ASSERT_EQ(damage, SkIRect::MakeLTRB(9, 9, 41, 21));
+}
+
+TEST(DamageTracker, ReorderedContentIsDamaged) {
+  flow::DamageTracker tracker;
+  tracker.ComputeDamage(CollectRegions({{SkRect::MakeXYWH(0, 0, 10, 10), 1},
+                                        {SkRect::MakeXYWH(5, 5, 10, 10), 2}}),
+                        kFrameSize, 1);
+  auto damage = tracker.ComputeDamage(
+      CollectRegions({{SkRect::MakeXYWH(5, 5, 10, 10), 2},
+                      {SkRect::MakeXYWH(0, 0, 10, 10), 1}}),
+      kFrameSize, 1);
+  ASSERT_FALSE(damage.isEmpty());
+}
+
+TEST(DamageTracker, VolatileRegionsAreAlwaysDamaged) {
+  flow::DamageTracker tracker;
+  auto collect = []() {
+    flow::DamageContext context(SkIRect::MakeWH(1000, 1000));
+    context.AddVolatileRegion(SkRect::MakeXYWH(10, 10, 10, 10), SkMatrix::I());
+    return context.TakeRegions();
+  };
+  tracker.ComputeDamage(collect(), kFrameSize, 1);
+  auto damage = tracker.ComputeDamage(collect(), kFrameSize, 1);
+  ASSERT_EQ(damage, SkIRect::MakeXYWH(9, 9, 12, 12));
+}
+
+TEST(DamageTracker, StateChangesDamageRegions) {
+  flow::DamageTracker tracker;
+  auto collect = [](uint64_t alpha) {
+    flow::DamageContext context(SkIRect::MakeWH(1000, 1000));
+    context.Save();
+    context.MixState(alpha);
+    context.AddPaintRegion(SkRect::MakeXYWH(10, 10, 10, 10), SkMatrix::I(), 1);
+    context.Restore();
+    return context.TakeRegions();
+  };
+  tracker.ComputeDamage(collect(255), kFrameSize, 1);
+  ASSERT_TRUE(tracker.ComputeDamage(collect(255), kFrameSize, 1).isEmpty());
+  ASSERT_FALSE(tracker.ComputeDamage(collect(128), kFrameSize, 1).isEmpty());
+}
+
+TEST(DamageTracker, OlderBuffersAccumulateDamage) {
+  flow::DamageTracker tracker;
+  tracker.ComputeDamage(CollectRegions({{SkRect::MakeXYWH(0, 0, 10, 10), 1},
+                                        {SkRect::MakeXYWH(50, 0, 10, 10), 2}}),
+                        kFrameSize, 0);
+  tracker.ComputeDamage(CollectRegions({{SkRect::MakeXYWH(0, 0, 10, 10), 3},
+                                        {SkRect::MakeXYWH(50, 0, 10, 10), 2}}),
+                        kFrameSize, 0);
+  auto damage = tracker.ComputeDamage(
+      CollectRegions({{SkRect::MakeXYWH(0, 0, 10, 10), 3},
+                      {SkRect::MakeXYWH(50, 0, 10, 10), 4}}),
+      kFrameSize, 2);
+  ASSERT_EQ(damage, SkIRect::MakeLTRB(0, 0, 61, 11));
+  ASSERT_EQ(tracker.last_frame_damage(), SkIRect::MakeLTRB(49, 0, 61, 11));
+}
+
+TEST(DamageTracker, UnknownBufferContentsAreFullyDamaged) {
+  flow::DamageTracker tracker;
+  tracker.ComputeDamage(CollectRegions({{SkRect::MakeWH(10, 10), 1}}),
+                        kFrameSize, 1);
+  auto damage = tracker.ComputeDamage(
+      CollectRegions({{SkRect::MakeWH(10, 10), 1}}), kFrameSize, 0);
+  ASSERT_EQ(damage, SkIRect::MakeSize(kFrameSize));
+}
@@ -0,0 +1,100 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "flutter/fml/logging.h"
+
+namespace flow {
+
+// Each power of two above |kExactMicroseconds| is split into this many
+// buckets.
+static constexpr int kSubBucketBits = 5;
+static constexpr int64_t kSubBuckets = int64_t{1} << kSubBucketBits;
+static_assert(kSubBuckets == DurationHistogram::kExactMicroseconds,
+              "The exact buckets are the first octave.");
+
+// Durations are counted up to 2^26us, which is about 67 seconds.
+static constexpr int kMaxBits = 26;
+static constexpr int64_t kMaxMicroseconds = (int64_t{1} << kMaxBits) - 1;
+static constexpr size_t kBucketCount =
+    kSubBuckets + (kMaxBits - kSubBucketBits) * kSubBuckets;
+
+DurationHistogram::DurationHistogram()
+    : buckets_(kBucketCount, 0), count_(0), max_(0) {}
+
+DurationHistogram::DurationHistogram(const DurationHistogram& other) = default;
+
+DurationHistogram& DurationHistogram::operator=(
+    const DurationHistogram& other) = default;
+
+DurationHistogram::~DurationHistogram() = default;
+
+size_t DurationHistogram::BucketIndex(int64_t microseconds) {
+  if (microseconds < kSubBuckets) {
+    return microseconds;
+  }
+  // The highest set bit picks the power of two and the bits below it pick the
+  // bucket within.
+  const int highest_bit = 63 - __builtin_clzll(microseconds);
+  const int shift = highest_bit - kSubBucketBits;
+  return kSubBuckets + shift * kSubBuckets +
+         ((microseconds >> shift) - kSubBuckets);
+}
+
+int64_t DurationHistogram::BucketUpperBound(size_t index) {
+  if (index < static_cast<size_t>(kSubBuckets)) {
+    return index;
+  }
+  const int shift = (index - kSubBuckets) / kSubBuckets;
+  const int64_t sub_bucket = (index - kSubBuckets) % kSubBuckets;
+  const int64_t lower_bound = (kSubBuckets + sub_bucket) << shift;
+  return lower_bound + (int64_t{1} << shift) - 1;
+}
+
+void DurationHistogram::Record(fml::TimeDelta duration) {
+  const int64_t microseconds =
+      std::min(std::max(duration.ToMicroseconds(), int64_t{0}),
+               kMaxMicroseconds);
+  buckets_[BucketIndex(microseconds)]++;
+  count_++;
+  max_ = std::max(max_, microseconds);
+}
+
+void DurationHistogram::Subtract(const DurationHistogram& earlier) {
+  FML_DCHECK(earlier.count_ <= count_);
+  size_t highest_bucket = 0;
+  for (size_t i = 0; i < kBucketCount; i++) {
+    FML_DCHECK(earlier.buckets_[i] <= buckets_[i]);
+    buckets_[i] -= earlier.buckets_[i];
+    if (buckets_[i] != 0) {
+      highest_bucket = i;
+    }
+  }
+  count_ -= earlier.count_;
+  max_ = count_ == 0 ? 0 : std::min(max_, BucketUpperBound(highest_bucket));
+}
+
+fml::TimeDelta DurationHistogram::Percentile(double percentile) const {
+  if (count_ == 0) {
+    return fml::TimeDelta::Zero();
+  }
+  const double clamped = std::min(std::max(percentile, 0.0), 100.0);
+  const uint64_t rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(clamped * count_ / 100.0)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount; i++) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      return fml::TimeDelta::FromMicroseconds(
+          std::min(BucketUpperBound(i), max_));
+    }
+  }
+  return max();
+}
+
+}  // namespace flow
@@ -0,0 +1,66 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_HISTOGRAM_H_
+#define FLUTTER_FLOW_HISTOGRAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "flutter/fml/time/time_delta.h"
+
+namespace flow {
+
+// A histogram of durations that takes constant memory however many durations
+// are recorded. Like an HDR histogram, the width of its buckets grows with the
+// durations they hold. Durations below |kExactMicroseconds| are kept exactly
+// and longer ones to within about 3%. Durations are counted in whole
+// microseconds up to about a minute. Longer ones are counted as a minute.
+//
+// Histograms are cheap to copy. The histogram of the durations recorded within
+// a window is the one at its end minus a copy taken at its start.
+class DurationHistogram {
+ public:
+  static constexpr int64_t kExactMicroseconds = 32;
+
+  DurationHistogram();
+
+  DurationHistogram(const DurationHistogram& other);
+
+  DurationHistogram& operator=(const DurationHistogram& other);
+
+  ~DurationHistogram();
+
+  void Record(fml::TimeDelta duration);
+
+  // Removes the durations of |earlier|, a copy of this histogram taken
+  // before. Leaves the durations recorded since.
+  void Subtract(const DurationHistogram& earlier);
+
+  uint64_t count() const { return count_; }
+
+  // The longest duration recorded. Only known to within the precision of the
+  // buckets after |Subtract|.
+  fml::TimeDelta max() const { return fml::TimeDelta::FromMicroseconds(max_); }
+
+  // The shortest duration that |percentile| percent of the recorded durations
+  // do not exceed, to within the precision of the buckets. |percentile| is in
+  // the range [0, 100]. Zero if nothing was recorded.
+  fml::TimeDelta Percentile(double percentile) const;
+
+ private:
+  std::vector<uint64_t> buckets_;
+  uint64_t count_;
+  int64_t max_;  // Microseconds.
+
+  static size_t BucketIndex(int64_t microseconds);
+
+  static int64_t BucketUpperBound(size_t index);
+};
+
+}  // namespace flow
+
+#endif  // FLUTTER_FLOW_HISTOGRAM_H_
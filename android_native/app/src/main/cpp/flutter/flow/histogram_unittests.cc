@@ -0,0 +1,82 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/histogram.h"
+#include "gtest/gtest.h"
+
+using fml::TimeDelta;
+
+TEST(DurationHistogram, EmptyHistogramReportsZero) {
+  flow::DurationHistogram histogram;
+  ASSERT_EQ(histogram.count(), 0u);
+  ASSERT_EQ(histogram.max(), TimeDelta::Zero());
+  ASSERT_EQ(histogram.Percentile(50), TimeDelta::Zero());
+}
+
+TEST(DurationHistogram, ShortDurationsAreExact) {
+  flow::DurationHistogram histogram;
+  for (int64_t i = 1; i <= 10; i++) {
+    histogram.Record(TimeDelta::FromMicroseconds(i));
+  }
+  ASSERT_EQ(histogram.count(), 10u);
+  ASSERT_EQ(histogram.Percentile(0), TimeDelta::FromMicroseconds(1));
+  ASSERT_EQ(histogram.Percentile(50), TimeDelta::FromMicroseconds(5));
+  ASSERT_EQ(histogram.Percentile(90), TimeDelta::FromMicroseconds(9));
+  ASSERT_EQ(histogram.Percentile(100), TimeDelta::FromMicroseconds(10));
+  ASSERT_EQ(histogram.max(), TimeDelta::FromMicroseconds(10));
+}
+
+TEST(DurationHistogram, PercentilesAreWithinTheBucketPrecision) {
+  flow::DurationHistogram histogram;
+  // 1ms to 100ms in steps of 1ms.
+  for (int64_t i = 1; i <= 100; i++) {
+    histogram.Record(TimeDelta::FromMilliseconds(i));
+  }
+  const struct {
+    double percentile;
+    int64_t expected_ms;
+  } cases[] = {{50, 50}, {90, 90}, {99, 99}, {100, 100}};
+  for (const auto& test : cases) {
+    const double actual =
+        histogram.Percentile(test.percentile).ToMillisecondsF();
+    EXPECT_GE(actual, test.expected_ms) << test.percentile;
+    EXPECT_LE(actual, test.expected_ms * 1.032) << test.percentile;
+  }
+  // The maximum is exact.
+  ASSERT_EQ(histogram.max(), TimeDelta::FromMilliseconds(100));
+}
+
+TEST(DurationHistogram, LongDurationsAreClamped) {
+  flow::DurationHistogram histogram;
+  histogram.Record(TimeDelta::FromSeconds(3600));
+  histogram.Record(TimeDelta::FromMicroseconds(-5));
+  ASSERT_EQ(histogram.count(), 2u);
+  ASSERT_EQ(histogram.Percentile(0), TimeDelta::Zero());
+  ASSERT_LT(histogram.max(), TimeDelta::FromSeconds(68));
+  ASSERT_GT(histogram.max(), TimeDelta::FromSeconds(60));
+}
+
+TEST(DurationHistogram, SubtractingAnEarlierCopyLeavesTheWindow) {
+  flow::DurationHistogram histogram;
+  for (int i = 0; i < 100; i++) {
+    histogram.Record(TimeDelta::FromMilliseconds(40));
+  }
+  const flow::DurationHistogram window_start = histogram;
+  for (int i = 0; i < 10; i++) {
+    histogram.Record(TimeDelta::FromMilliseconds(2));
+  }
+
+  flow::DurationHistogram window = histogram;
+  window.Subtract(window_start);
+  ASSERT_EQ(window.count(), 10u);
+  ASSERT_GE(window.max(), TimeDelta::FromMilliseconds(2));
+  ASSERT_LT(window.max(), TimeDelta::FromMicroseconds(2100));
+  ASSERT_GE(window.Percentile(99), TimeDelta::FromMilliseconds(2));
+  ASSERT_LT(window.Percentile(99), TimeDelta::FromMicroseconds(2100));
+
+  const flow::DurationHistogram window_end = window;
+  window.Subtract(window_end);
+  ASSERT_EQ(window.count(), 0u);
+  ASSERT_EQ(window.max(), TimeDelta::Zero());
+}
@@ -24,6 +24,24 @@ Stopwatch::Stopwatch() : start_(fml::TimePoint::Now()), current_sample_(0) {
 
 Stopwatch::~Stopwatch() = default;
 
+void LapStatistics::Subtract(const LapStatistics& earlier) {
+  laps.Subtract(earlier.laps);
+  missed_frames -= earlier.missed_frames;
+}
+
+void FrameStatistics::Subtract(const FrameStatistics& earlier) {
+  frame.Subtract(earlier.frame);
+  raster.Subtract(earlier.raster);
+  ui.Subtract(earlier.ui);
+}
+
+void Stopwatch::RecordLap(const fml::TimeDelta& delta) {
+  statistics_.laps.Record(delta);
+  if (delta.ToMillisecondsF() > kOneFrameMS) {
+    statistics_.missed_frames++;
+  }
+}
+
 void Stopwatch::Start() {
   start_ = fml::TimePoint::Now();
   current_sample_ = (current_sample_ + 1) % kMaxSamples;
@@ -31,11 +49,13 @@ void Stopwatch::Start() {
 
 void Stopwatch::Stop() {
   laps_[current_sample_] = fml::TimePoint::Now() - start_;
+  RecordLap(laps_[current_sample_]);
 }
 
 void Stopwatch::SetLapTime(const fml::TimeDelta& delta) {
   current_sample_ = (current_sample_ + 1) % kMaxSamples;
   laps_[current_sample_] = delta;
+  RecordLap(delta);
 }
 
 const fml::TimeDelta& Stopwatch::LastLap() const {
@@ -5,8 +5,11 @@
 #ifndef FLUTTER_FLOW_INSTRUMENTATION_H_
 #define FLUTTER_FLOW_INSTRUMENTATION_H_
 
+#include <stdint.h>
+
 #include <vector>
 
+#include "flutter/flow/histogram.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/time/time_point.h"
@@ -16,6 +19,17 @@ namespace flow {
 
 static const double kOneFrameMS = 1e3 / 60.0;
 
+// The laps of a stopwatch within some window.
+struct LapStatistics {
+  DurationHistogram laps;
+  // The laps that took longer than a frame.
+  uint64_t missed_frames = 0;
+
+  // Leaves the laps recorded after |earlier|, a copy of these statistics
+  // taken before.
+  void Subtract(const LapStatistics& earlier);
+};
+
 class Stopwatch {
  public:
   Stopwatch();
@@ -38,19 +52,38 @@ class Stopwatch {
 
   void SetLapTime(const fml::TimeDelta& delta);
 
+  // Unlike the laps that are visualized, these cover every lap since the
+  // stopwatch was created.
+  const LapStatistics& statistics() const { return statistics_; }
+
  private:
   fml::TimePoint start_;
   std::vector<fml::TimeDelta> laps_;
   size_t current_sample_;
+  LapStatistics statistics_;
   // Mutable data cache for performance optimization of the graphs. Prevents
   // expensive redrawing of old data.
   mutable bool cache_dirty_;
   mutable sk_sp<SkSurface> visualize_cache_surface_;
   mutable size_t prev_drawn_sample_index_;
 
+  void RecordLap(const fml::TimeDelta& delta);
+
   FML_DISALLOW_COPY_AND_ASSIGN(Stopwatch);
 };
 
+// What a compositor measured about the frames it rasterized. See
+// |CompositorContext::GetFrameStatistics|.
+struct FrameStatistics {
+  // From the vsync a frame was built for till it was submitted.
+  LapStatistics frame;
+  LapStatistics raster;
+  // From the vsync a frame was built for till its layer tree was built.
+  LapStatistics ui;
+
+  void Subtract(const FrameStatistics& earlier);
+};
+
 class Counter {
  public:
   Counter() : count_(0) {}
@@ -10,6 +10,16 @@ BackdropFilterLayer::BackdropFilterLayer() = default;
 
 BackdropFilterLayer::~BackdropFilterLayer() = default;
 
+void BackdropFilterLayer::Optimize(OptimizeContext* context,
+                                   const SkMatrix& matrix) {
+  // The filter reads the destination, which differs inside the save layer of
+  // an ancestor.
+  if (context->check_blend_modes) {
+    context->non_src_over_blends = true;
+  }
+  ContainerLayer::Optimize(context, matrix);
+}
+
 void BackdropFilterLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "BackdropFilterLayer::Paint");
   FML_DCHECK(needs_painting());
@@ -20,4 +30,13 @@ void BackdropFilterLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+void BackdropFilterLayer::CollectPaintRegions(DamageContext* context,
+                                              const SkMatrix& matrix) const {
+  // The filter samples whatever has been painted below it. Repainting just a
+  // part of that would feed the filter a mix of old and new pixels. So always
+  // repaint everything the filter may read.
+  context->AddVolatileClipRegion();
+  CollectChildrenPaintRegions(context, matrix);
+}
+
 }  // namespace flow
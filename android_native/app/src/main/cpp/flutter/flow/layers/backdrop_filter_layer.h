@@ -18,8 +18,15 @@ class BackdropFilterLayer : public ContainerLayer {
 
   void set_filter(sk_sp<SkImageFilter> filter) { filter_ = std::move(filter); }
 
+  void Optimize(OptimizeContext* context, const SkMatrix& matrix) override;
+
   void Paint(PaintContext& context) const override;
 
+  const char* type_name() const override { return "BackdropFilterLayer"; }
+
+  void CollectPaintRegions(DamageContext* context,
+                           const SkMatrix& matrix) const override;
+
  private:
   sk_sp<SkImageFilter> filter_;
 
@@ -26,6 +26,19 @@ void ClipPathLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   }
 }
 
+void ClipPathLayer::Optimize(OptimizeContext* context,
+                             const SkMatrix& matrix) {
+  clip_is_redundant_ =
+      clip_path_.conservativelyContainsRect(ChildrenPaintBounds());
+  if (clip_is_redundant_) {
+    context->stats.elided_clips++;
+    if (clip_behavior_ == Clip::antiAliasWithSaveLayer) {
+      context->stats.elided_save_layers++;
+    }
+  }
+  OptimizeChildren(context, matrix);
+}
+
 #if defined(OS_FUCHSIA)
 
 void ClipPathLayer::UpdateScene(SceneUpdateContext& context) {
@@ -50,11 +63,19 @@ void ClipPathLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "ClipPathLayer::Paint");
   FML_DCHECK(needs_painting());
 
+  if (clip_is_redundant_) {
+    PaintChildren(context);
+    return;
+  }
+
   SkAutoCanvasRestore save(context.internal_nodes_canvas, true);
   context.internal_nodes_canvas->clipPath(clip_path_,
                                           clip_behavior_ != Clip::hardEdge);
   if (clip_behavior_ == Clip::antiAliasWithSaveLayer) {
     context.internal_nodes_canvas->saveLayer(paint_bounds(), nullptr);
+    if (context.layer_profile) {
+      context.layer_profile->CountSaveLayer();
+    }
   }
   PaintChildren(context);
   if (clip_behavior_ == Clip::antiAliasWithSaveLayer) {
@@ -62,4 +83,14 @@ void ClipPathLayer::Paint(PaintContext& context) const {
   }
 }
 
+void ClipPathLayer::CollectPaintRegions(DamageContext* context,
+                                        const SkMatrix& matrix) const {
+  context->Save();
+  context->ClipRect(clip_path_.getBounds(), matrix);
+  context->MixState(clip_path_);
+  context->MixState(clip_behavior_);
+  CollectChildrenPaintRegions(context, matrix);
+  context->Restore();
+}
+
 }  // namespace flow
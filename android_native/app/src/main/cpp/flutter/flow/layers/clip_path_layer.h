@@ -18,8 +18,15 @@ class ClipPathLayer : public ContainerLayer {
 
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
 
+  void Optimize(OptimizeContext* context, const SkMatrix& matrix) override;
+
   void Paint(PaintContext& context) const override;
 
+  const char* type_name() const override { return "ClipPathLayer"; }
+
+  void CollectPaintRegions(DamageContext* context,
+                           const SkMatrix& matrix) const override;
+
 #if defined(OS_FUCHSIA)
   void UpdateScene(SceneUpdateContext& context) override;
 #endif  // defined(OS_FUCHSIA)
@@ -27,6 +34,8 @@ class ClipPathLayer : public ContainerLayer {
  private:
   SkPath clip_path_;
   Clip clip_behavior_;
+  // Set when the children are painted inside of the clip anyway.
+  bool clip_is_redundant_ = false;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ClipPathLayer);
 };
@@ -20,6 +20,18 @@ void ClipRectLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   }
 }
 
+void ClipRectLayer::Optimize(OptimizeContext* context,
+                             const SkMatrix& matrix) {
+  clip_is_redundant_ = clip_rect_.contains(ChildrenPaintBounds());
+  if (clip_is_redundant_) {
+    context->stats.elided_clips++;
+    if (clip_behavior_ == Clip::antiAliasWithSaveLayer) {
+      context->stats.elided_save_layers++;
+    }
+  }
+  OptimizeChildren(context, matrix);
+}
+
 #if defined(OS_FUCHSIA)
 
 void ClipRectLayer::UpdateScene(SceneUpdateContext& context) {
@@ -41,11 +53,19 @@ void ClipRectLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "ClipRectLayer::Paint");
   FML_DCHECK(needs_painting());
 
+  if (clip_is_redundant_) {
+    PaintChildren(context);
+    return;
+  }
+
   SkAutoCanvasRestore save(context.internal_nodes_canvas, true);
   context.internal_nodes_canvas->clipRect(paint_bounds(),
                                           clip_behavior_ != Clip::hardEdge);
   if (clip_behavior_ == Clip::antiAliasWithSaveLayer) {
     context.internal_nodes_canvas->saveLayer(paint_bounds(), nullptr);
+    if (context.layer_profile) {
+      context.layer_profile->CountSaveLayer();
+    }
   }
   PaintChildren(context);
   if (clip_behavior_ == Clip::antiAliasWithSaveLayer) {
@@ -53,4 +73,14 @@ void ClipRectLayer::Paint(PaintContext& context) const {
   }
 }
 
+void ClipRectLayer::CollectPaintRegions(DamageContext* context,
+                                        const SkMatrix& matrix) const {
+  context->Save();
+  context->ClipRect(clip_rect_, matrix);
+  context->MixState(clip_rect_);
+  context->MixState(clip_behavior_);
+  CollectChildrenPaintRegions(context, matrix);
+  context->Restore();
+}
+
 }  // namespace flow
@@ -17,8 +17,15 @@ class ClipRectLayer : public ContainerLayer {
   void set_clip_rect(const SkRect& clip_rect) { clip_rect_ = clip_rect; }
 
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
+
+  void Optimize(OptimizeContext* context, const SkMatrix& matrix) override;
   void Paint(PaintContext& context) const override;
 
+  const char* type_name() const override { return "ClipRectLayer"; }
+
+  void CollectPaintRegions(DamageContext* context,
+                           const SkMatrix& matrix) const override;
+
 #if defined(OS_FUCHSIA)
   void UpdateScene(SceneUpdateContext& context) override;
 #endif  // defined(OS_FUCHSIA)
@@ -26,6 +33,8 @@ class ClipRectLayer : public ContainerLayer {
  private:
   SkRect clip_rect_;
   Clip clip_behavior_;
+  // Set when the children are painted inside of the clip anyway.
+  bool clip_is_redundant_ = false;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ClipRectLayer);
 };
@@ -20,6 +20,18 @@ void ClipRRectLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   }
 }
 
+void ClipRRectLayer::Optimize(OptimizeContext* context,
+                              const SkMatrix& matrix) {
+  clip_is_redundant_ = clip_rrect_.contains(ChildrenPaintBounds());
+  if (clip_is_redundant_) {
+    context->stats.elided_clips++;
+    if (clip_behavior_ == Clip::antiAliasWithSaveLayer) {
+      context->stats.elided_save_layers++;
+    }
+  }
+  OptimizeChildren(context, matrix);
+}
+
 #if defined(OS_FUCHSIA)
 
 void ClipRRectLayer::UpdateScene(SceneUpdateContext& context) {
@@ -48,11 +60,19 @@ void ClipRRectLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "ClipRRectLayer::Paint");
   FML_DCHECK(needs_painting());
 
+  if (clip_is_redundant_) {
+    PaintChildren(context);
+    return;
+  }
+
   SkAutoCanvasRestore save(context.internal_nodes_canvas, true);
   context.internal_nodes_canvas->clipRRect(clip_rrect_,
                                            clip_behavior_ != Clip::hardEdge);
   if (clip_behavior_ == Clip::antiAliasWithSaveLayer) {
     context.internal_nodes_canvas->saveLayer(paint_bounds(), nullptr);
+    if (context.layer_profile) {
+      context.layer_profile->CountSaveLayer();
+    }
   }
   PaintChildren(context);
   if (clip_behavior_ == Clip::antiAliasWithSaveLayer) {
@@ -60,4 +80,14 @@ void ClipRRectLayer::Paint(PaintContext& context) const {
   }
 }
 
+void ClipRRectLayer::CollectPaintRegions(DamageContext* context,
+                                         const SkMatrix& matrix) const {
+  context->Save();
+  context->ClipRect(clip_rrect_.getBounds(), matrix);
+  context->MixState(clip_rrect_);
+  context->MixState(clip_behavior_);
+  CollectChildrenPaintRegions(context, matrix);
+  context->Restore();
+}
+
 }  // namespace flow
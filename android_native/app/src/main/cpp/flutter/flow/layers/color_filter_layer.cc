@@ -10,6 +10,36 @@ ColorFilterLayer::ColorFilterLayer() = default;
 
 ColorFilterLayer::~ColorFilterLayer() = default;
 
+static SkMatrix CacheMatrix(const SkMatrix& matrix) {
+#ifndef SUPPORT_FRACTIONAL_TRANSLATION
+  return RasterCache::GetIntegralTransCTM(matrix);
+#else
+  return matrix;
+#endif
+}
+
+void ColorFilterLayer::Preroll(PrerollContext* context,
+                               const SkMatrix& matrix) {
+  ContainerLayer::Preroll(context, matrix);
+  // Like with opacity layers, the child can be cached so that the filter is
+  // applied when drawing the cached image instead of in a save layer. The
+  // cache only rasterizes children that stay the same for a few frames.
+  if (context->raster_cache && layers().size() == 1) {
+    context->raster_cache->Prepare(context, layers()[0].get(),
+                                   CacheMatrix(matrix));
+  }
+}
+
+void ColorFilterLayer::Optimize(OptimizeContext* context,
+                                const SkMatrix& matrix) {
+  if (context->view_embedder == nullptr && layers().size() == 1 &&
+      context->raster_cache &&
+      context->raster_cache->HasImage(layers()[0].get(), CacheMatrix(matrix))) {
+    context->stats.elided_save_layers++;
+  }
+  OptimizeChildren(context, matrix);
+}
+
 void ColorFilterLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "ColorFilterLayer::Paint");
   FML_DCHECK(needs_painting());
@@ -19,9 +49,37 @@ void ColorFilterLayer::Paint(PaintContext& context) const {
   SkPaint paint;
   paint.setColorFilter(std::move(color_filter));
 
+  // See |OpacityLayer::Paint| for why the cache is not used with embedded
+  // platform views.
+  if (context.view_embedder == nullptr && layers().size() == 1 &&
+      context.raster_cache) {
+    const SkMatrix ctm =
+        CacheMatrix(context.leaf_nodes_canvas->getTotalMatrix());
+    RasterCacheResult child_cache =
+        context.raster_cache->Get(layers()[0].get(), ctm);
+    if (child_cache.is_valid()) {
+      if (context.layer_profile) {
+        context.layer_profile->CountRasterCacheHit();
+      }
+      SkAutoCanvasRestore save(context.internal_nodes_canvas, true);
+      context.internal_nodes_canvas->setMatrix(ctm);
+      child_cache.draw(*context.leaf_nodes_canvas, &paint);
+      return;
+    }
+  }
+
   Layer::AutoSaveLayer save =
       Layer::AutoSaveLayer::Create(context, paint_bounds(), &paint);
   PaintChildren(context);
 }
 
+void ColorFilterLayer::CollectPaintRegions(DamageContext* context,
+                                           const SkMatrix& matrix) const {
+  context->Save();
+  context->MixState(color_);
+  context->MixState(static_cast<uint64_t>(blend_mode_));
+  CollectChildrenPaintRegions(context, matrix);
+  context->Restore();
+}
+
 }  // namespace flow
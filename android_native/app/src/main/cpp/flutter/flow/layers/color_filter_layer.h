@@ -18,8 +18,17 @@ class ColorFilterLayer : public ContainerLayer {
 
   void set_blend_mode(SkBlendMode blend_mode) { blend_mode_ = blend_mode; }
 
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
+
+  void Optimize(OptimizeContext* context, const SkMatrix& matrix) override;
+
   void Paint(PaintContext& context) const override;
 
+  const char* type_name() const override { return "ColorFilterLayer"; }
+
+  void CollectPaintRegions(DamageContext* context,
+                           const SkMatrix& matrix) const override;
+
  private:
   SkColor color_;
   SkBlendMode blend_mode_;
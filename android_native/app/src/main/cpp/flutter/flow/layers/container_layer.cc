@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/container_layer.h"
 
+#include "flutter/flow/layers/layer_dumper.h"
+
 namespace flow {
 
 ContainerLayer::ContainerLayer() {}
@@ -28,6 +30,8 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
                                      SkRect* child_paint_bounds) {
   for (auto& layer : layers_) {
     PrerollContext child_context = *context;
+    LayerProfile::ScopedLayer profile(context->layer_profile,
+                                      LayerProfile::Phase::kPreroll, *layer);
     layer->Preroll(&child_context, child_matrix);
 
     if (layer->needs_system_composite()) {
@@ -37,6 +41,30 @@ void ContainerLayer::PrerollChildren(PrerollContext* context,
   }
 }
 
+void ContainerLayer::Optimize(OptimizeContext* context,
+                              const SkMatrix& matrix) {
+  OptimizeChildren(context, matrix);
+}
+
+void ContainerLayer::OptimizeChildren(OptimizeContext* context,
+                                      const SkMatrix& child_matrix,
+                                      TransformLayer* parent_transform) {
+  for (auto& layer : layers_) {
+    context->parent_transform =
+        layers_.size() == 1 ? parent_transform : nullptr;
+    layer->Optimize(context, child_matrix);
+  }
+  context->parent_transform = nullptr;
+}
+
+SkRect ContainerLayer::ChildrenPaintBounds() const {
+  SkRect bounds = SkRect::MakeEmpty();
+  for (auto& layer : layers_) {
+    bounds.join(layer->paint_bounds());
+  }
+  return bounds;
+}
+
 void ContainerLayer::PaintChildren(PaintContext& context) const {
   FML_DCHECK(needs_painting());
 
@@ -44,11 +72,36 @@ void ContainerLayer::PaintChildren(PaintContext& context) const {
   // and the trace event on this common function has a small overhead.
   for (auto& layer : layers_) {
     if (layer->needs_painting()) {
+      LayerProfile::ScopedLayer profile(context.layer_profile,
+                                        LayerProfile::Phase::kPaint, *layer);
       layer->Paint(context);
     }
   }
 }
 
+void ContainerLayer::CollectPaintRegions(DamageContext* context,
+                                         const SkMatrix& matrix) const {
+  CollectChildrenPaintRegions(context, matrix);
+}
+
+void ContainerLayer::CollectChildrenPaintRegions(
+    DamageContext* context,
+    const SkMatrix& child_matrix) const {
+  for (auto& layer : layers_) {
+    if (layer->needs_painting()) {
+      layer->CollectPaintRegions(context, child_matrix);
+    }
+  }
+}
+
+void ContainerLayer::Dump(LayerDumper* dumper) const {
+  dumper->BeginLayer(*this);
+  for (auto& layer : layers_) {
+    layer->Dump(dumper);
+  }
+  dumper->EndLayer();
+}
+
 #if defined(OS_FUCHSIA)
 
 void ContainerLayer::UpdateScene(SceneUpdateContext& context) {
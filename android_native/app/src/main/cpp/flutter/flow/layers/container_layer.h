@@ -19,6 +19,15 @@ class ContainerLayer : public Layer {
 
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
 
+  void Optimize(OptimizeContext* context, const SkMatrix& matrix) override;
+
+  void CollectPaintRegions(DamageContext* context,
+                           const SkMatrix& matrix) const override;
+
+  const char* type_name() const override { return "ContainerLayer"; }
+
+  void Dump(LayerDumper* dumper) const override;
+
 #if defined(OS_FUCHSIA)
   void UpdateScene(SceneUpdateContext& context) override;
 #endif  // defined(OS_FUCHSIA)
@@ -29,7 +38,17 @@ class ContainerLayer : public Layer {
   void PrerollChildren(PrerollContext* context,
                        const SkMatrix& child_matrix,
                        SkRect* child_paint_bounds);
+  // |parent_transform| is passed on to a single child. See
+  // |TransformLayer::Optimize|.
+  void OptimizeChildren(OptimizeContext* context,
+                        const SkMatrix& child_matrix,
+                        TransformLayer* parent_transform = nullptr);
+  // The union of the paint bounds of the children. Only valid after
+  // |Preroll|.
+  SkRect ChildrenPaintBounds() const;
   void PaintChildren(PaintContext& context) const;
+  void CollectChildrenPaintRegions(DamageContext* context,
+                                   const SkMatrix& child_matrix) const;
 
 #if defined(OS_FUCHSIA)
   void UpdateSceneChildren(SceneUpdateContext& context);
@@ -4,6 +4,7 @@
 
 #include "flutter/flow/layers/layer.h"
 
+#include "flutter/flow/layers/layer_dumper.h"
 #include "flutter/flow/paint_utils.h"
 #include "third_party/skia/include/core/SkColorFilter.h"
 
@@ -18,6 +19,18 @@ Layer::~Layer() = default;
 
 void Layer::Preroll(PrerollContext* context, const SkMatrix& matrix) {}
 
+void Layer::Optimize(OptimizeContext* context, const SkMatrix& matrix) {}
+
+void Layer::Dump(LayerDumper* dumper) const {
+  dumper->BeginLayer(*this);
+  dumper->EndLayer();
+}
+
+void Layer::CollectPaintRegions(DamageContext* context,
+                                const SkMatrix& matrix) const {
+  context->AddVolatileRegion(paint_bounds(), matrix);
+}
+
 #if defined(OS_FUCHSIA)
 void Layer::UpdateScene(SceneUpdateContext& context) {}
 #endif  // defined(OS_FUCHSIA)
@@ -27,12 +40,18 @@ Layer::AutoSaveLayer::AutoSaveLayer(const PaintContext& paint_context,
                                     const SkPaint* paint)
     : paint_context_(paint_context), bounds_(bounds) {
   paint_context_.internal_nodes_canvas->saveLayer(bounds_, paint);
+  if (paint_context_.layer_profile) {
+    paint_context_.layer_profile->CountSaveLayer();
+  }
 }
 
 Layer::AutoSaveLayer::AutoSaveLayer(const PaintContext& paint_context,
                                     const SkCanvas::SaveLayerRec& layer_rec)
     : paint_context_(paint_context), bounds_(*layer_rec.fBounds) {
   paint_context_.internal_nodes_canvas->saveLayer(layer_rec);
+  if (paint_context_.layer_profile) {
+    paint_context_.layer_profile->CountSaveLayer();
+  }
 }
 
 Layer::AutoSaveLayer Layer::AutoSaveLayer::Create(
@@ -8,8 +8,10 @@
 #include <memory>
 #include <vector>
 
+#include "flutter/flow/damage_tracker.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/instrumentation.h"
+#include "flutter/flow/layers/layer_profile.h"
 #include "flutter/flow/raster_cache.h"
 #include "flutter/flow/texture.h"
 #include "flutter/fml/build_config.h"
@@ -41,6 +43,8 @@ namespace flow {
 enum Clip { none, hardEdge, antiAlias, antiAliasWithSaveLayer };
 
 class ContainerLayer;
+class LayerDumper;
+class TransformLayer;
 
 struct PrerollContext {
   RasterCache* raster_cache;
@@ -54,6 +58,32 @@ struct PrerollContext {
   const Stopwatch& engine_time;
   TextureRegistry& texture_registry;
   const bool checkerboard_offscreen_layers;
+  // Null unless layer profiling is enabled.
+  LayerProfile* layer_profile;
+};
+
+// What the optimization pass saved when painting a layer tree. See
+// |Layer::Optimize|.
+struct OptimizationStats {
+  size_t elided_save_layers = 0;
+  size_t elided_clips = 0;
+  size_t merged_transforms = 0;
+};
+
+struct OptimizeContext {
+  const RasterCache* raster_cache;
+  ExternalViewEmbedder* view_embedder;
+  // Set while optimizing the only child of a transform layer. See
+  // |ContainerLayer::OptimizeChildren|.
+  TransformLayer* parent_transform;
+  OptimizationStats stats;
+  // Set while optimizing the children of a layer that may draw them without
+  // its save layer if they all blend with srcOver. See
+  // |OpacityLayer::Optimize|.
+  bool check_blend_modes = false;
+  // Set by the layers found to draw with other blend modes or to read the
+  // destination while |check_blend_modes| is set.
+  bool non_src_over_blends = false;
 };
 
 // Represents a single composited layer. Created on the UI thread but then
@@ -65,6 +95,12 @@ class Layer {
 
   virtual void Preroll(PrerollContext* context, const SkMatrix& matrix);
 
+  // Decides how to paint the layer as cheaply as possible based on the
+  // results of the preroll, for example by skipping clips that do not clip
+  // anything. Called after |Preroll| with the same matrix. Layers that were
+  // not optimized paint exactly what they were given.
+  virtual void Optimize(OptimizeContext* context, const SkMatrix& matrix);
+
   struct PaintContext {
     // When splitting the scene into multiple canvases (e.g when embedding
     // a platform view on iOS) during the paint traversal we apply the non leaf
@@ -84,6 +120,8 @@ class Layer {
     TextureRegistry& texture_registry;
     const RasterCache* raster_cache;
     const bool checkerboard_offscreen_layers;
+    // Null unless layer profiling is enabled.
+    LayerProfile* layer_profile;
   };
 
   // Calls SkCanvas::saveLayer and restores the layer upon destruction. Also
@@ -115,6 +153,21 @@ class Layer {
 
   virtual void Paint(PaintContext& context) const = 0;
 
+  // Adds the device space regions this layer paints to |context| so that
+  // unchanged parts of the frame need not be repainted. Called after
+  // |Preroll| with the same matrix. The default implementation marks the
+  // whole paint bounds as changing on every frame, which is always correct
+  // but defeats partial repaint.
+  virtual void CollectPaintRegions(DamageContext* context,
+                                   const SkMatrix& matrix) const;
+
+  // The name of the type of the layer in diagnostics, like "PictureLayer".
+  virtual const char* type_name() const = 0;
+
+  // Describes this layer and its subtree to |dumper|. Must be called after
+  // |Preroll|. See |LayerTree::Dump|.
+  virtual void Dump(LayerDumper* dumper) const;
+
 #if defined(OS_FUCHSIA)
   // Updates the system composited scene.
   virtual void UpdateScene(SceneUpdateContext& context);
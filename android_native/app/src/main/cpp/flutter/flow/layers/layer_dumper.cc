@@ -0,0 +1,89 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_dumper.h"
+
+#include <iomanip>
+#include <sstream>
+
+#include "flutter/flow/layers/layer.h"
+#include "flutter/fml/logging.h"
+
+namespace flow {
+
+static void WriteMilliseconds(std::ostream& stream, fml::TimeDelta time) {
+  const auto flags = stream.flags();
+  const auto precision = stream.precision();
+  stream << std::fixed << std::setprecision(3) << time.ToMillisecondsF()
+         << "ms";
+  stream.flags(flags);
+  stream.precision(precision);
+}
+
+LayerDumper::LayerDumper(const RasterCacheCostModel& cost_model)
+    : cost_model_(cost_model) {}
+
+LayerDumper::~LayerDumper() = default;
+
+void LayerDumper::BeginLayer(const Layer& layer) {
+  Node node;
+  node.type_name = layer.type_name();
+  node.paint_bounds = layer.paint_bounds();
+  node.depth = open_nodes_.size();
+  open_nodes_.push_back(nodes_.size());
+  nodes_.push_back(node);
+}
+
+void LayerDumper::AddPicture(const SkPicture& picture) {
+  FML_DCHECK(!open_nodes_.empty());
+  Node& node = nodes_[open_nodes_.back()];
+  const PictureOpProfile ops = PictureOpProfile::Analyze(picture);
+  node.has_pictures = true;
+  node.ops.text += ops.text;
+  node.ops.paths += ops.paths;
+  node.ops.images += ops.images;
+  node.ops.save_layers += ops.save_layers;
+  node.ops.blurs += ops.blurs;
+  node.ops.other += ops.other;
+  node.self_time =
+      cost_model_.PredictPlaybackTime(node.ops.WeightedOpCount());
+}
+
+void LayerDumper::EndLayer() {
+  FML_DCHECK(!open_nodes_.empty());
+  Node& node = nodes_[open_nodes_.back()];
+  open_nodes_.pop_back();
+  // The children have added their totals already.
+  node.total_time = node.total_time + node.self_time;
+  if (!open_nodes_.empty()) {
+    Node& parent = nodes_[open_nodes_.back()];
+    parent.total_time = parent.total_time + node.total_time;
+  }
+}
+
+std::string LayerDumper::ToString() const {
+  FML_DCHECK(open_nodes_.empty());
+  std::stringstream stream;
+  for (const auto& node : nodes_) {
+    const SkRect& bounds = node.paint_bounds;
+    stream << std::string(node.depth * 2, ' ') << node.type_name
+           << " bounds=[" << bounds.fLeft << ", " << bounds.fTop << ", "
+           << bounds.fRight << ", " << bounds.fBottom << "] self=";
+    WriteMilliseconds(stream, node.self_time);
+    stream << " total=";
+    WriteMilliseconds(stream, node.total_time);
+    if (node.has_pictures) {
+      stream << " ops={text: " << node.ops.text
+             << ", paths: " << node.ops.paths
+             << ", images: " << node.ops.images
+             << ", saveLayers: " << node.ops.save_layers
+             << ", blurs: " << node.ops.blurs
+             << ", other: " << node.ops.other << "}";
+    }
+    stream << std::endl;
+  }
+  return stream.str();
+}
+
+}  // namespace flow
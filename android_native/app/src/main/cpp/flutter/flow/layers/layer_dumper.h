@@ -0,0 +1,69 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_LAYERS_LAYER_DUMPER_H_
+#define FLUTTER_FLOW_LAYERS_LAYER_DUMPER_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include "flutter/flow/raster_cache_cost_model.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+namespace flow {
+
+class Layer;
+
+// Describes a layer tree as text, one line per layer indented by its depth.
+// Each line has the type and paint bounds of the layer and the predicted time
+// to paint the layer itself and its whole subtree. Only pictures are predicted
+// to take time, based on their ops and the playback times measured by the
+// raster cache. Used to look into slow frames after the fact.
+//
+// Layers describe themselves from |Layer::Dump| by calling |BeginLayer|, then
+// dumping their children and calling |EndLayer|.
+class LayerDumper {
+ public:
+  explicit LayerDumper(const RasterCacheCostModel& cost_model);
+
+  ~LayerDumper();
+
+  void BeginLayer(const Layer& layer);
+
+  // Adds the ops of |picture| to the cost of the layer begun last.
+  void AddPicture(const SkPicture& picture);
+
+  void EndLayer();
+
+  // Must only be called once all layers have ended.
+  std::string ToString() const;
+
+ private:
+  struct Node {
+    const char* type_name;
+    SkRect paint_bounds;
+    size_t depth;
+    bool has_pictures = false;
+    PictureOpProfile ops;
+    fml::TimeDelta self_time;
+    fml::TimeDelta total_time;
+  };
+
+  const RasterCacheCostModel& cost_model_;
+  // In the order the layers are painted.
+  std::vector<Node> nodes_;
+  // The indices of the layers that have begun but not ended.
+  std::vector<size_t> open_nodes_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(LayerDumper);
+};
+
+}  // namespace flow
+
+#endif  // FLUTTER_FLOW_LAYERS_LAYER_DUMPER_H_
@@ -0,0 +1,109 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <iomanip>
+#include <sstream>
+
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/layer_dumper.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+
+namespace flow {
+
+namespace {
+
+sk_sp<SkPicture> GetRectsPicture(int count) {
+  SkPictureRecorder recorder;
+  recorder.beginRecording(SkRect::MakeWH(100, 100));
+  SkPaint paint;
+  for (int i = 0; i < count; i++) {
+    recorder.getRecordingCanvas()->drawRect(SkRect::MakeXYWH(i, i, 10, 10),
+                                            paint);
+  }
+  return recorder.finishRecordingAsPicture();
+}
+
+// Dumps like a picture layer without needing an unref queue.
+class RectsLayer : public Layer {
+ public:
+  explicit RectsLayer(int count) : picture_(GetRectsPicture(count)) {
+    set_paint_bounds(picture_->cullRect());
+  }
+
+  void Paint(PaintContext& context) const override {}
+
+  const char* type_name() const override { return "RectsLayer"; }
+
+  void Dump(LayerDumper* dumper) const override {
+    dumper->BeginLayer(*this);
+    dumper->AddPicture(*picture_);
+    dumper->EndLayer();
+  }
+
+ private:
+  sk_sp<SkPicture> picture_;
+};
+
+class TestContainerLayer : public ContainerLayer {
+ public:
+  TestContainerLayer() { set_paint_bounds(SkRect::MakeWH(100, 100)); }
+
+  void Paint(PaintContext& context) const override {}
+};
+
+}  // namespace
+
+TEST(LayerDumper, DumpsOneIndentedLinePerLayer) {
+  RasterCacheCostModel cost_model;
+  TestContainerLayer root;
+  auto child = std::make_shared<TestContainerLayer>();
+  child->Add(std::make_shared<RectsLayer>(1));
+  root.Add(child);
+  root.Add(std::make_shared<RectsLayer>(1));
+
+  LayerDumper dumper(cost_model);
+  root.Dump(&dumper);
+  const std::string dump = dumper.ToString();
+
+  const std::string expected_prefixes[] = {
+      "ContainerLayer bounds=[0, 0, 100, 100] ",
+      "  ContainerLayer bounds=[0, 0, 100, 100] ",
+      "    RectsLayer bounds=[0, 0, 100, 100] ",
+      "  RectsLayer bounds=[0, 0, 100, 100] ",
+  };
+  size_t line_start = 0;
+  for (const auto& prefix : expected_prefixes) {
+    ASSERT_EQ(dump.compare(line_start, prefix.size(), prefix), 0) << dump;
+    line_start = dump.find('\n', line_start) + 1;
+  }
+  ASSERT_EQ(line_start, dump.size());
+  ASSERT_NE(dump.find("ops={text: 0, paths: 0, images: 0, saveLayers: 0, "
+                      "blurs: 0, other: 1}"),
+            std::string::npos);
+}
+
+TEST(LayerDumper, TotalsIncludeTheSubtree) {
+  RasterCacheCostModel cost_model;
+  const fml::TimeDelta rect_time = cost_model.PredictPlaybackTime(1);
+  TestContainerLayer root;
+  root.Add(std::make_shared<RectsLayer>(1000));
+  root.Add(std::make_shared<RectsLayer>(2000));
+
+  LayerDumper dumper(cost_model);
+  root.Dump(&dumper);
+  const std::string dump = dumper.ToString();
+
+  std::stringstream expected;
+  expected << std::fixed << std::setprecision(3)
+           << "self=0.000ms total=" << (rect_time * 3000).ToMillisecondsF()
+           << "ms\n";
+  ASSERT_NE(dump.find(expected.str()), std::string::npos) << dump;
+  expected.str("");
+  expected << "self=" << (rect_time * 2000).ToMillisecondsF()
+           << "ms total=" << (rect_time * 2000).ToMillisecondsF() << "ms";
+  ASSERT_NE(dump.find(expected.str()), std::string::npos) << dump;
+}
+
+}  // namespace flow
@@ -0,0 +1,210 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/backdrop_filter_layer.h"
+#include "flutter/flow/layers/clip_rect_layer.h"
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/utils/SkNoDrawCanvas.h"
+
+namespace flow {
+
+class RectLayer : public Layer {
+ public:
+  explicit RectLayer(const SkRect& rect,
+                     SkBlendMode blend_mode = SkBlendMode::kSrcOver)
+      : rect_(rect), blend_mode_(blend_mode) {}
+
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override {
+    set_paint_bounds(rect_);
+  }
+
+  // Reports the blend mode like |PictureLayer::Optimize|.
+  void Optimize(OptimizeContext* context, const SkMatrix& matrix) override {
+    if (context->check_blend_modes && blend_mode_ != SkBlendMode::kSrcOver) {
+      context->non_src_over_blends = true;
+    }
+  }
+
+  void Paint(PaintContext& context) const override {
+    SkPaint paint;
+    paint.setBlendMode(blend_mode_);
+    context.leaf_nodes_canvas->drawRect(rect_, paint);
+  }
+
+  const char* type_name() const override { return "RectLayer"; }
+
+ private:
+  SkRect rect_;
+  SkBlendMode blend_mode_;
+};
+
+// Counts the canvas calls the optimization pass is supposed to avoid.
+class CountingCanvas : public SkNoDrawCanvas {
+ public:
+  CountingCanvas() : SkNoDrawCanvas(100, 100) {}
+
+  int save_layer_count = 0;
+  int clip_count = 0;
+  int save_count = 0;
+  int draw_count = 0;
+
+ protected:
+  SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec& rec) override {
+    save_layer_count++;
+    return kNoLayer_SaveLayerStrategy;
+  }
+
+  void onClipRect(const SkRect& rect,
+                  SkClipOp op,
+                  ClipEdgeStyle style) override {
+    clip_count++;
+    SkNoDrawCanvas::onClipRect(rect, op, style);
+  }
+
+  void willSave() override { save_count++; }
+
+  void onDrawRect(const SkRect& rect, const SkPaint& paint) override {
+    draw_count++;
+  }
+};
+
+class LayerOptimizationTest : public ::testing::Test {
+ protected:
+  OptimizationStats PrerollOptimizeAndPaint(Layer* root) {
+    PrerollContext preroll_context = {
+        nullptr,              // raster_cache
+        nullptr,              // gr_context
+        nullptr,              // view_embedder
+        nullptr,              // dst_color_space
+        SkRect::MakeEmpty(),  // child_paint_bounds
+        stopwatch_,           // frame_time
+        stopwatch_,           // engine_time
+        texture_registry_,    // texture_registry
+        false,                // checkerboard_offscreen_layers
+        nullptr,              // layer_profile
+    };
+    root->Preroll(&preroll_context, SkMatrix::I());
+
+    OptimizeContext optimize_context = {nullptr, nullptr, nullptr, {}};
+    root->Optimize(&optimize_context, SkMatrix::I());
+
+    Layer::PaintContext paint_context = {
+        &canvas_,           // internal_nodes_canvas
+        &canvas_,           // leaf_nodes_canvas
+        nullptr,            // view_embedder
+        stopwatch_,         // frame_time
+        stopwatch_,         // engine_time
+        texture_registry_,  // texture_registry
+        nullptr,            // raster_cache
+        false,              // checkerboard_offscreen_layers
+        nullptr,            // layer_profile
+    };
+    root->Paint(paint_context);
+    return optimize_context.stats;
+  }
+
+  CountingCanvas canvas_;
+
+ private:
+  Stopwatch stopwatch_;
+  TextureRegistry texture_registry_;
+};
+
+TEST_F(LayerOptimizationTest, ClipsContainingTheChildrenAreElided) {
+  auto clip = std::make_shared<ClipRectLayer>(Clip::antiAliasWithSaveLayer);
+  clip->set_clip_rect(SkRect::MakeWH(50, 50));
+  clip->Add(std::make_shared<RectLayer>(SkRect::MakeXYWH(10, 10, 10, 10)));
+
+  OptimizationStats stats = PrerollOptimizeAndPaint(clip.get());
+
+  ASSERT_EQ(stats.elided_clips, 1u);
+  ASSERT_EQ(stats.elided_save_layers, 1u);
+  ASSERT_EQ(canvas_.clip_count, 0);
+  ASSERT_EQ(canvas_.save_layer_count, 0);
+  ASSERT_EQ(canvas_.draw_count, 1);
+}
+
+TEST_F(LayerOptimizationTest, ClipsCuttingTheChildrenAreKept) {
+  auto clip = std::make_shared<ClipRectLayer>(Clip::hardEdge);
+  clip->set_clip_rect(SkRect::MakeWH(15, 15));
+  clip->Add(std::make_shared<RectLayer>(SkRect::MakeXYWH(10, 10, 10, 10)));
+
+  OptimizationStats stats = PrerollOptimizeAndPaint(clip.get());
+
+  ASSERT_EQ(stats.elided_clips, 0u);
+  ASSERT_EQ(canvas_.clip_count, 1);
+  ASSERT_EQ(canvas_.draw_count, 1);
+}
+
+TEST_F(LayerOptimizationTest, NestedTransformsAreMerged) {
+  auto outer = std::make_shared<TransformLayer>();
+  outer->set_transform(SkMatrix::MakeTrans(10, 10));
+  auto inner = std::make_shared<TransformLayer>();
+  inner->set_transform(SkMatrix::MakeScale(2, 2));
+  inner->Add(std::make_shared<RectLayer>(SkRect::MakeWH(10, 10)));
+  outer->Add(inner);
+
+  OptimizationStats stats = PrerollOptimizeAndPaint(outer.get());
+
+  ASSERT_EQ(stats.merged_transforms, 1u);
+  ASSERT_EQ(canvas_.save_count, 1);
+  ASSERT_EQ(canvas_.draw_count, 1);
+  ASSERT_EQ(outer->paint_bounds(), SkRect::MakeXYWH(10, 10, 20, 20));
+}
+
+TEST_F(LayerOptimizationTest, OpaqueAndTransparentOpacityLayersSkipSaveLayer) {
+  auto opaque = std::make_shared<OpacityLayer>();
+  opaque->set_alpha(255);
+  opaque->set_offset(SkPoint::Make(0, 0));
+  opaque->Add(std::make_shared<RectLayer>(SkRect::MakeWH(10, 10)));
+
+  auto transparent = std::make_shared<OpacityLayer>();
+  transparent->set_alpha(0);
+  transparent->set_offset(SkPoint::Make(0, 0));
+  transparent->Add(std::make_shared<RectLayer>(SkRect::MakeWH(10, 10)));
+
+  auto root = std::make_shared<TransformLayer>();
+  root->Add(opaque);
+  root->Add(transparent);
+
+  OptimizationStats stats = PrerollOptimizeAndPaint(root.get());
+
+  ASSERT_EQ(stats.elided_save_layers, 2u);
+  ASSERT_EQ(canvas_.save_layer_count, 0);
+  ASSERT_EQ(canvas_.draw_count, 1);
+}
+
+TEST_F(LayerOptimizationTest, OpaqueOpacityLayersKeepSaveLayerForOtherBlends) {
+  auto opaque = std::make_shared<OpacityLayer>();
+  opaque->set_alpha(255);
+  opaque->set_offset(SkPoint::Make(0, 0));
+  opaque->Add(std::make_shared<RectLayer>(SkRect::MakeWH(10, 10)));
+  opaque->Add(std::make_shared<RectLayer>(SkRect::MakeWH(20, 20),
+                                          SkBlendMode::kSrc));
+
+  OptimizationStats stats = PrerollOptimizeAndPaint(opaque.get());
+
+  ASSERT_EQ(stats.elided_save_layers, 0u);
+  ASSERT_EQ(canvas_.save_layer_count, 1);
+  ASSERT_EQ(canvas_.draw_count, 2);
+}
+
+TEST_F(LayerOptimizationTest, OpaqueOpacityLayersKeepSaveLayerForBackdrops) {
+  auto backdrop = std::make_shared<BackdropFilterLayer>();
+  backdrop->Add(std::make_shared<RectLayer>(SkRect::MakeWH(10, 10)));
+  auto opaque = std::make_shared<OpacityLayer>();
+  opaque->set_alpha(255);
+  opaque->set_offset(SkPoint::Make(0, 0));
+  opaque->Add(backdrop);
+
+  OptimizationStats stats = PrerollOptimizeAndPaint(opaque.get());
+
+  ASSERT_EQ(stats.elided_save_layers, 0u);
+  // One for the opacity layer and one for the backdrop filter.
+  ASSERT_EQ(canvas_.save_layer_count, 2);
+}
+
+}  // namespace flow
@@ -0,0 +1,180 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_profile.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <utility>
+
+#include "flutter/flow/layers/layer.h"
+#include "flutter/fml/logging.h"
+
+namespace flow {
+
+static const char* PhaseName(LayerProfile::Phase phase) {
+  switch (phase) {
+    case LayerProfile::Phase::kPreroll:
+      return "Preroll";
+    case LayerProfile::Phase::kPaint:
+      return "Paint";
+  }
+  return "";
+}
+
+LayerProfile::ScopedLayer::ScopedLayer(LayerProfile* profile,
+                                       Phase phase,
+                                       const Layer& layer)
+    : profile_(profile) {
+  if (profile_) {
+    profile_->BeginLayer(phase, layer);
+  }
+}
+
+LayerProfile::ScopedLayer::~ScopedLayer() {
+  if (profile_) {
+    profile_->EndLayer();
+  }
+}
+
+LayerProfile::LayerProfile() = default;
+
+LayerProfile::~LayerProfile() = default;
+
+void LayerProfile::BeginLayer(Phase phase, const Layer& layer) {
+  auto& entries = entries_[static_cast<size_t>(phase)];
+  size_t depth = 0;
+  for (const auto& open : open_entries_) {
+    if (open.phase == phase) {
+      depth++;
+    }
+  }
+  Entry entry;
+  entry.type_name = layer.type_name();
+  entry.depth = depth;
+  open_entries_.push_back({phase, entries.size(), fml::TimePoint::Now(),
+                           fml::TimeDelta::Zero()});
+  entries.push_back(entry);
+}
+
+void LayerProfile::EndLayer() {
+  FML_DCHECK(!open_entries_.empty());
+  const OpenEntry open = open_entries_.back();
+  open_entries_.pop_back();
+
+  Entry& entry = entries_[static_cast<size_t>(open.phase)][open.index];
+  entry.total_time = fml::TimePoint::Now() - open.start;
+  entry.self_time = entry.total_time - open.children_time;
+  entry.subtree_save_layers += entry.save_layers;
+  entry.subtree_raster_cache_hits += entry.raster_cache_hits;
+
+  if (open_entries_.empty()) {
+    return;
+  }
+  OpenEntry& parent_open = open_entries_.back();
+  parent_open.children_time = parent_open.children_time + entry.total_time;
+  Entry& parent = CurrentEntry();
+  parent.subtree_save_layers += entry.subtree_save_layers;
+  parent.subtree_raster_cache_hits += entry.subtree_raster_cache_hits;
+}
+
+LayerProfile::Entry& LayerProfile::CurrentEntry() {
+  FML_DCHECK(!open_entries_.empty());
+  const OpenEntry& open = open_entries_.back();
+  return entries_[static_cast<size_t>(open.phase)][open.index];
+}
+
+void LayerProfile::CountSaveLayer() {
+  if (!open_entries_.empty()) {
+    CurrentEntry().save_layers++;
+  }
+}
+
+void LayerProfile::CountRasterCacheHit() {
+  if (!open_entries_.empty()) {
+    CurrentEntry().raster_cache_hits++;
+  }
+}
+
+std::string LayerProfile::ToFoldedStacks() const {
+  // Layers of the same type under the same stack are merged. Summing the
+  // nanoseconds first keeps many short layers from rounding down to nothing.
+  std::map<std::string, int64_t> nanos_by_stack;
+  for (auto phase : {Phase::kPreroll, Phase::kPaint}) {
+    std::vector<std::string> stack;
+    for (const auto& entry : entries(phase)) {
+      stack.resize(entry.depth);
+      stack.push_back(entry.type_name);
+      std::string folded = PhaseName(phase);
+      for (const auto& frame : stack) {
+        folded += ";";
+        folded += frame;
+      }
+      nanos_by_stack[folded] += entry.self_time.ToNanoseconds();
+    }
+  }
+
+  std::stringstream stream;
+  for (const auto& stack : nanos_by_stack) {
+    stream << stack.first << " " << std::max<int64_t>(stack.second / 1000, 0)
+           << std::endl;
+  }
+  return stream.str();
+}
+
+std::string LayerProfile::ToTypeSummary() const {
+  struct TypeTotals {
+    size_t prerolled = 0;
+    size_t painted = 0;
+    fml::TimeDelta preroll_time;
+    fml::TimeDelta paint_time;
+    size_t save_layers = 0;
+    size_t raster_cache_hits = 0;
+  };
+  // The type names of the same type may be different strings in different
+  // translation units. So they are compared by value.
+  std::map<std::string, TypeTotals> totals_by_type;
+  for (const auto& entry : entries(Phase::kPreroll)) {
+    TypeTotals& totals = totals_by_type[entry.type_name];
+    totals.prerolled++;
+    totals.preroll_time = totals.preroll_time + entry.self_time;
+  }
+  for (const auto& entry : entries(Phase::kPaint)) {
+    TypeTotals& totals = totals_by_type[entry.type_name];
+    totals.painted++;
+    totals.paint_time = totals.paint_time + entry.self_time;
+    totals.save_layers += entry.save_layers;
+    totals.raster_cache_hits += entry.raster_cache_hits;
+  }
+
+  std::vector<std::pair<std::string, TypeTotals>> sorted(
+      totals_by_type.begin(), totals_by_type.end());
+  std::stable_sort(sorted.begin(), sorted.end(),
+                   [](const auto& a, const auto& b) {
+                     return a.second.paint_time > b.second.paint_time;
+                   });
+
+  std::stringstream stream;
+  stream << std::left << std::setw(24) << "type" << std::right
+         << std::setw(10) << "prerolled" << std::setw(10) << "painted"
+         << std::setw(12) << "preroll_ms" << std::setw(12) << "paint_ms"
+         << std::setw(12) << "save_layers" << std::setw(12) << "cache_hits"
+         << std::endl;
+  stream << std::fixed << std::setprecision(3);
+  for (const auto& type : sorted) {
+    const TypeTotals& totals = type.second;
+    stream << std::left << std::setw(24) << type.first << std::right
+           << std::setw(10) << totals.prerolled << std::setw(10)
+           << totals.painted << std::setw(12)
+           << totals.preroll_time.ToMillisecondsF() << std::setw(12)
+           << totals.paint_time.ToMillisecondsF() << std::setw(12)
+           << totals.save_layers << std::setw(12) << totals.raster_cache_hits
+           << std::endl;
+  }
+  return stream.str();
+}
+
+}  // namespace flow
@@ -0,0 +1,107 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_LAYERS_LAYER_PROFILE_H_
+#define FLUTTER_FLOW_LAYERS_LAYER_PROFILE_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace flow {
+
+class Layer;
+
+// The time each layer of a frame took to preroll and to paint. Only recorded
+// when layer profiling is enabled. See
+// |CompositorContext::set_layer_profiling_enabled|.
+//
+// The self time of a layer is the time spent in the layer itself and the
+// total time includes its subtree. Save layers and raster cache hits are
+// counted both for the layer itself and for its subtree.
+class LayerProfile {
+ public:
+  enum class Phase { kPreroll, kPaint };
+
+  struct Entry {
+    const char* type_name;
+    // The number of ancestors profiled in the same phase.
+    size_t depth;
+    fml::TimeDelta self_time;
+    fml::TimeDelta total_time;
+    size_t save_layers = 0;
+    size_t subtree_save_layers = 0;
+    size_t raster_cache_hits = 0;
+    size_t subtree_raster_cache_hits = 0;
+  };
+
+  // Profiles |layer| from construction till destruction. Does nothing if
+  // |profile| is null, which is the case unless profiling is enabled.
+  class ScopedLayer {
+   public:
+    ScopedLayer(LayerProfile* profile, Phase phase, const Layer& layer);
+
+    ~ScopedLayer();
+
+   private:
+    LayerProfile* profile_;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(ScopedLayer);
+  };
+
+  LayerProfile();
+
+  ~LayerProfile();
+
+  // Counts a save layer of the layer that is being profiled.
+  void CountSaveLayer();
+
+  // Counts the layer that is being profiled drawing a raster cache image
+  // instead of itself or its children.
+  void CountRasterCacheHit();
+
+  // The profiled layers of |phase| in the order they were visited.
+  const std::vector<Entry>& entries(Phase phase) const {
+    return entries_[static_cast<size_t>(phase)];
+  }
+
+  // The self times in microseconds in the folded stack format of flame graph
+  // tools like flamegraph.pl and speedscope. There is one line per stack of
+  // layer types, rooted at the phase. For example
+  // "Paint;TransformLayer;PictureLayer 1234".
+  std::string ToFoldedStacks() const;
+
+  // A table of the self times, save layers and raster cache hits of each
+  // type of layer. The most expensive types to paint come first.
+  std::string ToTypeSummary() const;
+
+ private:
+  struct OpenEntry {
+    Phase phase;
+    size_t index;
+    fml::TimePoint start;
+    fml::TimeDelta children_time;
+  };
+
+  std::vector<Entry> entries_[2];
+  // The layers being profiled, innermost last.
+  std::vector<OpenEntry> open_entries_;
+
+  void BeginLayer(Phase phase, const Layer& layer);
+
+  void EndLayer();
+
+  Entry& CurrentEntry();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(LayerProfile);
+};
+
+}  // namespace flow
+
+#endif  // FLUTTER_FLOW_LAYERS_LAYER_PROFILE_H_
@@ -0,0 +1,149 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/layer_profile.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/utils/SkNoDrawCanvas.h"
+
+namespace flow {
+
+namespace {
+
+// Takes a while to paint and optionally saves a layer while doing so.
+class SlowLayer : public Layer {
+ public:
+  explicit SlowLayer(bool save_layer) : save_layer_(save_layer) {}
+
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override {
+    set_paint_bounds(SkRect::MakeWH(10, 10));
+  }
+
+  void Paint(PaintContext& context) const override {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    if (save_layer_) {
+      Layer::AutoSaveLayer save =
+          Layer::AutoSaveLayer::Create(context, paint_bounds(), nullptr);
+    }
+  }
+
+  const char* type_name() const override { return "SlowLayer"; }
+
+ private:
+  bool save_layer_;
+};
+
+class TestContainerLayer : public ContainerLayer {
+ public:
+  void Paint(PaintContext& context) const override { PaintChildren(context); }
+};
+
+}  // namespace
+
+class LayerProfileTest : public ::testing::Test {
+ protected:
+  LayerProfileTest() : canvas_(100, 100) {}
+
+  void PrerollAndPaint(Layer* root, LayerProfile* profile) {
+    PrerollContext preroll_context = {
+        nullptr,              // raster_cache
+        nullptr,              // gr_context
+        nullptr,              // view_embedder
+        nullptr,              // dst_color_space
+        SkRect::MakeEmpty(),  // child_paint_bounds
+        stopwatch_,           // frame_time
+        stopwatch_,           // engine_time
+        texture_registry_,    // texture_registry
+        false,                // checkerboard_offscreen_layers
+        profile,              // layer_profile
+    };
+    {
+      LayerProfile::ScopedLayer profiled(
+          profile, LayerProfile::Phase::kPreroll, *root);
+      root->Preroll(&preroll_context, SkMatrix::I());
+    }
+
+    Layer::PaintContext paint_context = {
+        &canvas_,           // internal_nodes_canvas
+        &canvas_,           // leaf_nodes_canvas
+        nullptr,            // view_embedder
+        stopwatch_,         // frame_time
+        stopwatch_,         // engine_time
+        texture_registry_,  // texture_registry
+        nullptr,            // raster_cache
+        false,              // checkerboard_offscreen_layers
+        profile,            // layer_profile
+    };
+    LayerProfile::ScopedLayer profiled(profile, LayerProfile::Phase::kPaint,
+                                       *root);
+    root->Paint(paint_context);
+  }
+
+ private:
+  SkNoDrawCanvas canvas_;
+  Stopwatch stopwatch_;
+  TextureRegistry texture_registry_;
+};
+
+TEST_F(LayerProfileTest, MeasuresSelfAndTotalTimes) {
+  TestContainerLayer root;
+  root.Add(std::make_shared<SlowLayer>(false));
+  root.Add(std::make_shared<SlowLayer>(true));
+
+  LayerProfile profile;
+  PrerollAndPaint(&root, &profile);
+
+  ASSERT_EQ(profile.entries(LayerProfile::Phase::kPreroll).size(), 3u);
+  const auto& paint = profile.entries(LayerProfile::Phase::kPaint);
+  ASSERT_EQ(paint.size(), 3u);
+
+  const auto& container = paint[0];
+  ASSERT_STREQ(container.type_name, "ContainerLayer");
+  ASSERT_EQ(container.depth, 0u);
+  ASSERT_EQ(paint[1].depth, 1u);
+  ASSERT_EQ(paint[2].depth, 1u);
+  ASSERT_GE(paint[1].self_time, fml::TimeDelta::FromMilliseconds(2));
+  ASSERT_EQ(paint[1].self_time, paint[1].total_time);
+  ASSERT_EQ(container.total_time,
+            container.self_time + paint[1].total_time + paint[2].total_time);
+  ASSERT_LT(container.self_time, paint[1].self_time);
+
+  ASSERT_EQ(paint[1].save_layers, 0u);
+  ASSERT_EQ(paint[2].save_layers, 1u);
+  ASSERT_EQ(container.save_layers, 0u);
+  ASSERT_EQ(container.subtree_save_layers, 1u);
+}
+
+TEST_F(LayerProfileTest, FoldedStacksMergeLayersOfTheSameType) {
+  TestContainerLayer root;
+  root.Add(std::make_shared<SlowLayer>(false));
+  root.Add(std::make_shared<SlowLayer>(false));
+
+  LayerProfile profile;
+  PrerollAndPaint(&root, &profile);
+
+  const std::string folded = profile.ToFoldedStacks();
+  ASSERT_NE(folded.find("Preroll;ContainerLayer "), std::string::npos);
+  ASSERT_NE(folded.find("Preroll;ContainerLayer;SlowLayer "),
+            std::string::npos);
+  ASSERT_NE(folded.find("Paint;ContainerLayer "), std::string::npos);
+  const std::string slow_stack = "Paint;ContainerLayer;SlowLayer ";
+  const size_t slow = folded.find(slow_stack);
+  ASSERT_NE(slow, std::string::npos);
+  // Both layers are on the one line.
+  ASSERT_EQ(folded.find(slow_stack, slow + 1), std::string::npos);
+  const int64_t micros = std::stoll(folded.substr(slow + slow_stack.size()));
+  ASSERT_GE(micros, 4000);
+
+  const std::string summary = profile.ToTypeSummary();
+  ASSERT_EQ(summary.find("type"), 0u);
+  // The most expensive type to paint comes first.
+  ASSERT_LT(summary.find("SlowLayer"), summary.find("ContainerLayer"));
+}
+
+}  // namespace flow
@@ -5,6 +5,7 @@
 #include "flutter/flow/layers/layer_tree.h"
 
 #include "flutter/flow/layers/layer.h"
+#include "flutter/flow/layers/layer_dumper.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
 #include "third_party/skia/include/utils/SkNWayCanvas.h"
@@ -19,6 +20,15 @@ LayerTree::LayerTree()
 
 LayerTree::~LayerTree() = default;
 
+void LayerTree::RecordBuildTime(fml::TimePoint vsync_start,
+                                fml::TimePoint build_start) {
+  vsync_start_ = vsync_start;
+  build_start_ = build_start;
+  build_finish_ = fml::TimePoint::Now();
+  // The construction time has always been measured from the vsync.
+  construction_time_ = build_finish_ - vsync_start_;
+}
+
 void LayerTree::Preroll(CompositorContext::ScopedFrame& frame,
                         bool ignore_raster_cache) {
   TRACE_EVENT0("flutter", "LayerTree::Preroll");
@@ -35,9 +45,39 @@ void LayerTree::Preroll(CompositorContext::ScopedFrame& frame,
       frame.context().frame_time(),
       frame.context().engine_time(),
       frame.context().texture_registry(),
-      checkerboard_offscreen_layers_};
+      checkerboard_offscreen_layers_,
+      frame.layer_profile()};
+
+  {
+    LayerProfile::ScopedLayer profile(
+        context.layer_profile, LayerProfile::Phase::kPreroll, *root_layer_);
+    root_layer_->Preroll(&context, frame.root_surface_transformation());
+  }
 
-  root_layer_->Preroll(&context, frame.root_surface_transformation());
+  if (context.raster_cache) {
+    context.raster_cache->PopulateCandidates();
+  }
+}
+
+OptimizationStats LayerTree::Optimize(CompositorContext::ScopedFrame& frame,
+                                       bool ignore_raster_cache) {
+  TRACE_EVENT0("flutter", "LayerTree::Optimize");
+  OptimizeContext context = {
+      ignore_raster_cache ? nullptr : &frame.context().raster_cache(),
+      frame.view_embedder(),
+      nullptr,
+      {}};
+
+  if (root_layer_->needs_painting()) {
+    root_layer_->Optimize(&context, frame.root_surface_transformation());
+  }
+
+  FML_TRACE_COUNTER("flutter", "ElidedSaveLayers",
+                    context.stats.elided_save_layers);
+  FML_TRACE_COUNTER("flutter", "ElidedClips", context.stats.elided_clips);
+  FML_TRACE_COUNTER("flutter", "MergedTransforms",
+                    context.stats.merged_transforms);
+  return context.stats;
 }
 
 #if defined(OS_FUCHSIA)
@@ -86,10 +126,33 @@ void LayerTree::Paint(CompositorContext::ScopedFrame& frame,
       frame.context().engine_time(),
       frame.context().texture_registry(),
       ignore_raster_cache ? nullptr : &frame.context().raster_cache(),
-      checkerboard_offscreen_layers_};
+      checkerboard_offscreen_layers_,
+      frame.layer_profile()};
 
-  if (root_layer_->needs_painting())
+  if (root_layer_->needs_painting()) {
+    LayerProfile::ScopedLayer profile(
+        context.layer_profile, LayerProfile::Phase::kPaint, *root_layer_);
     root_layer_->Paint(context);
+  }
+}
+
+std::vector<PaintRegion> LayerTree::CollectPaintRegions(
+    const SkMatrix& root_surface_transformation) const {
+  TRACE_EVENT0("flutter", "LayerTree::CollectPaintRegions");
+  DamageContext context(SkIRect::MakeSize(frame_size_));
+  if (root_layer_ && root_layer_->needs_painting()) {
+    root_layer_->CollectPaintRegions(&context, root_surface_transformation);
+  }
+  return context.TakeRegions();
+}
+
+std::string LayerTree::Dump(const RasterCacheCostModel& cost_model) const {
+  TRACE_EVENT0("flutter", "LayerTree::Dump");
+  LayerDumper dumper(cost_model);
+  if (root_layer_) {
+    root_layer_->Dump(&dumper);
+  }
+  return dumper.ToString();
 }
 
 sk_sp<SkPicture> LayerTree::Flatten(const SkRect& bounds) {
@@ -118,6 +181,7 @@ sk_sp<SkPicture> LayerTree::Flatten(const SkRect& bounds) {
       unused_stopwatch,         // engine time (dont care)
       unused_texture_registry,  // texture registry (not supported)
       false,                    // checkerboard_offscreen_layers
+      nullptr,                  // layer profile
   };
 
   SkISize canvas_size = canvas->getBaseLayerSize();
@@ -132,7 +196,8 @@ sk_sp<SkPicture> LayerTree::Flatten(const SkRect& bounds) {
       unused_stopwatch,         // engine time (dont care)
       unused_texture_registry,  // texture registry (not supported)
       nullptr,                  // raster cache
-      false                     // checkerboard offscreen layers
+      false,                    // checkerboard offscreen layers
+      nullptr                   // layer profile
   };
 
   // Even if we don't have a root layer, we still need to create an empty
@@ -141,6 +206,8 @@ sk_sp<SkPicture> LayerTree::Flatten(const SkRect& bounds) {
     root_layer_->Preroll(&preroll_context, root_surface_transformation);
     // The needs painting flag may be set after the preroll. So check it after.
     if (root_layer_->needs_painting()) {
+      OptimizeContext optimize_context = {nullptr, nullptr, nullptr, {}};
+      root_layer_->Optimize(&optimize_context, root_surface_transformation);
       root_layer_->Paint(paint_context);
     }
   }
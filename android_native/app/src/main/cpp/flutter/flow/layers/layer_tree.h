@@ -8,11 +8,15 @@
 #include <stdint.h>
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "flutter/flow/compositor_context.h"
 #include "flutter/flow/layers/layer.h"
+#include "flutter/flow/layers/layer_profile.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/time/time_delta.h"
+#include "flutter/fml/time/time_point.h"
 #include "third_party/skia/include/core/SkPicture.h"
 #include "third_party/skia/include/core/SkSize.h"
 
@@ -27,6 +31,11 @@ class LayerTree {
   void Preroll(CompositorContext::ScopedFrame& frame,
                bool ignore_raster_cache = false);
 
+  // Runs the optimization pass over the prerolled tree. Must be called after
+  // |Preroll| and before |Paint| with the same frame. See |Layer::Optimize|.
+  OptimizationStats Optimize(CompositorContext::ScopedFrame& frame,
+                             bool ignore_raster_cache = false);
+
 #if defined(OS_FUCHSIA)
   void UpdateScene(SceneUpdateContext& context,
                    scenic::ContainerNode& container);
@@ -37,6 +46,15 @@ class LayerTree {
 
   sk_sp<SkPicture> Flatten(const SkRect& bounds);
 
+  // Describes the layers of the tree and their predicted paint cost. Must be
+  // called after |Preroll|. See |LayerDumper|.
+  std::string Dump(const RasterCacheCostModel& cost_model) const;
+
+  // Returns the device space regions painted by this tree. Must be called
+  // after |Preroll|.
+  std::vector<PaintRegion> CollectPaintRegions(
+      const SkMatrix& root_surface_transformation) const;
+
   Layer* root_layer() const { return root_layer_.get(); }
 
   void set_root_layer(std::shared_ptr<Layer> root_layer) {
@@ -53,9 +71,19 @@ class LayerTree {
 
   const fml::TimeDelta& construction_time() const { return construction_time_; }
 
-  // The number of frame intervals missed after which the compositor must
-  // trace the rasterized picture to a trace file. Specify 0 to disable all
-  // tracing
+  // Records that the tree was built for the vsync at |vsync_start|, starting
+  // at |build_start| and finishing now. Also sets the construction time.
+  void RecordBuildTime(fml::TimePoint vsync_start, fml::TimePoint build_start);
+
+  fml::TimePoint vsync_start() const { return vsync_start_; }
+
+  fml::TimePoint build_start() const { return build_start_; }
+
+  fml::TimePoint build_finish() const { return build_finish_; }
+
+  // The number of frame intervals the tree may take from its vsync till it is
+  // submitted before the rasterizer captures its picture, layers and trace.
+  // Specify 0 to disable capturing.
   void set_rasterizer_tracing_threshold(uint32_t interval) {
     rasterizer_tracing_threshold_ = interval;
   }
@@ -64,6 +92,14 @@ class LayerTree {
     return rasterizer_tracing_threshold_;
   }
 
+  // The profile of the last time the tree was rasterized with layer profiling
+  // enabled. See |CompositorContext::set_layer_profiling_enabled|.
+  const LayerProfile* layer_profile() const { return layer_profile_.get(); }
+
+  void set_layer_profile(std::unique_ptr<LayerProfile> profile) {
+    layer_profile_ = std::move(profile);
+  }
+
   void set_checkerboard_raster_cache_images(bool checkerboard) {
     checkerboard_raster_cache_images_ = checkerboard;
   }
@@ -76,7 +112,11 @@ class LayerTree {
   SkISize frame_size_;  // Physical pixels.
   std::shared_ptr<Layer> root_layer_;
   fml::TimeDelta construction_time_;
+  fml::TimePoint vsync_start_;
+  fml::TimePoint build_start_;
+  fml::TimePoint build_finish_;
   uint32_t rasterizer_tracing_threshold_;
+  std::unique_ptr<LayerProfile> layer_profile_;
   bool checkerboard_raster_cache_images_;
   bool checkerboard_offscreen_layers_;
 
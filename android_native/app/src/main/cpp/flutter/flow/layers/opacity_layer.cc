@@ -25,10 +25,54 @@ void OpacityLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   }
 }
 
+void OpacityLayer::Optimize(OptimizeContext* context,
+                            const SkMatrix& matrix) {
+  SkMatrix child_matrix = matrix;
+  child_matrix.postTranslate(offset_.fX, offset_.fY);
+  SkMatrix ctm = child_matrix;
+#ifndef SUPPORT_FRACTIONAL_TRANSLATION
+  ctm = RasterCache::GetIntegralTransCTM(ctm);
+#endif
+
+  // Platform views have to be composited even when they are invisible. So
+  // leave layers with embedded views alone.
+  const bool can_skip = context->view_embedder == nullptr;
+  skip_paint_ = can_skip && alpha_ == 0;
+  if (skip_paint_) {
+    skip_save_layer_ = false;
+    context->stats.elided_save_layers++;
+    return;
+  }
+
+  // Drawing the children directly only looks the same as compositing them
+  // at full opacity if they all blend with srcOver. Either way, the blend
+  // modes of the children do not matter to the ancestors since this layer
+  // itself composites with srcOver.
+  const bool check_blend_modes = context->check_blend_modes;
+  const bool non_src_over_blends = context->non_src_over_blends;
+  context->check_blend_modes = can_skip && alpha_ == 255;
+  context->non_src_over_blends = false;
+  OptimizeChildren(context, child_matrix);
+  skip_save_layer_ =
+      context->check_blend_modes && !context->non_src_over_blends;
+  context->check_blend_modes = check_blend_modes;
+  context->non_src_over_blends = non_src_over_blends;
+
+  if (skip_save_layer_ ||
+      (can_skip && layers().size() == 1 && context->raster_cache &&
+       context->raster_cache->HasImage(layers()[0].get(), ctm))) {
+    context->stats.elided_save_layers++;
+  }
+}
+
 void OpacityLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "OpacityLayer::Paint");
   FML_DCHECK(needs_painting());
 
+  if (skip_paint_) {
+    return;
+  }
+
   SkPaint paint;
   paint.setAlpha(alpha_);
 
@@ -50,11 +94,19 @@ void OpacityLayer::Paint(PaintContext& context) const {
     RasterCacheResult child_cache =
         context.raster_cache->Get(layers()[0].get(), ctm);
     if (child_cache.is_valid()) {
+      if (context.layer_profile) {
+        context.layer_profile->CountRasterCacheHit();
+      }
       child_cache.draw(*context.leaf_nodes_canvas, &paint);
       return;
     }
   }
 
+  if (skip_save_layer_) {
+    PaintChildren(context);
+    return;
+  }
+
   // Skia may clip the content with saveLayerBounds (although it's not a
   // guaranteed clip). So we have to provide a big enough saveLayerBounds. To do
   // so, we first remove the offset from paint bounds since it's already in the
@@ -74,4 +126,17 @@ void OpacityLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+void OpacityLayer::CollectPaintRegions(DamageContext* context,
+                                       const SkMatrix& matrix) const {
+  SkMatrix child_matrix = matrix;
+  child_matrix.preTranslate(offset_.fX, offset_.fY);
+#ifndef SUPPORT_FRACTIONAL_TRANSLATION
+  child_matrix = RasterCache::GetIntegralTransCTM(child_matrix);
+#endif
+  context->Save();
+  context->MixState(alpha_);
+  CollectChildrenPaintRegions(context, child_matrix);
+  context->Restore();
+}
+
 }  // namespace flow
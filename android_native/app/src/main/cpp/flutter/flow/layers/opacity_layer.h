@@ -19,14 +19,24 @@ class OpacityLayer : public ContainerLayer {
 
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
 
+  void Optimize(OptimizeContext* context, const SkMatrix& matrix) override;
+
   void Paint(PaintContext& context) const override;
 
+  const char* type_name() const override { return "OpacityLayer"; }
+
+  void CollectPaintRegions(DamageContext* context,
+                           const SkMatrix& matrix) const override;
+
   // TODO(chinmaygarde): Once MZ-139 is addressed, introduce a new node in the
   // session scene hierarchy.
 
  private:
   int alpha_;
   SkPoint offset_;
+  // Set by |Optimize| for fully transparent and fully opaque layers.
+  bool skip_paint_ = false;
+  bool skip_save_layer_ = false;
 
   FML_DISALLOW_COPY_AND_ASSIGN(OpacityLayer);
 };
@@ -21,6 +21,8 @@ class PerformanceOverlayLayer : public Layer {
 
   void Paint(PaintContext& context) const override;
 
+  const char* type_name() const override { return "PerformanceOverlayLayer"; }
+
  private:
   int options_;
 
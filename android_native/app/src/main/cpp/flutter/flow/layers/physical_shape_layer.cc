@@ -105,6 +105,9 @@ void PhysicalShapeLayer::Paint(PaintContext& context) const {
     case Clip::antiAliasWithSaveLayer:
       context.internal_nodes_canvas->clipPath(path_, true);
       context.internal_nodes_canvas->saveLayer(paint_bounds(), nullptr);
+      if (context.layer_profile) {
+        context.layer_profile->CountSaveLayer();
+      }
       break;
     case Clip::none:
       break;
@@ -123,6 +126,26 @@ void PhysicalShapeLayer::Paint(PaintContext& context) const {
   context.internal_nodes_canvas->restoreToCount(saveCount);
 }
 
+void PhysicalShapeLayer::CollectPaintRegions(DamageContext* context,
+                                             const SkMatrix& matrix) const {
+  context->Save();
+  context->MixState(path_);
+  context->MixState(color_);
+  context->MixState(shadow_color_);
+  context->MixScalarState(elevation_);
+  context->MixScalarState(device_pixel_ratio_);
+  context->MixState(clip_behavior_);
+
+  // The shape and its shadow.
+  context->AddPaintRegion(paint_bounds(), matrix, 0);
+
+  if (clip_behavior_ != Clip::none) {
+    context->ClipRect(path_.getBounds(), matrix);
+  }
+  CollectChildrenPaintRegions(context, matrix);
+  context->Restore();
+}
+
 void PhysicalShapeLayer::DrawShadow(SkCanvas* canvas,
                                     const SkPath& path,
                                     SkColor color,
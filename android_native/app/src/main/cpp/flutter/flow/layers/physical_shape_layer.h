@@ -32,6 +32,11 @@ class PhysicalShapeLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  const char* type_name() const override { return "PhysicalShapeLayer"; }
+
+  void CollectPaintRegions(DamageContext* context,
+                           const SkMatrix& matrix) const override;
+
 #if defined(OS_FUCHSIA)
   void UpdateScene(SceneUpdateContext& context) override;
 #endif  // defined(OS_FUCHSIA)
@@ -4,7 +4,9 @@
 
 #include "flutter/flow/layers/picture_layer.h"
 
+#include "flutter/flow/layers/layer_dumper.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/time/time_point.h"
 
 namespace flow {
 
@@ -29,6 +31,19 @@ void PictureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   set_paint_bounds(bounds);
 }
 
+void PictureLayer::Optimize(OptimizeContext* context,
+                            const SkMatrix& matrix) {
+  if (!context->check_blend_modes) {
+    return;
+  }
+  // Without a raster cache to remember the analysis of the picture, assume
+  // the worst instead of playing it back on every frame.
+  if (context->raster_cache == nullptr ||
+      !context->raster_cache->BlendsOnlySrcOver(*picture())) {
+    context->non_src_over_blends = true;
+  }
+}
+
 void PictureLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "PictureLayer::Paint");
   FML_DCHECK(picture_.get());
@@ -44,12 +59,47 @@ void PictureLayer::Paint(PaintContext& context) const {
   if (context.raster_cache) {
     const SkMatrix& ctm = context.leaf_nodes_canvas->getTotalMatrix();
     RasterCacheResult result = context.raster_cache->Get(*picture(), ctm);
+    // On the GPU backends, the draws below only record commands. Their times
+    // say nothing about the cost of rasterizing and would skew the cost
+    // model, so only software draws are measured.
+    const bool measure = context.leaf_nodes_canvas->getGrContext() == nullptr;
+    const fml::TimePoint start = fml::TimePoint::Now();
     if (result.is_valid()) {
+      if (context.layer_profile) {
+        context.layer_profile->CountRasterCacheHit();
+      }
       result.draw(*context.leaf_nodes_canvas);
+      if (measure) {
+        context.raster_cache->RecordImageDraw(result,
+                                              fml::TimePoint::Now() - start);
+      }
       return;
     }
+    context.leaf_nodes_canvas->drawPicture(picture());
+    if (measure) {
+      context.raster_cache->RecordPicturePlayback(
+          *picture(), fml::TimePoint::Now() - start);
+    }
+    return;
   }
   context.leaf_nodes_canvas->drawPicture(picture());
 }
 
+void PictureLayer::Dump(LayerDumper* dumper) const {
+  dumper->BeginLayer(*this);
+  dumper->AddPicture(*picture());
+  dumper->EndLayer();
+}
+
+void PictureLayer::CollectPaintRegions(DamageContext* context,
+                                       const SkMatrix& matrix) const {
+  // Pictures are immutable. So the unique ID identifies the content.
+  SkMatrix ctm = matrix;
+  ctm.preTranslate(offset_.x(), offset_.y());
+#ifndef SUPPORT_FRACTIONAL_TRANSLATION
+  ctm = RasterCache::GetIntegralTransCTM(ctm);
+#endif
+  context->AddPaintRegion(picture()->cullRect(), ctm, picture()->uniqueID());
+}
+
 }  // namespace flow
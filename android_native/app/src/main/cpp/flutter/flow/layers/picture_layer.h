@@ -30,8 +30,17 @@ class PictureLayer : public Layer {
 
   void Preroll(PrerollContext* frame, const SkMatrix& matrix) override;
 
+  void Optimize(OptimizeContext* context, const SkMatrix& matrix) override;
+
   void Paint(PaintContext& context) const override;
 
+  const char* type_name() const override { return "PictureLayer"; }
+
+  void Dump(LayerDumper* dumper) const override;
+
+  void CollectPaintRegions(DamageContext* context,
+                           const SkMatrix& matrix) const override;
+
  private:
   SkPoint offset_;
   // Even though pictures themselves are not GPU resources, they may reference
@@ -26,6 +26,8 @@ class PlatformViewLayer : public Layer {
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
   void Paint(PaintContext& context) const override;
 
+  const char* type_name() const override { return "PlatformViewLayer"; }
+
  private:
   SkPoint offset_;
   SkSize size_;
@@ -26,4 +26,15 @@ void ShaderMaskLayer::Paint(PaintContext& context) const {
       SkRect::MakeWH(mask_rect_.width(), mask_rect_.height()), paint);
 }
 
+void ShaderMaskLayer::CollectPaintRegions(DamageContext* context,
+                                          const SkMatrix& matrix) const {
+  context->Save();
+  // Shaders can't be compared by value. So a new shader damages the children.
+  context->MixState(reinterpret_cast<uintptr_t>(shader_.get()));
+  context->MixState(mask_rect_);
+  context->MixState(static_cast<uint64_t>(blend_mode_));
+  CollectChildrenPaintRegions(context, matrix);
+  context->Restore();
+}
+
 }  // namespace flow
@@ -24,6 +24,11 @@ class ShaderMaskLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  const char* type_name() const override { return "ShaderMaskLayer"; }
+
+  void CollectPaintRegions(DamageContext* context,
+                           const SkMatrix& matrix) const override;
+
  private:
   sk_sp<SkShader> shader_;
   SkRect mask_rect_;
@@ -21,6 +21,19 @@ void TransformLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   set_paint_bounds(child_paint_bounds);
 }
 
+void TransformLayer::Optimize(OptimizeContext* context,
+                              const SkMatrix& matrix) {
+  if (context->parent_transform != nullptr) {
+    context->parent_transform->merged_child_ = this;
+    context->stats.merged_transforms++;
+  }
+  merged_child_ = nullptr;
+
+  SkMatrix child_matrix;
+  child_matrix.setConcat(matrix, transform_);
+  OptimizeChildren(context, child_matrix, this);
+}
+
 #if defined(OS_FUCHSIA)
 
 void TransformLayer::UpdateScene(SceneUpdateContext& context) {
@@ -38,7 +51,21 @@ void TransformLayer::Paint(PaintContext& context) const {
 
   SkAutoCanvasRestore save(context.internal_nodes_canvas, true);
   context.internal_nodes_canvas->concat(transform_);
-  PaintChildren(context);
+  // Children added since the last optimization pass invalidate the merge.
+  const TransformLayer* layer = this;
+  while (layer->merged_child_ != nullptr && layer->layers().size() == 1 &&
+         layer->layers()[0].get() == layer->merged_child_) {
+    layer = layer->merged_child_;
+    context.internal_nodes_canvas->concat(layer->transform_);
+  }
+  layer->PaintChildren(context);
+}
+
+void TransformLayer::CollectPaintRegions(DamageContext* context,
+                                         const SkMatrix& matrix) const {
+  SkMatrix child_matrix;
+  child_matrix.setConcat(matrix, transform_);
+  CollectChildrenPaintRegions(context, child_matrix);
 }
 
 }  // namespace flow
@@ -18,14 +18,24 @@ class TransformLayer : public ContainerLayer {
 
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
 
+  void Optimize(OptimizeContext* context, const SkMatrix& matrix) override;
+
   void Paint(PaintContext& context) const override;
 
+  const char* type_name() const override { return "TransformLayer"; }
+
+  void CollectPaintRegions(DamageContext* context,
+                           const SkMatrix& matrix) const override;
+
 #if defined(OS_FUCHSIA)
   void UpdateScene(SceneUpdateContext& context) override;
 #endif  // defined(OS_FUCHSIA)
 
  private:
   SkMatrix transform_;
+  // The only child if it is a transform layer too. Its transform is
+  // concatenated with this one and its children are painted directly.
+  TransformLayer* merged_child_ = nullptr;
 
   FML_DISALLOW_COPY_AND_ASSIGN(TransformLayer);
 };
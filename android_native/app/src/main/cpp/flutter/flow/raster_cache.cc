@@ -4,11 +4,14 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <algorithm>
+#include <string>
 #include <vector>
 
 #include "flutter/flow/layers/layer.h"
 #include "flutter/flow/paint_utils.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkColorSpaceXformCanvas.h"
@@ -28,6 +31,21 @@ RasterCacheResult::RasterCacheResult(sk_sp<SkImage> image,
                                      const SkRect& logical_rect)
     : image_(std::move(image)), logical_rect_(logical_rect) {}
 
+size_t RasterCacheResult::image_bytes() const {
+  if (!image_) {
+    return 0;
+  }
+  return static_cast<size_t>(image_->width()) * image_->height() *
+         SkColorTypeBytesPerPixel(image_->colorType());
+}
+
+int64_t RasterCacheResult::pixel_count() const {
+  if (!image_) {
+    return 0;
+  }
+  return static_cast<int64_t>(image_->width()) * image_->height();
+}
+
 void RasterCacheResult::draw(SkCanvas& canvas, const SkPaint* paint) const {
   SkAutoCanvasRestore auto_restore(&canvas, true);
   SkIRect bounds =
@@ -37,8 +55,19 @@ void RasterCacheResult::draw(SkCanvas& canvas, const SkPaint* paint) const {
   canvas.drawImage(image_, bounds.fLeft, bounds.fTop, paint);
 }
 
-RasterCache::RasterCache(size_t threshold)
-    : threshold_(threshold), checkerboard_images_(false), weak_factory_(this) {}
+constexpr size_t RasterCache::kDefaultMaxBytes;
+constexpr size_t RasterCache::kDefaultMaxUnusedFrames;
+
+RasterCache::RasterCache(size_t threshold,
+                         size_t max_bytes,
+                         size_t max_unused_frames)
+    : threshold_(threshold),
+      max_bytes_(max_bytes),
+      max_unused_frames_(max_unused_frames),
+      resident_bytes_(0),
+      access_sequence_(0),
+      checkerboard_images_(false),
+      weak_factory_(this) {}
 
 RasterCache::~RasterCache() = default;
 
@@ -62,9 +91,7 @@ static bool CanRasterizePicture(SkPicture* picture) {
   return true;
 }
 
-static bool IsPictureWorthRasterizing(SkPicture* picture,
-                                      bool will_change,
-                                      bool is_complex) {
+static bool IsPictureCacheable(SkPicture* picture, bool will_change) {
   if (will_change) {
     // If the picture is going to change in the future, there is no point in
     // doing to extra work to rasterize.
@@ -77,15 +104,7 @@ static bool IsPictureWorthRasterizing(SkPicture* picture,
     return false;
   }
 
-  if (is_complex) {
-    // The caller seems to have extra information about the picture and thinks
-    // the picture is always worth rasterizing.
-    return true;
-  }
-
-  // TODO(abarth): We should find a better heuristic here that lets us avoid
-  // wasting memory on trivial layers that are easy to re-rasterize every frame.
-  return picture->approximateOpCount() > 10;
+  return true;
 }
 
 static RasterCacheResult Rasterize(
@@ -155,34 +174,130 @@ static inline size_t ClampSize(size_t value, size_t min, size_t max) {
   return value;
 }
 
+void RasterCache::Touch(Entry& entry) {
+  entry.access_count = ClampSize(entry.access_count + 1, 0, threshold_);
+  entry.used_this_frame = true;
+  entry.last_access = ++access_sequence_;
+}
+
+void RasterCache::SetEntryImage(Entry& entry, RasterCacheResult image) {
+  FML_DCHECK(!entry.image.is_valid());
+  if (!image.is_valid()) {
+    return;
+  }
+  entry.image_bytes = image.image_bytes();
+  entry.image = std::move(image);
+  resident_bytes_ += entry.image_bytes;
+  // The new entry is the most recently used one. So it is only evicted if
+  // everything else in use this frame does not fit either.
+  EvictToBudget(false);
+}
+
+// Layers are not analyzed. The cached layers are subtrees that would otherwise
+// need a save layer on every frame, so treat them like fairly complex
+// pictures. See |PictureOpProfile::WeightedOpCount|.
+static constexpr double kLayerWeightedOpCountEstimate = 100;
+
+void RasterCache::PopulateOrDefer(
+    Entry& entry,
+    const SkIRect& device_bounds,
+    fml::TimeDelta playback_time,
+    std::function<RasterCacheResult()> rasterize) {
+  if (population_budget_.is_unlimited()) {
+    SetEntryImage(entry, rasterize());
+    return;
+  }
+  const int64_t pixels =
+      static_cast<int64_t>(device_bounds.width()) * device_bounds.height();
+  // The time saved by caching grows with the work per pixel, the number of
+  // pixels and the number of frames the image is going to be drawn in. The
+  // predicted playback time stands in for the work per pixel since it does
+  // not depend on the scale the picture is drawn at. Deferred entries gain
+  // priority with every frame they wait so that they are not starved, which
+  // needs a positive cost.
+  const double cost_nanos = std::max<double>(playback_time.ToNanoseconds(), 1);
+  const double frequency = entry.access_count + entry.deferred_frames;
+  const double priority = cost_nanos * pixels * frequency;
+  candidates_.push_back({&entry, priority, pixels, std::move(rasterize)});
+}
+
+void RasterCache::PopulateCandidates() {
+  if (candidates_.empty()) {
+    return;
+  }
+
+  TRACE_EVENT1("flutter", "RasterCache::PopulateCandidates", "candidates",
+               std::to_string(candidates_.size()).c_str());
+
+  std::sort(candidates_.begin(), candidates_.end(),
+            [](const Candidate& a, const Candidate& b) {
+              return a.priority > b.priority;
+            });
+
+  const fml::TimePoint start = fml::TimePoint::Now();
+  int64_t pixels = 0;
+  bool populated_any = false;
+  for (auto& candidate : candidates_) {
+    if (candidate.entry->image.is_valid()) {
+      // The entry was prepared more than once this frame.
+      continue;
+    }
+    const bool fits =
+        fml::TimePoint::Now() - start < population_budget_.max_time &&
+        candidate.pixels <= population_budget_.max_pixels - pixels;
+    if (populated_any && !fits) {
+      candidate.entry->deferred_frames++;
+      deferral_count_.Increment();
+      continue;
+    }
+    populated_any = true;
+    pixels += candidate.pixels;
+    candidate.entry->deferred_frames = 0;
+    SetEntryImage(*candidate.entry, candidate.rasterize());
+  }
+  candidates_.clear();
+}
+
 void RasterCache::Prepare(PrerollContext* context,
                           Layer* layer,
                           const SkMatrix& ctm) {
   LayerRasterCacheKey cache_key(layer, ctm);
   Entry& entry = layer_cache_[cache_key];
-  entry.access_count = ClampSize(entry.access_count + 1, 0, threshold_);
-  entry.used_this_frame = true;
+  Touch(entry);
+
+  if (entry.access_count < threshold_ || threshold_ == 0) {
+    // Frame threshold has not yet been reached.
+    return;
+  }
+
   if (!entry.image.is_valid()) {
-    entry.image = Rasterize(context->gr_context, ctm, context->dst_color_space,
-                            checkerboard_images_, layer->paint_bounds(),
-                            [layer, context](SkCanvas* canvas) {
-                              SkISize canvas_size = canvas->getBaseLayerSize();
-                              SkNWayCanvas internal_nodes_canvas(
-                                  canvas_size.width(), canvas_size.height());
-                              internal_nodes_canvas.addCanvas(canvas);
-                              Layer::PaintContext paintContext = {
-                                  (SkCanvas*)&internal_nodes_canvas,
-                                  canvas,
-                                  nullptr,
-                                  context->frame_time,
-                                  context->engine_time,
-                                  context->texture_registry,
-                                  context->raster_cache,
-                                  context->checkerboard_offscreen_layers};
-                              if (layer->needs_painting()) {
-                                layer->Paint(paintContext);
-                              }
-                            });
+    auto rasterize = [this, context, layer, ctm]() {
+      return Rasterize(context->gr_context, ctm, context->dst_color_space,
+                       checkerboard_images_, layer->paint_bounds(),
+                       [layer, context](SkCanvas* canvas) {
+                         SkISize canvas_size = canvas->getBaseLayerSize();
+                         SkNWayCanvas internal_nodes_canvas(
+                             canvas_size.width(), canvas_size.height());
+                         internal_nodes_canvas.addCanvas(canvas);
+                         Layer::PaintContext paintContext = {
+                             (SkCanvas*)&internal_nodes_canvas,
+                             canvas,
+                             nullptr,
+                             context->frame_time,
+                             context->engine_time,
+                             context->texture_registry,
+                             context->raster_cache,
+                             context->checkerboard_offscreen_layers,
+                             nullptr};
+                         if (layer->needs_painting()) {
+                           layer->Paint(paintContext);
+                         }
+                       });
+    };
+    PopulateOrDefer(
+        entry, GetDeviceBounds(layer->paint_bounds(), ctm),
+        cost_model_.PredictPlaybackTime(kLayerWeightedOpCountEstimate),
+        std::move(rasterize));
   }
 }
 
@@ -192,8 +307,7 @@ bool RasterCache::Prepare(GrContext* context,
                           SkColorSpace* dst_color_space,
                           bool is_complex,
                           bool will_change) {
-  if (!IsPictureWorthRasterizing(picture, will_change, is_complex)) {
-    // We only deal with pictures that are worthy of rasterization.
+  if (!IsPictureCacheable(picture, will_change)) {
     return false;
   }
 
@@ -209,44 +323,199 @@ bool RasterCache::Prepare(GrContext* context,
   PictureRasterCacheKey cache_key(picture->uniqueID(), transformation_matrix);
 
   Entry& entry = picture_cache_[cache_key];
-  entry.access_count = ClampSize(entry.access_count + 1, 0, threshold_);
-  entry.used_this_frame = true;
+  Touch(entry);
 
   if (entry.access_count < threshold_ || threshold_ == 0) {
     // Frame threshold has not yet been reached.
     return false;
   }
 
+  const SkIRect device_bounds =
+      GetDeviceBounds(picture->cullRect(), transformation_matrix);
+  const int64_t pixels =
+      static_cast<int64_t>(device_bounds.width()) * device_bounds.height();
+  // The caller may have extra information about the picture and think it is
+  // always worth rasterizing. Otherwise, only pictures that are more
+  // expensive to play back than their images are to draw are rasterized.
+  // Pictures are only analyzed once they are reused across enough frames.
+  if (!is_complex && !cost_model_.IsWorthCaching(*picture, pixels)) {
+    return false;
+  }
+
   if (!entry.image.is_valid()) {
-    entry.image = RasterizePicture(picture, context, transformation_matrix,
-                                   dst_color_space, checkerboard_images_);
+    if (context == nullptr && rasterization_task_runner_) {
+      return PrepareAsync(entry, picture, transformation_matrix,
+                          dst_color_space);
+    }
+    if (!population_budget_.is_unlimited()) {
+      PopulateOrDefer(
+          entry, device_bounds, cost_model_.PredictPlaybackTime(*picture),
+          [this, picture, context, transformation_matrix, dst_color_space]() {
+            return RasterizePicture(picture, context, transformation_matrix,
+                                    dst_color_space, checkerboard_images_);
+          });
+      return false;
+    }
+    SetEntryImage(entry,
+                  RasterizePicture(picture, context, transformation_matrix,
+                                   dst_color_space, checkerboard_images_));
   }
   return true;
 }
 
+bool RasterCache::PrepareAsync(Entry& entry,
+                               SkPicture* picture,
+                               const SkMatrix& ctm,
+                               SkColorSpace* dst_color_space) {
+  if (!entry.pending) {
+    entry.pending = std::make_shared<AsyncResult>();
+    std::weak_ptr<AsyncResult> weak_result = entry.pending;
+    // Pictures and color spaces are immutable and may be played back on any
+    // thread. Only software surfaces are used, so no GrContext is involved.
+    rasterization_task_runner_->PostTask(
+        [weak_result, picture = sk_ref_sp(picture), ctm,
+         color_space = sk_ref_sp(dst_color_space),
+         checkerboard = checkerboard_images_]() {
+          if (weak_result.expired()) {
+            // The entry was evicted before the task got to run.
+            return;
+          }
+          RasterCacheResult image = RasterizePicture(
+              picture.get(), nullptr, ctm, color_space.get(), checkerboard);
+          if (auto result = weak_result.lock()) {
+            result->image = std::move(image);
+            result->ready.store(true, std::memory_order_release);
+          }
+        });
+    return false;
+  }
+
+  if (!entry.pending->ready.load(std::memory_order_acquire)) {
+    return false;
+  }
+
+  RasterCacheResult image = std::move(entry.pending->image);
+  entry.pending.reset();
+  SetEntryImage(entry, std::move(image));
+  return entry.image.is_valid();
+}
+
+RasterCacheResult RasterCache::GetEntryImage(const Entry* entry) const {
+  if (entry == nullptr) {
+    // Never prepared. So neither a hit nor a miss.
+    return {};
+  }
+  if (entry->image.is_valid()) {
+    hit_count_.Increment();
+  } else {
+    miss_count_.Increment();
+  }
+  return entry->image;
+}
+
 RasterCacheResult RasterCache::Get(const SkPicture& picture,
                                    const SkMatrix& ctm) const {
   PictureRasterCacheKey cache_key(picture.uniqueID(), ctm);
   auto it = picture_cache_.find(cache_key);
-  return it == picture_cache_.end() ? RasterCacheResult() : it->second.image;
+  return GetEntryImage(it == picture_cache_.end() ? nullptr : &it->second);
 }
 
 RasterCacheResult RasterCache::Get(Layer* layer, const SkMatrix& ctm) const {
   LayerRasterCacheKey cache_key(layer, ctm);
   auto it = layer_cache_.find(cache_key);
-  return it == layer_cache_.end() ? RasterCacheResult() : it->second.image;
+  return GetEntryImage(it == layer_cache_.end() ? nullptr : &it->second);
+}
+
+bool RasterCache::HasImage(Layer* layer, const SkMatrix& ctm) const {
+  LayerRasterCacheKey cache_key(layer, ctm);
+  auto it = layer_cache_.find(cache_key);
+  return it != layer_cache_.end() && it->second.image.is_valid();
+}
+
+bool RasterCache::BlendsOnlySrcOver(const SkPicture& picture) const {
+  return cost_model_.BlendsOnlySrcOver(picture);
+}
+
+void RasterCache::RecordPicturePlayback(const SkPicture& picture,
+                                        fml::TimeDelta time) const {
+  cost_model_.RecordPlayback(picture, time);
+}
+
+void RasterCache::RecordImageDraw(const RasterCacheResult& image,
+                                  fml::TimeDelta time) const {
+  cost_model_.RecordImageDraw(image.pixel_count(), time);
 }
 
 void RasterCache::SweepAfterFrame() {
-  using PictureCache = PictureRasterCacheKey::Map<Entry>;
-  using LayerCache = LayerRasterCacheKey::Map<Entry>;
-  SweepOneCacheAfterFrame<PictureCache, PictureCache::iterator>(picture_cache_);
-  SweepOneCacheAfterFrame<LayerCache, LayerCache::iterator>(layer_cache_);
+  cost_model_.SweepAfterFrame();
+  SweepOneCacheAfterFrame(picture_cache_, max_unused_frames_);
+  SweepOneCacheAfterFrame(layer_cache_, 0);
+  EvictToBudget(true);
+
+  FML_TRACE_COUNTER("flutter", "RasterCacheResidentBytes", resident_bytes_);
+}
+
+void RasterCache::EvictToBudget(bool evict_in_use) {
+  if (resident_bytes_ <= max_bytes_) {
+    return;
+  }
+
+  struct Candidate {
+    uint64_t last_access;
+    PictureCache::iterator picture;
+    LayerCache::iterator layer;
+  };
+
+  std::vector<Candidate> candidates;
+  for (auto it = picture_cache_.begin(); it != picture_cache_.end(); ++it) {
+    if (it->second.image.is_valid() &&
+        (evict_in_use || !it->second.used_this_frame)) {
+      candidates.push_back({it->second.last_access, it, layer_cache_.end()});
+    }
+  }
+  for (auto it = layer_cache_.begin(); it != layer_cache_.end(); ++it) {
+    if (it->second.image.is_valid() &&
+        (evict_in_use || !it->second.used_this_frame)) {
+      candidates.push_back({it->second.last_access, picture_cache_.end(), it});
+    }
+  }
+
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Candidate& a, const Candidate& b) {
+              return a.last_access < b.last_access;
+            });
+
+  for (const auto& candidate : candidates) {
+    if (resident_bytes_ <= max_bytes_) {
+      break;
+    }
+    if (candidate.picture != picture_cache_.end()) {
+      EvictEntry(picture_cache_, candidate.picture);
+    } else {
+      EvictEntry(layer_cache_, candidate.layer);
+    }
+  }
+}
+
+void RasterCache::SetMaxBytes(size_t max_bytes) {
+  max_bytes_ = max_bytes;
+  EvictToBudget(true);
 }
 
 void RasterCache::Clear() {
+  candidates_.clear();
   picture_cache_.clear();
   layer_cache_.clear();
+  resident_bytes_ = 0;
+}
+
+void RasterCache::SetRasterizationTaskRunner(
+    fml::RefPtr<fml::TaskRunner> task_runner) {
+  rasterization_task_runner_ = std::move(task_runner);
+}
+
+void RasterCache::SetPopulationBudget(const PopulationBudget& budget) {
+  population_budget_ = budget;
 }
 
 void RasterCache::SetCheckboardCacheImages(bool checkerboard) {
@@ -5,13 +5,21 @@
 #ifndef FLUTTER_FLOW_RASTER_CACHE_H_
 #define FLUTTER_FLOW_RASTER_CACHE_H_
 
+#include <atomic>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/flow/instrumentation.h"
+#include "flutter/flow/raster_cache_cost_model.h"
 #include "flutter/flow/raster_cache_key.h"
+#include "flutter/fml/logging.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/fml/task_runner.h"
+#include "flutter/fml/time/time_delta.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkSize.h"
 
@@ -33,6 +41,11 @@ class RasterCacheResult {
 
   void draw(SkCanvas& canvas, const SkPaint* paint = nullptr) const;
 
+  // The memory used by the image.
+  size_t image_bytes() const;
+
+  int64_t pixel_count() const;
+
  private:
   sk_sp<SkImage> image_;
   SkRect logical_rect_;
@@ -42,7 +55,31 @@ struct PrerollContext;
 
 class RasterCache {
  public:
-  explicit RasterCache(size_t threshold = 3);
+  // The default limit on the memory used by cached images. Once exceeded, the
+  // least recently used images are evicted.
+  static constexpr size_t kDefaultMaxBytes = 64 * 1024 * 1024;
+
+  // The default number of consecutive frames a picture entry may go unused
+  // before it is evicted. Layer entries are keyed by the address of the layer,
+  // which a new layer may reuse once the old one is freed. So they are
+  // evicted after the first frame they go unused in.
+  static constexpr size_t kDefaultMaxUnusedFrames = 3;
+
+  // Limits the work spent on rasterizing new entries in a single frame.
+  // Entries that do not fit are deferred to later frames.
+  struct PopulationBudget {
+    fml::TimeDelta max_time = fml::TimeDelta::Max();
+    int64_t max_pixels = std::numeric_limits<int64_t>::max();
+
+    bool is_unlimited() const {
+      return max_time == fml::TimeDelta::Max() &&
+             max_pixels == std::numeric_limits<int64_t>::max();
+    }
+  };
+
+  explicit RasterCache(size_t threshold = 3,
+                       size_t max_bytes = kDefaultMaxBytes,
+                       size_t max_unused_frames = kDefaultMaxUnusedFrames);
 
   ~RasterCache();
 
@@ -64,9 +101,12 @@ class RasterCache {
   // Return true if the cache is generated.
   //
   // We may return false and not generate the cache if
-  // 1. The picture is not worth rasterizing
+  // 1. The picture is not worth rasterizing according to the cost model
   // 2. The matrix is singular
   // 3. The picture is accessed too few times
+  // 4. The picture is still being rasterized on the rasterization task runner
+  // 5. The cache has a population budget. The picture is then rasterized by
+  //    |PopulateCandidates| if it fits in the budget of the frame.
   bool Prepare(GrContext* context,
                SkPicture* picture,
                const SkMatrix& transformation_matrix,
@@ -74,45 +114,190 @@ class RasterCache {
                bool is_complex,
                bool will_change);
 
+  // Rasterizes |layer| once it was prepared in |threshold| frames.
   void Prepare(PrerollContext* context, Layer* layer, const SkMatrix& ctm);
 
+  // Rasterizes the entries prepared during this preroll that are missing an
+  // image, most valuable first, till the population budget is exhausted. At
+  // least one entry is rasterized per frame so that large entries still make
+  // progress. The rest are deferred and gain priority with every frame they
+  // wait. Must be called before the prerolled tree is painted. Does nothing
+  // without a population budget since entries are rasterized as soon as they
+  // are prepared then.
+  void PopulateCandidates();
+
   RasterCacheResult Get(const SkPicture& picture, const SkMatrix& ctm) const;
   RasterCacheResult Get(Layer* layer, const SkMatrix& ctm) const;
 
+  // Whether |Get| would return a valid image. Unlike |Get|, not counted as a
+  // cache hit or miss.
+  bool HasImage(Layer* layer, const SkMatrix& ctm) const;
+
   void SweepAfterFrame();
 
   void Clear();
 
   void SetCheckboardCacheImages(bool checkerboard);
 
+  // Pictures prepared without a GrContext are rasterized on |task_runner|
+  // instead of during preroll. Until their image is ready, the frames that
+  // use them keep drawing the pictures directly. Layers are always rasterized
+  // during preroll since they may not be painted on other threads. Pass
+  // nullptr to rasterize everything during preroll again.
+  void SetRasterizationTaskRunner(fml::RefPtr<fml::TaskRunner> task_runner);
+
+  void SetPopulationBudget(const PopulationBudget& budget);
+
+  const PopulationBudget& population_budget() const {
+    return population_budget_;
+  }
+
+  // Sets the limit on the memory used by cached images. Entries are evicted
+  // immediately if necessary.
+  void SetMaxBytes(size_t max_bytes);
+
+  size_t max_bytes() const { return max_bytes_; }
+
+  // The memory currently used by cached images.
+  size_t resident_bytes() const { return resident_bytes_; }
+
+  size_t picture_count() const { return picture_cache_.size(); }
+
+  size_t layer_count() const { return layer_cache_.size(); }
+
+  // The number of times a prepared entry had a cached image when asked for.
+  const Counter& hit_count() const { return hit_count_; }
+
+  // The number of times a prepared entry had no cached image when asked for.
+  const Counter& miss_count() const { return miss_count_; }
+
+  // The number of cached images evicted because they went unused or the cache
+  // ran out of memory.
+  const Counter& eviction_count() const { return eviction_count_; }
+
+  // The number of times an entry was not rasterized in a frame because the
+  // population budget was exhausted.
+  const Counter& deferral_count() const { return deferral_count_; }
+
+  // Feeds the time it took to paint a picture directly or from the cache back
+  // into the cost model. Only meaningful for software draws. On the GPU
+  // backends, painting only records draw commands and the model keeps its
+  // static weights.
+  void RecordPicturePlayback(const SkPicture& picture,
+                             fml::TimeDelta time) const;
+
+  void RecordImageDraw(const RasterCacheResult& image,
+                       fml::TimeDelta time) const;
+
+  // Whether |picture| only blends with srcOver. See
+  // |RasterCacheCostModel::BlendsOnlySrcOver|.
+  bool BlendsOnlySrcOver(const SkPicture& picture) const;
+
+  const RasterCacheCostModel& cost_model() const { return cost_model_; }
+
  private:
+  struct AsyncResult {
+    std::atomic<bool> ready{false};
+    RasterCacheResult image;
+  };
+
   struct Entry {
     bool used_this_frame = false;
     size_t access_count = 0;
+    size_t unused_frames = 0;
+    // The value of |access_sequence_| when the entry was last prepared.
+    uint64_t last_access = 0;
+    size_t image_bytes = 0;
+    // The number of frames the entry was deferred for by the population
+    // budget.
+    size_t deferred_frames = 0;
     RasterCacheResult image;
+    // Set while the image is being rasterized on the rasterization task
+    // runner. The task gives up if the entry is evicted in the meantime.
+    std::shared_ptr<AsyncResult> pending;
   };
 
-  template <class Cache, class Iterator>
-  static void SweepOneCacheAfterFrame(Cache& cache) {
-    std::vector<Iterator> dead;
+  using PictureCache = PictureRasterCacheKey::Map<Entry>;
+  using LayerCache = LayerRasterCacheKey::Map<Entry>;
 
-    for (auto it = cache.begin(); it != cache.end(); ++it) {
+  // An entry prepared this frame that is waiting for |PopulateCandidates|.
+  // Entries are never erased during preroll, so the pointer stays valid.
+  struct Candidate {
+    Entry* entry;
+    double priority;
+    int64_t pixels;
+    std::function<RasterCacheResult()> rasterize;
+  };
+
+  template <class Cache>
+  void SweepOneCacheAfterFrame(Cache& cache, size_t max_unused_frames) {
+    for (auto it = cache.begin(); it != cache.end();) {
       Entry& entry = it->second;
-      if (!entry.used_this_frame) {
-        dead.push_back(it);
+      if (entry.used_this_frame) {
+        entry.unused_frames = 0;
+      } else if (++entry.unused_frames > max_unused_frames) {
+        it = EvictEntry(cache, it);
+        continue;
       }
       entry.used_this_frame = false;
+      ++it;
     }
+  }
 
-    for (auto it : dead) {
-      cache.erase(it);
+  template <class Cache>
+  typename Cache::iterator EvictEntry(Cache& cache,
+                                      typename Cache::iterator it) {
+    if (it->second.image.is_valid()) {
+      FML_DCHECK(resident_bytes_ >= it->second.image_bytes);
+      resident_bytes_ -= it->second.image_bytes;
+      eviction_count_.Increment();
     }
+    return cache.erase(it);
   }
 
+  void Touch(Entry& entry);
+
+  void SetEntryImage(Entry& entry, RasterCacheResult image);
+
+  // Rasterizes the entry right away without a population budget. Otherwise,
+  // queues it for |PopulateCandidates|.
+  void PopulateOrDefer(Entry& entry,
+                       const SkIRect& device_bounds,
+                       fml::TimeDelta playback_time,
+                       std::function<RasterCacheResult()> rasterize);
+
+  // Evicts the least recently used images till the cache fits its budget.
+  // Entries used in the current frame are only evicted if |evict_in_use|.
+  void EvictToBudget(bool evict_in_use);
+
+  // Starts rasterizing the picture of |entry| on the rasterization task runner
+  // or adopts the image once it is ready. Returns true if the entry has an
+  // image.
+  bool PrepareAsync(Entry& entry,
+                    SkPicture* picture,
+                    const SkMatrix& ctm,
+                    SkColorSpace* dst_color_space);
+
+  RasterCacheResult GetEntryImage(const Entry* entry) const;
+
   const size_t threshold_;
-  PictureRasterCacheKey::Map<Entry> picture_cache_;
-  LayerRasterCacheKey::Map<Entry> layer_cache_;
+  size_t max_bytes_;
+  const size_t max_unused_frames_;
+  size_t resident_bytes_;
+  uint64_t access_sequence_;
+  PictureCache picture_cache_;
+  LayerCache layer_cache_;
   bool checkerboard_images_;
+  fml::RefPtr<fml::TaskRunner> rasterization_task_runner_;
+  PopulationBudget population_budget_;
+  std::vector<Candidate> candidates_;
+  // Mutable since measurements are recorded while painting and pictures are
+  // analyzed while optimizing.
+  mutable RasterCacheCostModel cost_model_;
+  mutable Counter hit_count_;
+  mutable Counter miss_count_;
+  Counter eviction_count_;
+  Counter deferral_count_;
   fml::WeakPtrFactory<RasterCache> weak_factory_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(RasterCache);
@@ -0,0 +1,355 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/raster_cache_cost_model.h"
+
+#include "flutter/fml/logging.h"
+#include "third_party/skia/include/core/SkPaint.h"
+#include "third_party/skia/include/utils/SkNoDrawCanvas.h"
+
+namespace flow {
+
+// Relative costs of the op classes. Blurs and save layers need offscreen
+// buffers. Paths need to be tessellated or scan converted. Text and images
+// need to be looked up in caches and sampled.
+static constexpr double kTextWeight = 4;
+static constexpr double kPathWeight = 8;
+static constexpr double kImageWeight = 4;
+static constexpr double kSaveLayerWeight = 16;
+static constexpr double kBlurWeight = 64;
+static constexpr double kOtherWeight = 1;
+
+// The initial estimates before anything was measured. Picked so that, like
+// the op count heuristic used before, a 100x100 image pays for a picture
+// with a couple dozen simple ops.
+static constexpr double kInitialNanosPerWeightedOp = 1000;
+static constexpr double kInitialNanosPerPixel = 1;
+
+// The weight of a new measurement in the moving averages.
+static constexpr double kMeasurementWeight = 0.2;
+
+static double Average(double average, double measurement) {
+  return average + kMeasurementWeight * (measurement - average);
+}
+
+namespace {
+
+class PictureOpCounter final : public SkNoDrawCanvas {
+ public:
+  explicit PictureOpCounter(const SkIRect& bounds) : SkNoDrawCanvas(bounds) {}
+
+  const PictureOpProfile& profile() const { return profile_; }
+
+ protected:
+  SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec& rec) override {
+    Count(rec.fPaint, &profile_.save_layers);
+    if (rec.fBackdrop != nullptr) {
+      profile_.blurs++;
+      profile_.non_src_over_blends++;
+    }
+    return kNoLayer_SaveLayerStrategy;
+  }
+
+  void onDrawTextRSXform(const void*,
+                         size_t,
+                         const SkRSXform[],
+                         const SkRect*,
+                         const SkPaint& paint) override {
+    Count(&paint, &profile_.text);
+  }
+
+  void onDrawTextBlob(const SkTextBlob*,
+                      SkScalar,
+                      SkScalar,
+                      const SkPaint& paint) override {
+    Count(&paint, &profile_.text);
+  }
+
+  void onDrawPath(const SkPath&, const SkPaint& paint) override {
+    Count(&paint, &profile_.paths);
+  }
+
+  void onDrawArc(const SkRect&,
+                 SkScalar,
+                 SkScalar,
+                 bool,
+                 const SkPaint& paint) override {
+    Count(&paint, &profile_.paths);
+  }
+
+  void onDrawRegion(const SkRegion&, const SkPaint& paint) override {
+    Count(&paint, &profile_.paths);
+  }
+
+  void onDrawDRRect(const SkRRect&,
+                    const SkRRect&,
+                    const SkPaint& paint) override {
+    Count(&paint, &profile_.paths);
+  }
+
+  void onDrawPatch(const SkPoint[12],
+                   const SkColor[4],
+                   const SkPoint[4],
+                   SkBlendMode,
+                   const SkPaint& paint) override {
+    Count(&paint, &profile_.paths);
+  }
+
+  void onDrawPoints(PointMode,
+                    size_t,
+                    const SkPoint[],
+                    const SkPaint& paint) override {
+    Count(&paint, &profile_.paths);
+  }
+
+  void onDrawVerticesObject(const SkVertices*,
+                            const SkVertices::Bone[],
+                            int,
+                            SkBlendMode,
+                            const SkPaint& paint) override {
+    Count(&paint, &profile_.paths);
+  }
+
+  void onDrawPaint(const SkPaint& paint) override {
+    Count(&paint, &profile_.other);
+  }
+
+  void onDrawRect(const SkRect&, const SkPaint& paint) override {
+    Count(&paint, &profile_.other);
+  }
+
+  void onDrawOval(const SkRect&, const SkPaint& paint) override {
+    Count(&paint, &profile_.other);
+  }
+
+  void onDrawRRect(const SkRRect&, const SkPaint& paint) override {
+    Count(&paint, &profile_.other);
+  }
+
+  void onDrawImage(const SkImage*,
+                   SkScalar,
+                   SkScalar,
+                   const SkPaint* paint) override {
+    Count(paint, &profile_.images);
+  }
+
+  void onDrawImageRect(const SkImage*,
+                       const SkRect*,
+                       const SkRect&,
+                       const SkPaint* paint,
+                       SrcRectConstraint) override {
+    Count(paint, &profile_.images);
+  }
+
+  void onDrawImageNine(const SkImage*,
+                       const SkIRect&,
+                       const SkRect&,
+                       const SkPaint* paint) override {
+    Count(paint, &profile_.images);
+  }
+
+  void onDrawImageLattice(const SkImage*,
+                          const Lattice&,
+                          const SkRect&,
+                          const SkPaint* paint) override {
+    Count(paint, &profile_.images);
+  }
+
+  void onDrawImageSet(const SkCanvas::ImageSetEntry[],
+                      int count,
+                      SkFilterQuality,
+                      SkBlendMode mode) override {
+    profile_.images += count;
+    if (mode != SkBlendMode::kSrcOver) {
+      profile_.non_src_over_blends++;
+    }
+  }
+
+  void onDrawBitmap(const SkBitmap&,
+                    SkScalar,
+                    SkScalar,
+                    const SkPaint* paint) override {
+    Count(paint, &profile_.images);
+  }
+
+  void onDrawBitmapRect(const SkBitmap&,
+                        const SkRect*,
+                        const SkRect&,
+                        const SkPaint* paint,
+                        SrcRectConstraint) override {
+    Count(paint, &profile_.images);
+  }
+
+  void onDrawBitmapNine(const SkBitmap&,
+                        const SkIRect&,
+                        const SkRect&,
+                        const SkPaint* paint) override {
+    Count(paint, &profile_.images);
+  }
+
+  void onDrawBitmapLattice(const SkBitmap&,
+                           const Lattice&,
+                           const SkRect&,
+                           const SkPaint* paint) override {
+    Count(paint, &profile_.images);
+  }
+
+  void onDrawAtlas(const SkImage*,
+                   const SkRSXform[],
+                   const SkRect[],
+                   const SkColor[],
+                   int count,
+                   SkBlendMode,
+                   const SkRect*,
+                   const SkPaint* paint) override {
+    Count(paint, &profile_.images);
+    profile_.images += count > 0 ? count - 1 : 0;
+  }
+
+  void onDrawShadowRec(const SkPath&, const SkDrawShadowRec&) override {
+    profile_.blurs++;
+  }
+
+  void onDrawDrawable(SkDrawable*, const SkMatrix*) override {
+    profile_.other++;
+  }
+
+  void onDrawPicture(const SkPicture* picture,
+                     const SkMatrix*,
+                     const SkPaint* paint) override {
+    if (paint != nullptr) {
+      Count(paint, &profile_.save_layers);
+    }
+    picture->playback(this);
+  }
+
+ private:
+  PictureOpProfile profile_;
+
+  void Count(const SkPaint* paint, int* counter) {
+    (*counter)++;
+    if (paint == nullptr) {
+      return;
+    }
+    if (paint->getMaskFilter() != nullptr ||
+        paint->getImageFilter() != nullptr) {
+      profile_.blurs++;
+    }
+    if (paint->getBlendMode() != SkBlendMode::kSrcOver) {
+      profile_.non_src_over_blends++;
+    }
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PictureOpCounter);
+};
+
+}  // namespace
+
+PictureOpProfile PictureOpProfile::Analyze(const SkPicture& picture) {
+  PictureOpCounter counter(picture.cullRect().roundOut());
+  picture.playback(&counter);
+  return counter.profile();
+}
+
+double PictureOpProfile::WeightedOpCount() const {
+  return text * kTextWeight + paths * kPathWeight + images * kImageWeight +
+         save_layers * kSaveLayerWeight + blurs * kBlurWeight +
+         other * kOtherWeight;
+}
+
+constexpr double RasterCacheCostModel::kMinSpeedup;
+constexpr size_t RasterCacheCostModel::kMaxUnusedFrames;
+
+RasterCacheCostModel::RasterCacheCostModel()
+    : nanos_per_weighted_op_(kInitialNanosPerWeightedOp),
+      nanos_per_pixel_(kInitialNanosPerPixel) {}
+
+RasterCacheCostModel::~RasterCacheCostModel() = default;
+
+RasterCacheCostModel::PictureStats& RasterCacheCostModel::GetStats(
+    const SkPicture& picture) {
+  auto found = pictures_.find(picture.uniqueID());
+  if (found != pictures_.end()) {
+    found->second.used_this_frame = true;
+    return found->second;
+  }
+  PictureStats& stats = pictures_[picture.uniqueID()];
+  const PictureOpProfile profile = PictureOpProfile::Analyze(picture);
+  stats.weighted_op_count = profile.WeightedOpCount();
+  stats.blends_only_src_over = profile.non_src_over_blends == 0;
+  return stats;
+}
+
+fml::TimeDelta RasterCacheCostModel::PredictPlaybackTime(
+    const SkPicture& picture) {
+  const PictureStats& stats = GetStats(picture);
+  if (stats.playback_nanos >= 0) {
+    return fml::TimeDelta::FromNanoseconds(stats.playback_nanos);
+  }
+  return PredictPlaybackTime(stats.weighted_op_count);
+}
+
+fml::TimeDelta RasterCacheCostModel::PredictPlaybackTime(
+    double weighted_op_count) const {
+  return fml::TimeDelta::FromNanoseconds(weighted_op_count *
+                                         nanos_per_weighted_op_);
+}
+
+fml::TimeDelta RasterCacheCostModel::PredictImageDrawTime(
+    int64_t pixels) const {
+  return fml::TimeDelta::FromNanoseconds(pixels * nanos_per_pixel_);
+}
+
+bool RasterCacheCostModel::IsWorthCaching(const SkPicture& picture,
+                                          int64_t pixels) {
+  const double playback = PredictPlaybackTime(picture).ToNanoseconds();
+  const double image_draw = PredictImageDrawTime(pixels).ToNanoseconds();
+  return playback > kMinSpeedup * image_draw;
+}
+
+bool RasterCacheCostModel::BlendsOnlySrcOver(const SkPicture& picture) {
+  return GetStats(picture).blends_only_src_over;
+}
+
+void RasterCacheCostModel::RecordPlayback(const SkPicture& picture,
+                                          fml::TimeDelta time) {
+  auto found = pictures_.find(picture.uniqueID());
+  if (found == pictures_.end()) {
+    return;
+  }
+  PictureStats& stats = found->second;
+  stats.used_this_frame = true;
+  const double nanos = time.ToNanoseconds();
+  stats.playback_nanos =
+      stats.playback_nanos < 0 ? nanos : Average(stats.playback_nanos, nanos);
+  if (stats.weighted_op_count > 0) {
+    nanos_per_weighted_op_ =
+        Average(nanos_per_weighted_op_, nanos / stats.weighted_op_count);
+  }
+}
+
+void RasterCacheCostModel::RecordImageDraw(int64_t pixels,
+                                           fml::TimeDelta time) {
+  if (pixels <= 0) {
+    return;
+  }
+  nanos_per_pixel_ = Average(
+      nanos_per_pixel_, static_cast<double>(time.ToNanoseconds()) / pixels);
+}
+
+void RasterCacheCostModel::SweepAfterFrame() {
+  for (auto it = pictures_.begin(); it != pictures_.end();) {
+    PictureStats& stats = it->second;
+    if (stats.used_this_frame) {
+      stats.unused_frames = 0;
+    } else if (++stats.unused_frames > kMaxUnusedFrames) {
+      it = pictures_.erase(it);
+      continue;
+    }
+    stats.used_this_frame = false;
+    ++it;
+  }
+}
+
+}  // namespace flow
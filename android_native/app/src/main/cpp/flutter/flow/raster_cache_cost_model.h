@@ -0,0 +1,114 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_RASTER_CACHE_COST_MODEL_H_
+#define FLUTTER_FLOW_RASTER_CACHE_COST_MODEL_H_
+
+#include <stdint.h>
+
+#include <unordered_map>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+#include "third_party/skia/include/core/SkPicture.h"
+
+namespace flow {
+
+// The number of ops of a picture by how expensive they usually are to
+// rasterize.
+struct PictureOpProfile {
+  int text = 0;
+  // Paths, arcs, regions and other geometry that needs to be tessellated or
+  // scan converted.
+  int paths = 0;
+  // Image and bitmap draws.
+  int images = 0;
+  int save_layers = 0;
+  // Draws with mask or image filters and shadows.
+  int blurs = 0;
+  int other = 0;
+  // Draws and save layers that blend with modes other than srcOver or read
+  // the destination. Not weighed by |WeightedOpCount|.
+  int non_src_over_blends = 0;
+
+  // Plays the picture back into a canvas that only counts ops. Nested
+  // pictures are counted as well.
+  static PictureOpProfile Analyze(const SkPicture& picture);
+
+  // The op counts weighted by their relative cost. A simple rect fill weighs
+  // one.
+  double WeightedOpCount() const;
+};
+
+// Predicts whether drawing a cached image of a picture is cheaper than
+// playing the picture back. Predictions start out from static weights per op
+// class and are refined with the playback and image draw times measured
+// during paint.
+class RasterCacheCostModel {
+ public:
+  // Drawing the cached image has to be at least this many times faster than
+  // playing back the picture to be worth the memory and rasterization.
+  static constexpr double kMinSpeedup = 2.0;
+
+  // The number of frames the statistics of a picture are kept without the
+  // picture being used.
+  static constexpr size_t kMaxUnusedFrames = 60;
+
+  RasterCacheCostModel();
+
+  ~RasterCacheCostModel();
+
+  // The predicted time to play back |picture| directly. Analyzes the picture
+  // on first use.
+  fml::TimeDelta PredictPlaybackTime(const SkPicture& picture);
+
+  // The predicted time to play back a picture of the given weight. See
+  // |PictureOpProfile::WeightedOpCount|.
+  fml::TimeDelta PredictPlaybackTime(double weighted_op_count) const;
+
+  // The predicted time to draw a cached image with the given number of
+  // pixels.
+  fml::TimeDelta PredictImageDrawTime(int64_t pixels) const;
+
+  bool IsWorthCaching(const SkPicture& picture, int64_t pixels);
+
+  // Whether everything in |picture| blends with srcOver. Analyzes the picture
+  // on first use.
+  bool BlendsOnlySrcOver(const SkPicture& picture);
+
+  // Records the time it took to play back a picture. Only pictures that were
+  // considered for caching are tracked.
+  void RecordPlayback(const SkPicture& picture, fml::TimeDelta time);
+
+  void RecordImageDraw(int64_t pixels, fml::TimeDelta time);
+
+  // Forgets the pictures unused for more than |kMaxUnusedFrames|.
+  void SweepAfterFrame();
+
+  size_t picture_count() const { return pictures_.size(); }
+
+ private:
+  struct PictureStats {
+    double weighted_op_count = 0;
+    bool blends_only_src_over = true;
+    // Exponential moving average of the measured playback times or negative
+    // if the picture was never measured.
+    double playback_nanos = -1;
+    size_t unused_frames = 0;
+    bool used_this_frame = true;
+  };
+
+  std::unordered_map<uint32_t, PictureStats> pictures_;
+  // Exponential moving averages over all measured pictures and cached images.
+  double nanos_per_weighted_op_;
+  double nanos_per_pixel_;
+
+  PictureStats& GetStats(const SkPicture& picture);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(RasterCacheCostModel);
+};
+
+}  // namespace flow
+
+#endif  // FLUTTER_FLOW_RASTER_CACHE_COST_MODEL_H_
@@ -0,0 +1,93 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/raster_cache_cost_model.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkMaskFilter.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+
+static sk_sp<SkPicture> GetRectsPicture(int count) {
+  SkPictureRecorder recorder;
+  recorder.beginRecording(SkRect::MakeWH(100, 100));
+  SkPaint paint;
+  for (int i = 0; i < count; i++) {
+    recorder.getRecordingCanvas()->drawRect(SkRect::MakeXYWH(i, i, 10, 10),
+                                            paint);
+  }
+  return recorder.finishRecordingAsPicture();
+}
+
+TEST(RasterCacheCostModel, AnalyzeClassifiesOps) {
+  SkPictureRecorder recorder;
+  SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 100));
+  SkPaint paint;
+  canvas->drawRect(SkRect::MakeWH(10, 10), paint);
+  SkPath path;
+  path.moveTo(0, 0);
+  path.quadTo(50, 100, 100, 0);
+  canvas->drawPath(path, paint);
+  canvas->saveLayer(nullptr, nullptr);
+  SkPaint blur;
+  blur.setMaskFilter(SkMaskFilter::MakeBlur(kNormal_SkBlurStyle, 4));
+  canvas->drawRect(SkRect::MakeWH(20, 20), blur);
+  canvas->restore();
+  auto picture = recorder.finishRecordingAsPicture();
+
+  auto profile = flow::PictureOpProfile::Analyze(*picture);
+  ASSERT_EQ(profile.other, 2);
+  ASSERT_EQ(profile.paths, 1);
+  ASSERT_EQ(profile.save_layers, 1);
+  ASSERT_EQ(profile.blurs, 1);
+  ASSERT_EQ(profile.text, 0);
+  ASSERT_EQ(profile.images, 0);
+  ASSERT_GT(profile.WeightedOpCount(), 4);
+}
+
+TEST(RasterCacheCostModel, OtherBlendModesAreDetected) {
+  flow::RasterCacheCostModel model;
+  ASSERT_TRUE(model.BlendsOnlySrcOver(*GetRectsPicture(2)));
+
+  SkPictureRecorder recorder;
+  SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(100, 100));
+  SkPaint paint;
+  canvas->drawRect(SkRect::MakeWH(10, 10), paint);
+  paint.setBlendMode(SkBlendMode::kSrc);
+  canvas->drawRect(SkRect::MakeWH(20, 20), paint);
+  auto picture = recorder.finishRecordingAsPicture();
+
+  ASSERT_EQ(flow::PictureOpProfile::Analyze(*picture).non_src_over_blends, 1);
+  ASSERT_FALSE(model.BlendsOnlySrcOver(*picture));
+}
+
+TEST(RasterCacheCostModel, TrivialPicturesAreNotWorthCaching) {
+  flow::RasterCacheCostModel model;
+  ASSERT_FALSE(model.IsWorthCaching(*GetRectsPicture(1), 100 * 100));
+  ASSERT_TRUE(model.IsWorthCaching(*GetRectsPicture(100), 100 * 100));
+}
+
+TEST(RasterCacheCostModel, MeasurementsOverridePredictions) {
+  flow::RasterCacheCostModel model;
+  auto picture = GetRectsPicture(100);
+  ASSERT_TRUE(model.IsWorthCaching(*picture, 100 * 100));
+
+  // The picture turns out to be cheap to play back.
+  model.RecordPlayback(*picture, fml::TimeDelta::FromMicroseconds(1));
+  ASSERT_EQ(model.PredictPlaybackTime(*picture),
+            fml::TimeDelta::FromMicroseconds(1));
+  ASSERT_FALSE(model.IsWorthCaching(*picture, 100 * 100));
+}
+
+TEST(RasterCacheCostModel, SweepForgetsUnusedPictures) {
+  flow::RasterCacheCostModel model;
+  auto picture = GetRectsPicture(1);
+  model.PredictPlaybackTime(*picture);
+  ASSERT_EQ(model.picture_count(), 1u);
+  for (size_t i = 0; i <= flow::RasterCacheCostModel::kMaxUnusedFrames + 1;
+       i++) {
+    model.SweepAfterFrame();
+  }
+  ASSERT_EQ(model.picture_count(), 0u);
+}
@@ -5,6 +5,7 @@
 #ifndef FLUTTER_FLOW_RASTER_CACHE_KEY_H_
 #define FLUTTER_FLOW_RASTER_CACHE_KEY_H_
 
+#include <functional>
 #include <unordered_map>
 #include "flutter/flow/matrix_decomposition.h"
 #include "flutter/fml/logging.h"
@@ -29,8 +30,15 @@ class RasterCacheKey {
   const SkMatrix& matrix() const { return matrix_; }
 
   struct Hash {
-    uint32_t operator()(RasterCacheKey const& key) const {
-      return std::hash<ID>()(key.id_);
+    std::size_t operator()(RasterCacheKey const& key) const {
+      // The same picture is frequently cached at multiple scales. So the
+      // matrix must be part of the hash to keep those out of the same bucket.
+      std::size_t hash = std::hash<ID>()(key.id_);
+      for (int i = 0; i < 9; i++) {
+        hash ^= std::hash<SkScalar>()(key.matrix_[i]) + 0x9e3779b9 +
+                (hash << 6) + (hash >> 2);
+      }
+      return hash;
     }
   };
 
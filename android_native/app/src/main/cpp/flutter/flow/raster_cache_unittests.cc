@@ -3,6 +3,10 @@
 // found in the LICENSE file.
 
 #include "flutter/flow/raster_cache.h"
+#include "flutter/flow/compositor_context.h"
+#include "flutter/flow/layers/layer.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
 #include "gtest/gtest.h"
 #include "third_party/skia/include/core/SkPicture.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
@@ -89,7 +93,212 @@ TEST(RasterCache, SweepsRemoveUnusedFrames) {
   ASSERT_TRUE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
                             false));  // 4
   cache.SweepAfterFrame();
-  cache.SweepAfterFrame();  // Extra frame without a preroll image access.
+  // Extra frames without a preroll image access.
+  for (size_t i = 0; i <= flow::RasterCache::kDefaultMaxUnusedFrames; i++) {
+    cache.SweepAfterFrame();
+  }
   ASSERT_FALSE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
                              false));  // 5
 }
+
+TEST(RasterCache, EntriesSurviveFewUnusedFrames) {
+  size_t threshold = 1;
+  flow::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_TRUE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
+                            false));
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();  // Extra frame without a preroll image access.
+  ASSERT_TRUE(cache.Get(*picture, matrix).is_valid());
+  ASSERT_EQ(cache.hit_count().count(), 1u);
+  ASSERT_EQ(cache.eviction_count().count(), 0u);
+}
+
+TEST(RasterCache, FramesThatAreNotPresentedDoNotSweep) {
+  flow::CompositorContext compositor_context;
+  flow::RasterCache& cache = compositor_context.raster_cache();
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  bool prepared = false;
+  while (!prepared) {
+    auto frame = compositor_context.AcquireFrame(nullptr, nullptr, nullptr,
+                                                 matrix, false);
+    prepared = cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
+                             false);
+  }
+  ASSERT_TRUE(cache.Get(*picture, matrix).is_valid());
+
+  // Like screenshots, which rasterize without the cache.
+  for (size_t i = 0; i <= flow::RasterCache::kDefaultMaxUnusedFrames; i++) {
+    compositor_context.AcquireFrame(nullptr, nullptr, nullptr, matrix, false,
+                                    false);
+  }
+  ASSERT_TRUE(cache.Get(*picture, matrix).is_valid());
+  ASSERT_EQ(cache.eviction_count().count(), 0u);
+}
+
+TEST(RasterCache, CountsHitsAndMisses) {
+  size_t threshold = 2;
+  flow::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
+                             false));
+  ASSERT_FALSE(cache.Get(*picture, matrix).is_valid());
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
+                            false));
+  ASSERT_TRUE(cache.Get(*picture, matrix).is_valid());
+  ASSERT_EQ(cache.hit_count().count(), 1u);
+  ASSERT_EQ(cache.miss_count().count(), 1u);
+  ASSERT_EQ(cache.picture_count(), 1u);
+  ASSERT_GT(cache.resident_bytes(), 0u);
+}
+
+TEST(RasterCache, EvictsLeastRecentlyUsedEntriesOverBudget) {
+  size_t threshold = 1;
+  // Room for exactly one 150x100 N32 image.
+  flow::RasterCache cache(threshold, 150 * 100 * 4);
+
+  SkMatrix matrix = SkMatrix::I();
+  SkMatrix scaled = SkMatrix::MakeScale(0.5, 0.5);
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_TRUE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
+                            false));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(cache.Prepare(NULL, picture.get(), scaled, srgb.get(), true,
+                            false));
+  cache.SweepAfterFrame();
+  ASSERT_EQ(cache.eviction_count().count(), 1u);
+  ASSERT_FALSE(cache.Get(*picture, matrix).is_valid());
+  ASSERT_TRUE(cache.Get(*picture, scaled).is_valid());
+  ASSERT_LE(cache.resident_bytes(), cache.max_bytes());
+}
+
+TEST(RasterCache, PicturesAreRasterizedOnTheRasterizationTaskRunner) {
+  size_t threshold = 1;
+  flow::RasterCache cache(threshold);
+  fml::Thread thread("rasterization");
+  cache.SetRasterizationTaskRunner(thread.GetTaskRunner());
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  // The first frame only kicks off the rasterization.
+  ASSERT_FALSE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
+                             false));
+  ASSERT_FALSE(cache.Get(*picture, matrix).is_valid());
+  cache.SweepAfterFrame();
+
+  // Wait for the task to finish. The next frame adopts the image.
+  fml::AutoResetWaitableEvent latch;
+  thread.GetTaskRunner()->PostTask([&latch]() { latch.Signal(); });
+  latch.Wait();
+
+  ASSERT_TRUE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
+                            false));
+  ASSERT_TRUE(cache.Get(*picture, matrix).is_valid());
+  ASSERT_GT(cache.resident_bytes(), 0u);
+}
+
+TEST(RasterCache, PopulationBudgetDefersEntries) {
+  size_t threshold = 1;
+  flow::RasterCache cache(threshold);
+  flow::RasterCache::PopulationBudget budget;
+  // Room for one 150x100 image per frame.
+  budget.max_pixels = 150 * 100;
+  cache.SetPopulationBudget(budget);
+
+  SkMatrix matrix = SkMatrix::I();
+  SkMatrix scaled = SkMatrix::MakeScale(0.5, 0.5);
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  // Entries are only populated once all candidates of the frame are known.
+  ASSERT_FALSE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
+                             false));
+  ASSERT_FALSE(cache.Prepare(NULL, picture.get(), scaled, srgb.get(), true,
+                             false));
+  cache.PopulateCandidates();
+  // The larger image is worth more and goes first.
+  ASSERT_TRUE(cache.Get(*picture, matrix).is_valid());
+  ASSERT_FALSE(cache.Get(*picture, scaled).is_valid());
+  ASSERT_EQ(cache.deferral_count().count(), 1u);
+  cache.SweepAfterFrame();
+
+  // The deferred entry is carried over to the next frame.
+  ASSERT_TRUE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
+                            false));
+  ASSERT_FALSE(cache.Prepare(NULL, picture.get(), scaled, srgb.get(), true,
+                             false));
+  cache.PopulateCandidates();
+  ASSERT_TRUE(cache.Get(*picture, scaled).is_valid());
+  ASSERT_EQ(cache.deferral_count().count(), 1u);
+}
+
+namespace {
+
+class RectLayer : public flow::Layer {
+ public:
+  void Preroll(flow::PrerollContext* context,
+               const SkMatrix& matrix) override {
+    set_paint_bounds(SkRect::MakeWH(10, 10));
+  }
+
+  void Paint(PaintContext& context) const override {
+    context.leaf_nodes_canvas->drawRect(paint_bounds(), SkPaint());
+  }
+
+  const char* type_name() const override { return "RectLayer"; }
+};
+
+}  // namespace
+
+TEST(RasterCache, LayersAreOnlyCachedOnceTheThresholdIsReached) {
+  size_t threshold = 2;
+  flow::RasterCache cache(threshold);
+  flow::Stopwatch stopwatch;
+  flow::TextureRegistry texture_registry;
+  flow::PrerollContext context = {
+      &cache,               // raster_cache
+      nullptr,              // gr_context
+      nullptr,              // view_embedder
+      nullptr,              // dst_color_space
+      SkRect::MakeEmpty(),  // child_paint_bounds
+      stopwatch,            // frame_time
+      stopwatch,            // engine_time
+      texture_registry,     // texture_registry
+      false,                // checkerboard_offscreen_layers
+      nullptr,              // layer_profile
+  };
+
+  auto layer = std::make_shared<RectLayer>();
+  layer->Preroll(&context, SkMatrix::I());
+
+  const SkMatrix matrix = SkMatrix::I();
+  cache.Prepare(&context, layer.get(), matrix);
+  ASSERT_FALSE(cache.HasImage(layer.get(), matrix));
+  cache.SweepAfterFrame();
+  cache.Prepare(&context, layer.get(), matrix);
+  ASSERT_TRUE(cache.HasImage(layer.get(), matrix));
+  ASSERT_GT(cache.resident_bytes(), 0u);
+}
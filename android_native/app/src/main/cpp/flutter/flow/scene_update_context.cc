@@ -194,7 +194,8 @@ SceneUpdateContext::ExecutePaintTasks(CompositorContext::ScopedFrame& frame) {
                                    frame.context().engine_time(),
                                    frame.context().texture_registry(),
                                    &frame.context().raster_cache(),
-                                   false};
+                                   false,
+                                   nullptr};
     canvas->restoreToCount(1);
     canvas->save();
     canvas->clear(task.background_color);
@@ -23,22 +23,28 @@ void SkiaUnrefQueue::Unref(SkRefCnt* object) {
   objects_.push_back(object);
   if (!drain_pending_) {
     drain_pending_ = true;
-    task_runner_->PostDelayedTask(
+    drain_task_ = task_runner_->PostDelayedTask(
         [strong = fml::Ref(this)]() { strong->Drain(); }, drain_delay_);
   }
 }
 
 void SkiaUnrefQueue::Drain() {
   std::deque<SkRefCnt*> skia_objects;
+  fml::TaskHandle drain_task;
   {
     std::lock_guard<std::mutex> lock(mutex_);
     objects_.swap(skia_objects);
     drain_pending_ = false;
+    drain_task = std::move(drain_task_);
   }
 
   for (SkRefCnt* skia_object : skia_objects) {
     skia_object->unref();
   }
+
+  // A pending drain has nothing left to do. The task holds a reference to the
+  // queue, so this may collect the queue and must come last.
+  drain_task.Cancel();
 }
 
 }  // namespace flow
@@ -7,10 +7,16 @@
 
 #include <functional>
 
+#include "flutter/fml/unique_function.h"
+
 namespace fml {
 
 using closure = std::function<void()>;
 
+// The type of posted tasks. Unlike |closure|, it is move-only and does not
+// allocate for small captures.
+using unique_closure = UniqueFunction<void()>;
+
 }  // namespace fml
 
 #endif  // FLUTTER_FML_CLOSURE_H_
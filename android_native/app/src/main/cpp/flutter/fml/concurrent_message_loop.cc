@@ -0,0 +1,285 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/concurrent_message_loop.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/message_loop_impl.h"
+#include "flutter/fml/thread.h"
+#include "flutter/fml/thread_local.h"
+#include "flutter/fml/trace_event.h"
+
+namespace fml {
+
+// The loop whose worker runs on the current thread, if any.
+FML_THREAD_LOCAL ThreadLocal tls_worker_loop;
+
+std::shared_ptr<ConcurrentMessageLoop> ConcurrentMessageLoop::Create(
+    size_t worker_count) {
+  // The constructor is private. So std::make_shared cannot be used.
+  auto loop = std::shared_ptr<ConcurrentMessageLoop>(
+      new ConcurrentMessageLoop(std::max<size_t>(worker_count, 1)));
+  loop->task_runner_ = fml::MakeRefCounted<ConcurrentTaskRunner>(loop);
+  return loop;
+}
+
+ConcurrentMessageLoop::ConcurrentMessageLoop(size_t worker_count)
+    : pending_tasks_(0),
+      idle_workers_(0),
+      next_worker_(0),
+      next_delayed_task_time_(
+          fml::TimePoint::Max().ToEpochDelta().ToNanoseconds()) {
+  // All workers have to exist before any of them looks for tasks to steal.
+  for (size_t i = 0; i < worker_count; i++) {
+    workers_.emplace_back(std::make_unique<Worker>());
+  }
+  for (size_t i = 0; i < worker_count; i++) {
+    workers_[i]->thread = std::thread([this, i]() {
+      Thread::SetCurrentThreadName("io.flutter.worker." + std::to_string(i));
+      tls_worker_loop.Set(reinterpret_cast<intptr_t>(this));
+      WorkerMain(i);
+    });
+  }
+}
+
+ConcurrentMessageLoop::~ConcurrentMessageLoop() {
+  FML_CHECK(!RunsTasksOnCurrentThread())
+      << "The concurrent message loop was collected on one of its workers.";
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  tasks_available_.notify_all();
+  for (auto& worker : workers_) {
+    worker->thread.join();
+  }
+}
+
+size_t ConcurrentMessageLoop::GetWorkerCount() const {
+  return workers_.size();
+}
+
+fml::RefPtr<ConcurrentTaskRunner> ConcurrentMessageLoop::GetTaskRunner() {
+  return task_runner_;
+}
+
+bool ConcurrentMessageLoop::RunsTasksOnCurrentThread() const {
+  return tls_worker_loop.Get() == reinterpret_cast<intptr_t>(this);
+}
+
+size_t ConcurrentMessageLoop::GetCurrentWorkerIndex() const {
+  const auto thread_id = std::this_thread::get_id();
+  for (size_t i = 0; i < workers_.size(); i++) {
+    if (workers_[i]->thread.get_id() == thread_id) {
+      return i;
+    }
+  }
+  return workers_.size();
+}
+
+void ConcurrentMessageLoop::PostTask(fml::unique_closure task) {
+  FML_DCHECK(task != nullptr);
+  size_t worker_index = GetCurrentWorkerIndex();
+  if (worker_index == workers_.size()) {
+    worker_index = next_worker_++ % workers_.size();
+  }
+  PushTask(worker_index, std::move(task));
+}
+
+void ConcurrentMessageLoop::PostTaskForTime(fml::unique_closure task,
+                                            fml::TimePoint target_time) {
+  if (target_time <= fml::TimePoint::Now()) {
+    PostTask(std::move(task));
+    return;
+  }
+
+  FML_DCHECK(task != nullptr);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    delayed_tasks_.push({++delayed_task_order_, std::move(task), target_time});
+    next_delayed_task_time_ =
+        delayed_tasks_.top().target_time.ToEpochDelta().ToNanoseconds();
+  }
+  // A sleeping worker has to wait for the new deadline instead.
+  tasks_available_.notify_one();
+}
+
+void ConcurrentMessageLoop::EnqueueTask(size_t worker_index,
+                                        fml::unique_closure task) {
+  auto& worker = *workers_[worker_index];
+  std::lock_guard<std::mutex> lock(worker.tasks_mutex);
+  worker.tasks.emplace_back(std::move(task));
+  pending_tasks_++;
+}
+
+void ConcurrentMessageLoop::PushTask(size_t worker_index,
+                                     fml::unique_closure task) {
+  EnqueueTask(worker_index, std::move(task));
+
+  // A worker that goes to sleep increments |idle_workers_| before it checks
+  // |pending_tasks_|. So either it sees the task or it is woken up here.
+  if (idle_workers_ > 0) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_available_.notify_one();
+  }
+}
+
+bool ConcurrentMessageLoop::TakeTask(size_t worker_index,
+                                     fml::unique_closure* task) {
+  {
+    auto& worker = *workers_[worker_index];
+    std::lock_guard<std::mutex> lock(worker.tasks_mutex);
+    if (!worker.tasks.empty()) {
+      *task = std::move(worker.tasks.back());
+      worker.tasks.pop_back();
+      pending_tasks_--;
+      return true;
+    }
+  }
+
+  for (size_t i = 1; i < workers_.size(); i++) {
+    auto& victim = *workers_[(worker_index + i) % workers_.size()];
+    std::lock_guard<std::mutex> lock(victim.tasks_mutex);
+    if (!victim.tasks.empty()) {
+      *task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      pending_tasks_--;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void ConcurrentMessageLoop::PushExpiredDelayedTasksLocked(
+    size_t worker_index) {
+  const auto now = fml::TimePoint::Now();
+  bool pushed = false;
+  while (!delayed_tasks_.empty() &&
+         delayed_tasks_.top().target_time <= now) {
+    // The heap only hands out const references to its top.
+    EnqueueTask(worker_index,
+                std::move(const_cast<DelayedTask&>(delayed_tasks_.top()).task));
+    delayed_tasks_.pop();
+    pushed = true;
+  }
+  if (pushed && idle_workers_ > 0) {
+    tasks_available_.notify_all();
+  }
+  next_delayed_task_time_ =
+      (delayed_tasks_.empty() ? fml::TimePoint::Max()
+                              : delayed_tasks_.top().target_time)
+          .ToEpochDelta()
+          .ToNanoseconds();
+}
+
+void ConcurrentMessageLoop::WorkerMain(size_t worker_index) {
+  while (true) {
+    if (fml::TimePoint::Now().ToEpochDelta().ToNanoseconds() >=
+        next_delayed_task_time_) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      PushExpiredDelayedTasksLocked(worker_index);
+    }
+
+    fml::unique_closure task;
+    if (TakeTask(worker_index, &task)) {
+      TRACE_EVENT0("fml", "ConcurrentWorkerTask");
+      task();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_workers_++;
+    while (pending_tasks_ == 0 && !shutdown_) {
+      const auto next_delayed_task_time = fml::TimePoint::FromEpochDelta(
+          fml::TimeDelta::FromNanoseconds(next_delayed_task_time_));
+      if (next_delayed_task_time == fml::TimePoint::Max()) {
+        tasks_available_.wait(lock);
+      } else {
+        const auto now = fml::TimePoint::Now();
+        if (next_delayed_task_time <= now) {
+          PushExpiredDelayedTasksLocked(worker_index);
+          continue;
+        }
+        tasks_available_.wait_for(
+            lock, std::chrono::nanoseconds(
+                      (next_delayed_task_time - now).ToNanoseconds()));
+      }
+    }
+    idle_workers_--;
+    if (pending_tasks_ == 0 && shutdown_) {
+      return;
+    }
+  }
+}
+
+ConcurrentTaskRunner::ConcurrentTaskRunner(
+    const std::shared_ptr<ConcurrentMessageLoop>& loop)
+    : TaskRunner(nullptr), loop_(loop.get()), weak_loop_(loop) {}
+
+ConcurrentTaskRunner::~ConcurrentTaskRunner() = default;
+
+ConcurrentMessageLoop* ConcurrentTaskRunner::GetLoopIfOnWorker() const {
+  return tls_worker_loop.Get() == reinterpret_cast<intptr_t>(loop_) ? loop_
+                                                                    : nullptr;
+}
+
+void ConcurrentTaskRunner::PostTask(fml::unique_closure task) {
+  if (auto* loop = GetLoopIfOnWorker()) {
+    loop->PostTask(std::move(task));
+    return;
+  }
+  if (auto loop = weak_loop_.lock()) {
+    loop->PostTask(std::move(task));
+    return;
+  }
+  FML_DLOG(WARNING) << "Dropped a task posted after the concurrent message "
+                       "loop was collected.";
+}
+
+TaskHandle ConcurrentTaskRunner::PostTaskForTime(fml::unique_closure task,
+                                                 fml::TimePoint target_time) {
+  if (auto* loop = GetLoopIfOnWorker()) {
+    loop->PostTaskForTime(std::move(task), target_time);
+    return {};
+  }
+  if (auto loop = weak_loop_.lock()) {
+    loop->PostTaskForTime(std::move(task), target_time);
+    return {};
+  }
+  FML_DLOG(WARNING) << "Dropped a task posted after the concurrent message "
+                       "loop was collected.";
+  return {};
+}
+
+TaskHandle ConcurrentTaskRunner::PostDelayedTask(fml::unique_closure task,
+                                                 fml::TimeDelta delay) {
+  return PostTaskForTime(std::move(task), fml::TimePoint::Now() + delay);
+}
+
+void ConcurrentTaskRunner::PostTask(fml::unique_closure task, TaskPriority) {
+  PostTask(std::move(task));
+}
+
+TaskHandle ConcurrentTaskRunner::PostTaskForTime(fml::unique_closure task,
+                                                 fml::TimePoint target_time,
+                                                 TaskPriority) {
+  return PostTaskForTime(std::move(task), target_time);
+}
+
+TaskHandle ConcurrentTaskRunner::PostDelayedTask(fml::unique_closure task,
+                                                 fml::TimeDelta delay,
+                                                 TaskPriority) {
+  return PostDelayedTask(std::move(task), delay);
+}
+
+bool ConcurrentTaskRunner::RunsTasksOnCurrentThread() {
+  return GetLoopIfOnWorker() != nullptr;
+}
+
+}  // namespace fml
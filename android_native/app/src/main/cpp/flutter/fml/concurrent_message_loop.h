@@ -0,0 +1,172 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
+#define FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "flutter/fml/closure.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/task_runner.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace fml {
+
+class ConcurrentTaskRunner;
+
+// Runs tasks on a fixed set of worker threads. Unlike |MessageLoop|, tasks are
+// not run in the order they were posted and may run concurrently with each
+// other.
+//
+// Every worker has its own deque of tasks. Tasks posted on a worker go to the
+// back of its deque and the worker runs the most recently posted task first.
+// Tasks posted on other threads are spread over the workers. A worker whose
+// deque is empty steals the oldest task of another worker before it sleeps.
+class ConcurrentMessageLoop
+    : public std::enable_shared_from_this<ConcurrentMessageLoop> {
+ public:
+  static std::shared_ptr<ConcurrentMessageLoop> Create(
+      size_t worker_count = std::thread::hardware_concurrency());
+
+  // Runs the tasks that are due and joins the workers. Delayed tasks that are
+  // not due yet are dropped.
+  ~ConcurrentMessageLoop();
+
+  size_t GetWorkerCount() const;
+
+  fml::RefPtr<ConcurrentTaskRunner> GetTaskRunner();
+
+  void PostTask(fml::unique_closure task);
+
+  void PostTaskForTime(fml::unique_closure task, fml::TimePoint target_time);
+
+  bool RunsTasksOnCurrentThread() const;
+
+ private:
+  struct Worker {
+    std::thread thread;
+    std::mutex tasks_mutex;
+    std::deque<fml::unique_closure> tasks;
+  };
+
+  struct DelayedTask {
+    size_t order;
+    fml::unique_closure task;
+    fml::TimePoint target_time;
+  };
+
+  struct DelayedTaskCompare {
+    bool operator()(const DelayedTask& a, const DelayedTask& b) {
+      return a.target_time == b.target_time ? a.order > b.order
+                                            : a.target_time > b.target_time;
+    }
+  };
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  fml::RefPtr<ConcurrentTaskRunner> task_runner_;
+  // The number of tasks in all worker deques. A worker only sleeps when it is
+  // zero.
+  std::atomic_size_t pending_tasks_;
+  std::atomic_size_t idle_workers_;
+  std::atomic_size_t next_worker_;
+  // When the next delayed task is due, in nanoseconds since the epoch. Lets
+  // busy workers check for due delayed tasks without taking |mutex_|.
+  std::atomic<int64_t> next_delayed_task_time_;
+
+  std::mutex mutex_;
+  std::condition_variable tasks_available_;
+  std::priority_queue<DelayedTask, std::vector<DelayedTask>, DelayedTaskCompare>
+      delayed_tasks_;
+  size_t delayed_task_order_ = 0;
+  bool shutdown_ = false;
+
+  explicit ConcurrentMessageLoop(size_t worker_count);
+
+  void WorkerMain(size_t worker_index);
+
+  // Returns the index of the worker running on the current thread or
+  // |workers_.size()| if this is not a worker thread.
+  size_t GetCurrentWorkerIndex() const;
+
+  // Adds the task to the deque of the worker without waking up any worker.
+  void EnqueueTask(size_t worker_index, fml::unique_closure task);
+
+  // Adds the task to the deque of the worker and wakes up a sleeping worker.
+  void PushTask(size_t worker_index, fml::unique_closure task);
+
+  // Takes the newest task of the worker or steals the oldest of another one.
+  bool TakeTask(size_t worker_index, fml::unique_closure* task);
+
+  // Moves the delayed tasks that are due to the deque of |worker_index|.
+  void PushExpiredDelayedTasksLocked(size_t worker_index);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ConcurrentMessageLoop);
+};
+
+// A task runner for the workers of a |ConcurrentMessageLoop|. Tasks posted
+// after the loop is collected are dropped. Task priorities are ignored and
+// delayed tasks cannot be cancelled, so the returned handles are empty.
+class ConcurrentTaskRunner : public TaskRunner {
+ public:
+  // |fml::TaskRunner|
+  void PostTask(fml::unique_closure task) override;
+
+  // |fml::TaskRunner|
+  TaskHandle PostTaskForTime(fml::unique_closure task,
+                             fml::TimePoint target_time) override;
+
+  // |fml::TaskRunner|
+  TaskHandle PostDelayedTask(fml::unique_closure task,
+                             fml::TimeDelta delay) override;
+
+  // |fml::TaskRunner|
+  void PostTask(fml::unique_closure task, TaskPriority priority) override;
+
+  // |fml::TaskRunner|
+  TaskHandle PostTaskForTime(fml::unique_closure task,
+                             fml::TimePoint target_time,
+                             TaskPriority priority) override;
+
+  // |fml::TaskRunner|
+  TaskHandle PostDelayedTask(fml::unique_closure task,
+                             fml::TimeDelta delay,
+                             TaskPriority priority) override;
+
+  // |fml::TaskRunner|
+  bool RunsTasksOnCurrentThread() override;
+
+ private:
+  friend class ConcurrentMessageLoop;
+
+  // Only compared against and dereferenced on the workers of the loop.
+  ConcurrentMessageLoop* const loop_;
+  std::weak_ptr<ConcurrentMessageLoop> weak_loop_;
+
+  explicit ConcurrentTaskRunner(
+      const std::shared_ptr<ConcurrentMessageLoop>& loop);
+
+  // Returns the loop if called on one of its workers. The loop cannot be
+  // collected while a worker runs a task since its destructor joins the
+  // workers. Locking |weak_loop_| on a worker instead could make the worker
+  // the last owner of the loop, which must not be collected on a worker.
+  ConcurrentMessageLoop* GetLoopIfOnWorker() const;
+
+  ~ConcurrentTaskRunner() override;
+
+  FML_FRIEND_MAKE_REF_COUNTED(ConcurrentTaskRunner);
+  FML_FRIEND_REF_COUNTED_THREAD_SAFE(ConcurrentTaskRunner);
+  FML_DISALLOW_COPY_AND_ASSIGN(ConcurrentTaskRunner);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
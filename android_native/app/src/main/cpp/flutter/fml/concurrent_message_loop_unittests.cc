@@ -0,0 +1,126 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <atomic>
+
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+
+TEST(ConcurrentMessageLoopTest, CanCreateAndCollect) {
+  auto loop = ConcurrentMessageLoop::Create(2);
+  ASSERT_EQ(loop->GetWorkerCount(), 2u);
+  ASSERT_TRUE(loop->GetTaskRunner());
+  ASSERT_FALSE(loop->GetTaskRunner()->RunsTasksOnCurrentThread());
+}
+
+TEST(ConcurrentMessageLoopTest, RunsAllTasks) {
+  auto loop = ConcurrentMessageLoop::Create(4);
+  auto runner = loop->GetTaskRunner();
+  const size_t count = 1000;
+  std::atomic_size_t tasks_run(0);
+  CountDownLatch latch(count);
+  for (size_t i = 0; i < count; i++) {
+    runner->PostTask([&tasks_run, &latch, runner]() {
+      ASSERT_TRUE(runner->RunsTasksOnCurrentThread());
+      tasks_run++;
+      latch.CountDown();
+    });
+  }
+  latch.Wait();
+  ASSERT_EQ(tasks_run, count);
+}
+
+TEST(ConcurrentMessageLoopTest, RunsTasksConcurrently) {
+  const size_t worker_count = 4;
+  auto loop = ConcurrentMessageLoop::Create(worker_count);
+  CountDownLatch all_running(worker_count);
+  CountDownLatch all_done(worker_count);
+  for (size_t i = 0; i < worker_count; i++) {
+    loop->PostTask([&all_running, &all_done]() {
+      // Only returns if every task runs on its own worker.
+      all_running.CountDown();
+      all_running.Wait();
+      all_done.CountDown();
+    });
+  }
+  all_done.Wait();
+}
+
+TEST(ConcurrentMessageLoopTest, IdleWorkersStealTasks) {
+  auto loop = ConcurrentMessageLoop::Create(2);
+  AutoResetWaitableEvent done;
+  loop->PostTask([&loop, &done]() {
+    // This goes to the deque of the blocked worker. So it only runs if the
+    // other worker steals it.
+    ManualResetWaitableEvent stolen;
+    loop->PostTask([&stolen]() { stolen.Signal(); });
+    stolen.Wait();
+    done.Signal();
+  });
+  done.Wait();
+}
+
+TEST(ConcurrentMessageLoopTest, RunsDelayedTasksWhenDue) {
+  auto loop = ConcurrentMessageLoop::Create(2);
+  const auto delay = fml::TimeDelta::FromMilliseconds(10);
+  const auto begin = fml::TimePoint::Now();
+  fml::TimePoint ran_at;
+  AutoResetWaitableEvent latch;
+  loop->GetTaskRunner()->PostDelayedTask(
+      [&ran_at, &latch]() {
+        ran_at = fml::TimePoint::Now();
+        latch.Signal();
+      },
+      delay);
+  latch.Wait();
+  ASSERT_GE(ran_at - begin, delay);
+}
+
+TEST(ConcurrentMessageLoopTest, RunsPendingTasksBeforeCollection) {
+  std::atomic_size_t tasks_run(0);
+  const size_t count = 100;
+  {
+    auto loop = ConcurrentMessageLoop::Create(2);
+    for (size_t i = 0; i < count; i++) {
+      loop->PostTask([&tasks_run]() { tasks_run++; });
+    }
+  }
+  ASSERT_EQ(tasks_run, count);
+}
+
+TEST(ConcurrentMessageLoopTest, WorkersPostToTheLoopWhileItIsCollected) {
+  // Tasks posting through the runner on a worker must neither own the loop
+  // nor lose their tasks when the last reference is released meanwhile.
+  for (size_t iteration = 0; iteration < 50; iteration++) {
+    std::atomic_size_t tasks_run(0);
+    const size_t count = 10;
+    {
+      auto loop = ConcurrentMessageLoop::Create(2);
+      fml::RefPtr<TaskRunner> runner = loop->GetTaskRunner();
+      for (size_t i = 0; i < count; i++) {
+        runner->PostTask([runner, &tasks_run]() {
+          ASSERT_TRUE(runner->RunsTasksOnCurrentThread());
+          runner->PostTask([&tasks_run]() { tasks_run++; });
+        });
+      }
+    }
+    ASSERT_EQ(tasks_run, count);
+  }
+}
+
+TEST(ConcurrentMessageLoopTest, RunnerDropsTasksAfterCollection) {
+  auto loop = ConcurrentMessageLoop::Create(1);
+  fml::RefPtr<TaskRunner> runner = loop->GetTaskRunner();
+  loop.reset();
+  bool ran = false;
+  runner->PostTask([&ran]() { ran = true; });
+  ASSERT_FALSE(ran);
+  ASSERT_FALSE(runner->RunsTasksOnCurrentThread());
+}
+
+}  // namespace fml
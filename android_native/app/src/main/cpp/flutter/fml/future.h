@@ -0,0 +1,328 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_FUTURE_H_
+#define FLUTTER_FML_FUTURE_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/ref_counted.h"
+#include "flutter/fml/memory/ref_ptr.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/task_runner.h"
+#include "flutter/fml/unique_function.h"
+
+namespace fml {
+
+template <typename T>
+class Future;
+
+template <typename T>
+class Promise;
+
+namespace internal {
+
+// What a |Future<void>| holds.
+struct FutureUnit {};
+
+template <typename T>
+struct FutureStorage {
+  using Type = T;
+};
+
+template <>
+struct FutureStorage<void> {
+  using Type = FutureUnit;
+};
+
+// The state a promise shares with its futures. It is settled once, either
+// with a value or by the promise going away without one.
+template <typename T>
+class FutureState : public fml::RefCountedThreadSafe<FutureState<T>> {
+ public:
+  using Value = typename FutureStorage<T>::Type;
+  // Called with whether there is a value.
+  using Callback = fml::UniqueFunction<void(bool)>;
+
+  FutureState() = default;
+
+  ~FutureState() = default;
+
+  void Settle(std::unique_ptr<Value> value) {
+    std::vector<Callback> callbacks;
+    const bool has_value = value != nullptr;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      FML_DCHECK(!settled_);
+      value_ = std::move(value);
+      settled_ = true;
+      callbacks.swap(callbacks_);
+    }
+    settled_event_.Signal();
+    for (auto& callback : callbacks) {
+      callback(has_value);
+    }
+  }
+
+  // Calls |callback| once settled, on the thread that settles this state or
+  // right away if it is settled already.
+  void OnSettled(Callback callback) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!settled_) {
+        callbacks_.emplace_back(std::move(callback));
+        return;
+      }
+    }
+    callback(value_ != nullptr);
+  }
+
+  bool IsSettled() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return settled_;
+  }
+
+  bool Wait() {
+    settled_event_.Wait();
+    return value_ != nullptr;
+  }
+
+  // Only valid once settled with a value.
+  Value& value() { return *value_; }
+
+ private:
+  std::mutex mutex_;
+  bool settled_ = false;
+  std::unique_ptr<Value> value_;
+  std::vector<Callback> callbacks_;
+  ManualResetWaitableEvent settled_event_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FutureState);
+};
+
+// Calls a continuation with the value of a future, or without arguments for
+// a |Future<void>|.
+template <typename T>
+struct FutureApply {
+  template <typename Fn>
+  static auto Call(Fn& fn, T& value) -> decltype(fn(value)) {
+    return fn(value);
+  }
+};
+
+template <>
+struct FutureApply<void> {
+  template <typename Fn>
+  static auto Call(Fn& fn, FutureUnit&) -> decltype(fn()) {
+    return fn();
+  }
+};
+
+// Keeps |promise|, a |Promise<R>|, with the result of |invoke()|. The promise
+// type is a template parameter so that the calls on it are only resolved once
+// |Promise| is complete. The explicit specialization would otherwise call
+// into an incomplete type.
+template <typename R>
+struct FutureFulfill {
+  template <typename P, typename Invoke>
+  static void Run(P& promise, Invoke& invoke) {
+    promise.SetValue(invoke());
+  }
+};
+
+template <>
+struct FutureFulfill<void> {
+  template <typename P, typename Invoke>
+  static void Run(P& promise, Invoke& invoke) {
+    invoke();
+    promise.SetValue();
+  }
+};
+
+template <typename Fn, typename T>
+using ContinuationResult = std::decay_t<decltype(FutureApply<T>::Call(
+    std::declval<Fn&>(),
+    std::declval<typename FutureState<T>::Value&>()))>;
+
+}  // namespace internal
+
+// The write end of a value that is produced on one thread and consumed on
+// others. A promise is kept by calling |SetValue()| once. A promise that goes
+// away without a value is broken, which its futures report instead of
+// waiting forever. Move-only.
+template <typename T>
+class Promise {
+ public:
+  Promise() : state_(fml::MakeRefCounted<internal::FutureState<T>>()) {}
+
+  Promise(Promise&& other) = default;
+
+  Promise& operator=(Promise&& other) {
+    if (this != &other) {
+      Break();
+      state_ = std::move(other.state_);
+    }
+    return *this;
+  }
+
+  ~Promise() { Break(); }
+
+  // The futures of a promise share its value.
+  Future<T> GetFuture() const {
+    FML_DCHECK(state_);
+    return Future<T>(state_);
+  }
+
+  // Sets the value and runs the continuations of the futures. Takes no
+  // arguments for a |Promise<void>|.
+  template <typename... Args>
+  void SetValue(Args&&... args) {
+    FML_DCHECK(state_) << "A promise can only be kept once.";
+    auto state = std::move(state_);
+    state->Settle(std::make_unique<typename internal::FutureState<T>::Value>(
+        std::forward<Args>(args)...));
+  }
+
+ private:
+  fml::RefPtr<internal::FutureState<T>> state_;
+
+  void Break() {
+    if (auto state = std::move(state_)) {
+      state->Settle(nullptr);
+    }
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(Promise);
+};
+
+// The read end of a |Promise|. Instead of blocking a thread till the value is
+// there, consumers can chain continuations that run on a task runner of their
+// choice. Futures are cheap to copy and all copies share the value.
+template <typename T>
+class Future {
+ public:
+  Future() = default;
+
+  // Whether this future belongs to a promise.
+  bool IsValid() const { return static_cast<bool>(state_); }
+
+  // Whether the promise was kept or broken already.
+  bool IsReady() const { return state_ && state_->IsSettled(); }
+
+  // Blocks till the promise is kept or broken and returns whether it was
+  // kept. Must not be called on the thread that is to keep the promise.
+  bool Wait() const {
+    FML_DCHECK(state_);
+    return state_->Wait();
+  }
+
+  // Waits for the value. The promise must be kept.
+  template <typename U = T,
+            typename = std::enable_if_t<!std::is_void<U>::value>>
+  U& Get() const {
+    FML_CHECK(Wait()) << "The promise was broken.";
+    return state_->value();
+  }
+
+  // Calls |fn| on |runner| with the value once the promise is kept, or with
+  // no arguments for a |Future<void>|. Returns a future of what |fn| returns.
+  // If the promise is broken, |fn| is not called and the returned future is
+  // broken as well. |fn| gets the value by reference, so the only
+  // continuation of a future may move it out.
+  template <typename Fn>
+  Future<internal::ContinuationResult<Fn, T>> Then(
+      fml::RefPtr<fml::TaskRunner> runner,
+      Fn fn) const {
+    using R = internal::ContinuationResult<Fn, T>;
+    FML_DCHECK(state_ && runner);
+    Promise<R> promise;
+    Future<R> future = promise.GetFuture();
+    state_->OnSettled([state = state_, runner = std::move(runner),
+                       fn = std::move(fn),
+                       promise = std::move(promise)](bool has_value) mutable {
+      if (!has_value) {
+        return;
+      }
+      fml::TaskRunner::RunNowOrPostTask(
+          runner, [state = std::move(state), fn = std::move(fn),
+                   promise = std::move(promise)]() mutable {
+            auto invoke = [&]() {
+              return internal::FutureApply<T>::Call(fn, state->value());
+            };
+            internal::FutureFulfill<R>::Run(promise, invoke);
+          });
+    });
+    return future;
+  }
+
+ private:
+  template <typename U>
+  friend class Promise;
+
+  template <typename... U>
+  friend Future<void> WhenAll(const Future<U>&... futures);
+
+  fml::RefPtr<internal::FutureState<T>> state_;
+
+  explicit Future(fml::RefPtr<internal::FutureState<T>> state)
+      : state_(std::move(state)) {}
+};
+
+// Returns a future that is ready once all of |futures| are. It is broken if
+// any of the promises is.
+template <typename... T>
+Future<void> WhenAll(const Future<T>&... futures) {
+  static_assert(sizeof...(T) > 0, "Nothing to wait for.");
+
+  struct Join {
+    explicit Join(size_t count) : pending(count) {}
+
+    std::atomic_size_t pending;
+    std::atomic_bool broken = {false};
+    Promise<void> promise;
+  };
+
+  auto join = std::make_shared<Join>(sizeof...(T));
+  auto future = join->promise.GetFuture();
+  auto on_settled = [join](bool has_value) {
+    if (!has_value) {
+      join->broken = true;
+    }
+    if (--join->pending == 0 && !join->broken) {
+      join->promise.SetValue();
+    }
+  };
+  int expand[] = {(futures.state_->OnSettled(on_settled), 0)...};
+  (void)expand;
+  // With |join| gone the promise breaks unless it was kept.
+  return future;
+}
+
+// Runs |fn| on |runner|, right away if that is the current thread, and
+// returns a future of its result. The non-blocking counterpart of
+// |TaskRunner::RunNowOrPostTask()| and a latch.
+template <typename Fn>
+auto RunNowOrPostTaskForResult(fml::RefPtr<fml::TaskRunner> runner, Fn fn)
+    -> Future<std::decay_t<decltype(fn())>> {
+  using R = std::decay_t<decltype(fn())>;
+  Promise<R> promise;
+  Future<R> future = promise.GetFuture();
+  fml::TaskRunner::RunNowOrPostTask(
+      std::move(runner),
+      [fn = std::move(fn), promise = std::move(promise)]() mutable {
+        internal::FutureFulfill<R>::Run(promise, fn);
+      });
+  return future;
+}
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_FUTURE_H_
@@ -0,0 +1,103 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+
+#include "flutter/fml/future.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+
+TEST(FutureTest, WaitsForTheValue) {
+  fml::Thread thread("future");
+  Promise<int> promise;
+  auto future = promise.GetFuture();
+  ASSERT_TRUE(future.IsValid());
+  ASSERT_FALSE(future.IsReady());
+
+  thread.GetTaskRunner()->PostTask(
+      [promise = std::move(promise)]() mutable { promise.SetValue(42); });
+  ASSERT_EQ(future.Get(), 42);
+  ASSERT_TRUE(future.IsReady());
+}
+
+TEST(FutureTest, ContinuationsRunOnTheirTaskRunner) {
+  fml::Thread first("first");
+  fml::Thread second("second");
+  auto first_runner = first.GetTaskRunner();
+  auto second_runner = second.GetTaskRunner();
+
+  auto name = RunNowOrPostTaskForResult(first_runner, [first_runner]() {
+    EXPECT_TRUE(first_runner->RunsTasksOnCurrentThread());
+    return std::string("flutter");
+  });
+  auto length = name.Then(second_runner, [second_runner](std::string& value) {
+    EXPECT_TRUE(second_runner->RunsTasksOnCurrentThread());
+    return value.size();
+  });
+  ASSERT_EQ(length.Get(), 7u);
+}
+
+TEST(FutureTest, CanChainVoidFutures) {
+  fml::Thread thread("future");
+  bool ran = false;
+  auto done =
+      RunNowOrPostTaskForResult(thread.GetTaskRunner(), [&ran]() {
+        ran = true;
+      }).Then(thread.GetTaskRunner(), [&ran]() { return ran; });
+  ASSERT_TRUE(done.Get());
+}
+
+TEST(FutureTest, MoveOnlyValues) {
+  fml::Thread thread("future");
+  auto future =
+      RunNowOrPostTaskForResult(thread.GetTaskRunner(), []() {
+        return std::make_unique<int>(3);
+      }).Then(thread.GetTaskRunner(), [](std::unique_ptr<int>& value) {
+        return std::move(value);
+      });
+  ASSERT_EQ(*future.Get(), 3);
+}
+
+TEST(FutureTest, BrokenPromisesBreakTheirContinuations) {
+  fml::Thread thread("future");
+  bool ran = false;
+  Future<void> continuation;
+  {
+    Promise<int> promise;
+    continuation = promise.GetFuture().Then(
+        thread.GetTaskRunner(), [&ran](int&) { ran = true; });
+  }
+  ASSERT_FALSE(continuation.Wait());
+  ASSERT_FALSE(ran);
+}
+
+TEST(FutureTest, WhenAllWaitsForEveryFuture) {
+  fml::Thread first("first");
+  fml::Thread second("second");
+  AutoResetWaitableEvent hold;
+  auto slow = RunNowOrPostTaskForResult(first.GetTaskRunner(), [&hold]() {
+    hold.Wait();
+    return 1;
+  });
+  auto fast = RunNowOrPostTaskForResult(second.GetTaskRunner(),
+                                        []() { return 2; });
+  auto all = WhenAll(slow, fast);
+  fast.Wait();
+  ASSERT_FALSE(all.IsReady());
+
+  hold.Signal();
+  ASSERT_TRUE(all.Wait());
+  ASSERT_EQ(slow.Get() + fast.Get(), 3);
+
+  Promise<int> broken;
+  auto never = WhenAll(fast, broken.GetFuture());
+  broken = Promise<int>();
+  ASSERT_FALSE(never.Wait());
+}
+
+}  // namespace fml
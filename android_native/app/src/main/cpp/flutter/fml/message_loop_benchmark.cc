@@ -0,0 +1,157 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <deque>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "flutter/fml/closure.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/synchronization/mpsc_queue.h"
+#include "flutter/fml/thread.h"
+
+namespace fml {
+namespace {
+
+constexpr size_t kTasksPerProducer = 10000;
+
+// How the message loop queued tasks before it had an intake queue for
+// immediate tasks: all tasks go into one heap under one mutex.
+class LockedTaskQueue {
+ public:
+  void Push(fml::closure task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.push({++order_, std::move(task)});
+  }
+
+  size_t RunAll() {
+    size_t count = 0;
+    while (true) {
+      fml::closure task;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (tasks_.empty()) {
+          return count;
+        }
+        task = std::move(tasks_.top().task);
+        tasks_.pop();
+      }
+      task();
+      count++;
+    }
+  }
+
+ private:
+  struct Task {
+    size_t order;
+    fml::closure task;
+  };
+
+  struct TaskCompare {
+    bool operator()(const Task& a, const Task& b) { return a.order > b.order; }
+  };
+
+  std::mutex mutex_;
+  std::priority_queue<Task, std::deque<Task>, TaskCompare> tasks_;
+  size_t order_ = 0;
+};
+
+class IntakeTaskQueue {
+ public:
+  void Push(fml::closure task) { tasks_.Push(std::move(task)); }
+
+  size_t RunAll() {
+    return tasks_.Drain([](fml::closure task) { task(); });
+  }
+
+ private:
+  MpscQueue<fml::closure> tasks_;
+};
+
+// Posts |kTasksPerProducer| tasks from each of |state.range(0)| threads while
+// the benchmark thread runs them.
+template <typename Queue>
+void BM_TaskQueue(benchmark::State& state) {
+  const size_t producer_count = state.range(0);
+  const size_t task_count = producer_count * kTasksPerProducer;
+  for (auto _ : state) {
+    Queue queue;
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < producer_count; i++) {
+      producers.emplace_back([&queue]() {
+        for (size_t j = 0; j < kTasksPerProducer; j++) {
+          queue.Push([]() {});
+        }
+      });
+    }
+    size_t run = 0;
+    while (run < task_count) {
+      run += queue.RunAll();
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * task_count);
+}
+
+BENCHMARK_TEMPLATE(BM_TaskQueue, LockedTaskQueue)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_TaskQueue, IntakeTaskQueue)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+
+// Posts |kTasksPerProducer| tasks from each of |state.range(0)| threads to a
+// message loop and waits for them to run.
+void BM_MessageLoopPostTask(benchmark::State& state) {
+  const size_t producer_count = state.range(0);
+  fml::Thread thread("benchmark");
+  auto runner = thread.GetTaskRunner();
+  for (auto _ : state) {
+    CountDownLatch latch(producer_count * kTasksPerProducer);
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < producer_count; i++) {
+      producers.emplace_back([&runner, &latch]() {
+        for (size_t j = 0; j < kTasksPerProducer; j++) {
+          runner->PostTask([&latch]() { latch.CountDown(); });
+        }
+      });
+    }
+    latch.Wait();
+    for (auto& producer : producers) {
+      producer.join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * producer_count *
+                          kTasksPerProducer);
+}
+
+BENCHMARK(BM_MessageLoopPostTask)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+
+// Posts tasks that are not due for a long time. So the cost of arming the
+// loop's timer is not hidden by running tasks.
+void BM_MessageLoopPostDelayedTask(benchmark::State& state) {
+  fml::Thread thread("benchmark");
+  auto runner = thread.GetTaskRunner();
+  for (auto _ : state) {
+    runner->PostDelayedTask([]() {}, fml::TimeDelta::FromSeconds(60));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_MessageLoopPostDelayedTask);
+
+}  // namespace
+}  // namespace fml
+
+BENCHMARK_MAIN();
@@ -39,13 +39,17 @@ fml::RefPtr<MessageLoopImpl> MessageLoopImpl::Create() {
 #endif
 }
 
+constexpr size_t MessageLoopImpl::kMaxStarvedTasks;
+
 MessageLoopImpl::MessageLoopImpl() : order_(0), terminated_(false) {}
 
 MessageLoopImpl::~MessageLoopImpl() = default;
 
-void MessageLoopImpl::PostTask(fml::closure task, fml::TimePoint target_time) {
+TaskHandle MessageLoopImpl::PostTask(fml::unique_closure task,
+                                     fml::TimePoint target_time,
+                                     TaskPriority priority) {
   FML_DCHECK(task != nullptr);
-  RegisterTask(task, target_time);
+  return RegisterTask(std::move(task), target_time, priority);
 }
 
 void MessageLoopImpl::RunExpiredTasksNow() {
@@ -91,7 +95,12 @@ void MessageLoopImpl::DoRun() {
   // from the implementations |Run| method which we know is on the correct
   // thread. Drop all pending tasks on the floor.
   std::lock_guard<std::mutex> lock(delayed_tasks_mutex_);
-  delayed_tasks_ = {};
+  for (auto& lane : lanes_) {
+    lane.immediate_tasks.Drain([](fml::unique_closure) {});
+    lane.delayed_tasks.clear();
+    lane.expired_tasks.clear();
+    lane.starved_tasks = 0;
+  }
 }
 
 void MessageLoopImpl::DoTerminate() {
@@ -99,59 +108,213 @@ void MessageLoopImpl::DoTerminate() {
   Terminate();
 }
 
-void MessageLoopImpl::RegisterTask(fml::closure task,
-                                   fml::TimePoint target_time) {
+TaskHandle MessageLoopImpl::RegisterTask(fml::unique_closure task,
+                                         fml::TimePoint target_time,
+                                         TaskPriority priority) {
   FML_DCHECK(task != nullptr);
   if (terminated_) {
     // If the message loop has already been terminated, PostTask should destruct
     // |task| synchronously within this function.
-    return;
+    return {};
   }
-  std::lock_guard<std::mutex> lock(delayed_tasks_mutex_);
-  delayed_tasks_.push({++order_, std::move(task), target_time});
-  WakeUp(delayed_tasks_.top().target_time);
+  TaskLane& lane = lanes_[static_cast<size_t>(priority)];
+  const auto now = fml::TimePoint::Now();
+  if (target_time <= now) {
+    // Only the push that makes the queue non-empty has to wake up the loop.
+    // The loop drains the whole queue before it sleeps again.
+    if (lane.immediate_tasks.Push(std::move(task))) {
+      WakeUp(now);
+    }
+    return {};
+  }
+  size_t order;
+  {
+    std::lock_guard<std::mutex> lock(delayed_tasks_mutex_);
+    order = ++order_;
+    lane.delayed_tasks.emplace(DelayedTaskKey{target_time, order},
+                               std::move(task));
+  }
+  ScheduleNextWakeUp();
+  return {fml::Ref(this), priority, target_time, order};
 }
 
-void MessageLoopImpl::RunExpiredTasks() {
-  TRACE_EVENT0("fml", "MessageLoop::RunExpiredTasks");
-  std::vector<fml::closure> invocations;
+bool MessageLoopImpl::CancelTask(TaskPriority priority,
+                                 fml::TimePoint target_time,
+                                 size_t order) {
+  fml::unique_closure task;
+  {
+    std::lock_guard<std::mutex> lock(delayed_tasks_mutex_);
+    task = TakeTaskLocked(lanes_[static_cast<size_t>(priority)], target_time,
+                          order);
+  }
+  if (!task) {
+    return false;
+  }
+  // The loop may not have to wake up as early anymore.
+  ScheduleNextWakeUp();
+  return true;
+}
 
+bool MessageLoopImpl::RescheduleTask(TaskPriority priority,
+                                     fml::TimePoint target_time,
+                                     size_t order,
+                                     fml::TimePoint new_target_time) {
   {
     std::lock_guard<std::mutex> lock(delayed_tasks_mutex_);
+    if (terminated_) {
+      return false;
+    }
+    TaskLane& lane = lanes_[static_cast<size_t>(priority)];
+    auto task = TakeTaskLocked(lane, target_time, order);
+    if (!task) {
+      return false;
+    }
+    lane.delayed_tasks.emplace(DelayedTaskKey{new_target_time, order},
+                               std::move(task));
+  }
+  ScheduleNextWakeUp();
+  return true;
+}
 
-    if (delayed_tasks_.empty()) {
-      return;
+fml::unique_closure MessageLoopImpl::TakeTaskLocked(TaskLane& lane,
+                                                    fml::TimePoint target_time,
+                                                    size_t order) {
+  fml::unique_closure task;
+  auto delayed = lane.delayed_tasks.find({target_time, order});
+  if (delayed != lane.delayed_tasks.end()) {
+    task = std::move(delayed->second);
+    lane.delayed_tasks.erase(delayed);
+    return task;
+  }
+  // The task may have become due but not have run yet. There are only a few
+  // of those.
+  auto expired = std::find_if(
+      lane.expired_tasks.begin(), lane.expired_tasks.end(),
+      [order](const ExpiredTask& expired) { return expired.order == order; });
+  if (expired != lane.expired_tasks.end()) {
+    task = std::move(expired->task);
+    lane.expired_tasks.erase(expired);
+  }
+  return task;
+}
+
+size_t MessageLoopImpl::CollectExpiredTasksLocked(fml::TimePoint now) {
+  size_t count = 0;
+  for (auto& lane : lanes_) {
+    while (!lane.delayed_tasks.empty()) {
+      auto first = lane.delayed_tasks.begin();
+      if (first->first.target_time > now) {
+        break;
+      }
+      lane.expired_tasks.push_back(
+          {first->first.order, std::move(first->second)});
+      lane.delayed_tasks.erase(first);
     }
+    lane.immediate_tasks.Drain([&lane](fml::unique_closure task) {
+      lane.expired_tasks.push_back({0, std::move(task)});
+    });
+    count += lane.expired_tasks.size();
+  }
+  return count;
+}
 
-    auto now = fml::TimePoint::Now();
-    while (!delayed_tasks_.empty()) {
-      const auto& top = delayed_tasks_.top();
-      if (top.target_time > now) {
+bool MessageLoopImpl::TakeNextExpiredTaskLocked(fml::unique_closure* task) {
+  // The highest priority lane that waited too long goes first. Otherwise, the
+  // highest priority lane with due tasks.
+  TaskLane* next = nullptr;
+  for (auto& lane : lanes_) {
+    if (!lane.expired_tasks.empty() &&
+        lane.starved_tasks >= kMaxStarvedTasks) {
+      next = &lane;
+      break;
+    }
+  }
+  if (next == nullptr) {
+    for (auto& lane : lanes_) {
+      if (!lane.expired_tasks.empty()) {
+        next = &lane;
         break;
       }
-      invocations.emplace_back(std::move(top.task));
-      delayed_tasks_.pop();
     }
+  }
+  if (next == nullptr) {
+    return false;
+  }
+
+  for (auto lane = next + 1; lane != lanes_.data() + lanes_.size(); lane++) {
+    if (!lane->expired_tasks.empty()) {
+      lane->starved_tasks++;
+    }
+  }
+  next->starved_tasks = 0;
+
+  *task = std::move(next->expired_tasks.front().task);
+  next->expired_tasks.pop_front();
+  return true;
+}
+
+fml::TimePoint MessageLoopImpl::GetNextWakeTimeLocked() const {
+  fml::TimePoint wake_time = fml::TimePoint::Max();
+  for (const auto& lane : lanes_) {
+    if (!lane.expired_tasks.empty() || !lane.immediate_tasks.IsEmpty()) {
+      // Due already.
+      return fml::TimePoint::Now();
+    }
+    if (!lane.delayed_tasks.empty()) {
+      wake_time =
+          std::min(wake_time, lane.delayed_tasks.begin()->first.target_time);
+    }
+  }
+  return wake_time;
+}
+
+void MessageLoopImpl::RunExpiredTasks() {
+  TRACE_EVENT0("fml", "MessageLoop::RunExpiredTasks");
 
-    WakeUp(delayed_tasks_.empty() ? fml::TimePoint::Max()
-                                  : delayed_tasks_.top().target_time);
+  // Only as many tasks as are due now are run so that tasks that keep posting
+  // tasks cannot block the loop. But the next task is picked after each task
+  // so that due tasks of higher priority posted meanwhile run first.
+  size_t remaining;
+  {
+    std::lock_guard<std::mutex> lock(delayed_tasks_mutex_);
+    remaining = CollectExpiredTasksLocked(fml::TimePoint::Now());
   }
 
-  for (const auto& invocation : invocations) {
+  for (; remaining > 0; remaining--) {
+    fml::unique_closure invocation;
+    {
+      std::lock_guard<std::mutex> lock(delayed_tasks_mutex_);
+      CollectExpiredTasksLocked(fml::TimePoint::Now());
+      if (!TakeNextExpiredTaskLocked(&invocation)) {
+        break;
+      }
+    }
+
     invocation();
     for (const auto& observer : task_observers_) {
       observer.second();
     }
   }
-}
 
-MessageLoopImpl::DelayedTask::DelayedTask(size_t p_order,
-                                          fml::closure p_task,
-                                          fml::TimePoint p_target_time)
-    : order(p_order), task(std::move(p_task)), target_time(p_target_time) {}
+  ScheduleNextWakeUp();
+}
 
-MessageLoopImpl::DelayedTask::DelayedTask(const DelayedTask& other) = default;
+void MessageLoopImpl::ScheduleNextWakeUp() {
+  {
+    std::lock_guard<std::mutex> lock(delayed_tasks_mutex_);
+    WakeUp(GetNextWakeTimeLocked());
+  }
 
-MessageLoopImpl::DelayedTask::~DelayedTask() = default;
+  // A producer may have pushed the first immediate task of a lane after the
+  // wake time was computed and its wakeup may have been overwritten by the
+  // one above. The producer pushes before it wakes up the loop. So if this
+  // check misses the task, the producer's wakeup comes last.
+  for (const auto& lane : lanes_) {
+    if (!lane.immediate_tasks.IsEmpty()) {
+      WakeUp(fml::TimePoint::Now());
+      return;
+    }
+  }
+}
 
 }  // namespace fml
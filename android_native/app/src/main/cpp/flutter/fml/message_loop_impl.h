@@ -5,17 +5,20 @@
 #ifndef FLUTTER_FML_MESSAGE_LOOP_IMPL_H_
 #define FLUTTER_FML_MESSAGE_LOOP_IMPL_H_
 
+#include <array>
 #include <atomic>
 #include <deque>
 #include <map>
 #include <mutex>
-#include <queue>
 #include <utility>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/message_loop.h"
+#include "flutter/fml/synchronization/mpsc_queue.h"
+#include "flutter/fml/task_handle.h"
+#include "flutter/fml/task_priority.h"
 #include "flutter/fml/time/time_point.h"
 
 namespace fml {
@@ -32,7 +35,10 @@ class MessageLoopImpl : public fml::RefCountedThreadSafe<MessageLoopImpl> {
 
   virtual void WakeUp(fml::TimePoint time_point) = 0;
 
-  void PostTask(fml::closure task, fml::TimePoint target_time);
+  // Returns a handle to cancel or reschedule |task| if it is not due yet.
+  TaskHandle PostTask(fml::unique_closure task,
+                      fml::TimePoint target_time,
+                      TaskPriority priority = TaskPriority::kNormal);
 
   void AddTaskObserver(intptr_t key, fml::closure callback);
 
@@ -50,40 +56,85 @@ class MessageLoopImpl : public fml::RefCountedThreadSafe<MessageLoopImpl> {
   MessageLoopImpl();
 
  private:
-  struct DelayedTask {
-    size_t order;
-    fml::closure task;
+  // A lane with due tasks gets to run one of them after this many tasks of
+  // higher priority lanes ran in a row.
+  static constexpr size_t kMaxStarvedTasks = 16;
+
+  // Delayed tasks are keyed by time so that they can be found again to be
+  // cancelled or rescheduled. The order breaks ties in posting order.
+  struct DelayedTaskKey {
     fml::TimePoint target_time;
+    size_t order;
 
-    DelayedTask(size_t p_order,
-                fml::closure p_task,
-                fml::TimePoint p_target_time);
+    bool operator<(const DelayedTaskKey& other) const {
+      return target_time == other.target_time ? order < other.order
+                                              : target_time < other.target_time;
+    }
+  };
 
-    DelayedTask(const DelayedTask& other);
+  using DelayedTaskQueue = std::map<DelayedTaskKey, fml::unique_closure>;
 
-    ~DelayedTask();
+  struct ExpiredTask {
+    // Zero for tasks posted without a handle.
+    size_t order;
+    fml::unique_closure task;
   };
 
-  struct DelayedTaskCompare {
-    bool operator()(const DelayedTask& a, const DelayedTask& b) {
-      return a.target_time == b.target_time ? a.order > b.order
-                                            : a.target_time > b.target_time;
-    }
+  struct TaskLane {
+    // Tasks that were due when they were posted. Posting them does not take
+    // |delayed_tasks_mutex_|.
+    MpscQueue<fml::unique_closure> immediate_tasks;
+    // Tasks that were not due yet when they were posted.
+    DelayedTaskQueue delayed_tasks;
+    // Due tasks in the order they became due.
+    std::deque<ExpiredTask> expired_tasks;
+    // The number of tasks of higher lanes that ran while this lane had due
+    // tasks.
+    size_t starved_tasks = 0;
   };
 
-  using DelayedTaskQueue = std::
-      priority_queue<DelayedTask, std::deque<DelayedTask>, DelayedTaskCompare>;
-
   std::map<intptr_t, fml::closure> task_observers_;
   std::mutex delayed_tasks_mutex_;
-  DelayedTaskQueue delayed_tasks_;
+  std::array<TaskLane, kTaskPriorityCount> lanes_;
   size_t order_;
   std::atomic_bool terminated_;
 
-  void RegisterTask(fml::closure task, fml::TimePoint target_time);
+  TaskHandle RegisterTask(fml::unique_closure task,
+                          fml::TimePoint target_time,
+                          TaskPriority priority);
+
+  friend class TaskHandle;
+
+  bool CancelTask(TaskPriority priority,
+                  fml::TimePoint target_time,
+                  size_t order);
+
+  bool RescheduleTask(TaskPriority priority,
+                      fml::TimePoint target_time,
+                      size_t order,
+                      fml::TimePoint new_target_time);
+
+  // Removes the task with |order| from the delayed or the expired tasks of
+  // |lane|. Returns a null closure if the task already ran or is running.
+  fml::unique_closure TakeTaskLocked(TaskLane& lane,
+                                     fml::TimePoint target_time,
+                                     size_t order);
 
   void RunExpiredTasks();
 
+  // Moves the immediate tasks and the delayed tasks due at |now| to the
+  // expired tasks of their lanes. Returns the number of expired tasks in all
+  // lanes.
+  size_t CollectExpiredTasksLocked(fml::TimePoint now);
+
+  // Takes the expired task to run next. Returns false if there is none.
+  bool TakeNextExpiredTaskLocked(fml::unique_closure* task);
+
+  fml::TimePoint GetNextWakeTimeLocked() const;
+
+  // Wakes up the loop at the time of the next task.
+  void ScheduleNextWakeUp();
+
   FML_DISALLOW_COPY_AND_ASSIGN(MessageLoopImpl);
 };
 
@@ -4,7 +4,9 @@
 
 #define FML_USED_ON_EMBEDDER
 
+#include <functional>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/synchronization/waitable_event.h"
@@ -278,3 +280,251 @@ TEST(MessageLoop, TaskObserverFire) {
   ASSERT_TRUE(started);
   ASSERT_TRUE(terminated);
 }
+
+TEST(MessageLoop, HigherPriorityTasksRunFirst) {
+  std::vector<fml::TaskPriority> order;
+  std::thread thread([&order]() {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    auto& loop = fml::MessageLoop::GetCurrent();
+    auto runner = loop.GetTaskRunner();
+    for (auto priority :
+         {fml::TaskPriority::kIdle, fml::TaskPriority::kNormal,
+          fml::TaskPriority::kFrame, fml::TaskPriority::kInput}) {
+      runner->PostTask([&order, priority]() { order.push_back(priority); },
+                       priority);
+    }
+    runner->PostTask([]() { fml::MessageLoop::GetCurrent().Terminate(); },
+                     fml::TaskPriority::kIdle);
+    loop.Run();
+  });
+  thread.join();
+  ASSERT_EQ(order, (std::vector<fml::TaskPriority>{
+                       fml::TaskPriority::kInput, fml::TaskPriority::kFrame,
+                       fml::TaskPriority::kNormal, fml::TaskPriority::kIdle}));
+}
+
+TEST(MessageLoop, HigherPriorityTasksOvertakeTheBacklog) {
+  const size_t count = 10;
+  size_t normal_tasks_before_input = 0;
+  std::thread thread([&normal_tasks_before_input, count]() {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    auto& loop = fml::MessageLoop::GetCurrent();
+    auto runner = loop.GetTaskRunner();
+    size_t normal_tasks = 0;
+    for (size_t i = 0; i < count; i++) {
+      runner->PostTask([&normal_tasks, runner, i, count,
+                        &normal_tasks_before_input]() {
+        normal_tasks++;
+        if (i == 0) {
+          runner->PostTask(
+              [&normal_tasks, &normal_tasks_before_input]() {
+                normal_tasks_before_input = normal_tasks;
+              },
+              fml::TaskPriority::kInput);
+        }
+        if (i == count - 1) {
+          fml::MessageLoop::GetCurrent().Terminate();
+        }
+      });
+    }
+    loop.Run();
+  });
+  thread.join();
+  ASSERT_EQ(normal_tasks_before_input, 1u);
+}
+
+TEST(MessageLoop, LowerPriorityTasksAreNotStarved) {
+  size_t frame_tasks_before_idle = 0;
+  std::thread thread([&frame_tasks_before_idle]() {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    auto& loop = fml::MessageLoop::GetCurrent();
+    auto runner = loop.GetTaskRunner();
+    size_t frame_tasks = 0;
+    bool idle_ran = false;
+    // A frame task that keeps posting frame tasks.
+    std::function<void()> frame_task;
+    frame_task = [&]() {
+      frame_tasks++;
+      if (idle_ran) {
+        fml::MessageLoop::GetCurrent().Terminate();
+        return;
+      }
+      runner->PostTask(frame_task, fml::TaskPriority::kFrame);
+    };
+    runner->PostTask(frame_task, fml::TaskPriority::kFrame);
+    runner->PostTask(
+        [&]() {
+          idle_ran = true;
+          frame_tasks_before_idle = frame_tasks;
+        },
+        fml::TaskPriority::kIdle);
+    loop.Run();
+  });
+  thread.join();
+  ASSERT_GT(frame_tasks_before_idle, 0u);
+  ASSERT_LE(frame_tasks_before_idle, 100u);
+}
+
+TEST(MessageLoop, TasksPostedFromManyThreadsAllRun) {
+  const size_t producer_count = 4;
+  const size_t tasks_per_producer = 1000;
+  size_t tasks_run = 0;
+  fml::AutoResetWaitableEvent latch;
+  fml::RefPtr<fml::TaskRunner> runner;
+  std::thread thread([&runner, &latch]() {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    auto& loop = fml::MessageLoop::GetCurrent();
+    runner = loop.GetTaskRunner();
+    latch.Signal();
+    loop.Run();
+  });
+  latch.Wait();
+
+  std::vector<std::thread> producers;
+  for (size_t i = 0; i < producer_count; i++) {
+    producers.emplace_back([&runner, &tasks_run]() {
+      for (size_t j = 0; j < tasks_per_producer; j++) {
+        runner->PostTask([&tasks_run]() { tasks_run++; });
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  // Immediate tasks posted from one thread run in order. So this runs last.
+  runner->PostTask([]() { fml::MessageLoop::GetCurrent().Terminate(); });
+  thread.join();
+  ASSERT_EQ(tasks_run, producer_count * tasks_per_producer);
+}
+
+TEST(MessageLoop, WakeUpsAreNotLostWhenPostingFromManyThreads) {
+  // Each producer waits for its task to run before posting the next. A wakeup
+  // lost to a race with the loop draining its wakeups hangs the test.
+  const size_t producer_count = 4;
+  const size_t tasks_per_producer = 5000;
+  fml::AutoResetWaitableEvent latch;
+  fml::RefPtr<fml::TaskRunner> runner;
+  std::thread thread([&runner, &latch]() {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    auto& loop = fml::MessageLoop::GetCurrent();
+    runner = loop.GetTaskRunner();
+    latch.Signal();
+    loop.Run();
+  });
+  latch.Wait();
+
+  std::vector<std::thread> producers;
+  for (size_t i = 0; i < producer_count; i++) {
+    producers.emplace_back([&runner]() {
+      fml::AutoResetWaitableEvent task_run;
+      for (size_t j = 0; j < tasks_per_producer; j++) {
+        runner->PostTask([&task_run]() { task_run.Signal(); });
+        task_run.Wait();
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+
+  runner->PostTask([]() { fml::MessageLoop::GetCurrent().Terminate(); });
+  thread.join();
+}
+
+TEST(MessageLoop, CancelledDelayedTasksDoNotRun) {
+  bool ran = false;
+  bool cancelled = false;
+  bool cancelled_twice = true;
+  std::thread thread([&ran, &cancelled, &cancelled_twice]() {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    auto& loop = fml::MessageLoop::GetCurrent();
+    auto runner = loop.GetTaskRunner();
+    auto handle = runner->PostDelayedTask([&ran]() { ran = true; },
+                                          fml::TimeDelta::FromMilliseconds(2));
+    ASSERT_TRUE(handle);
+    cancelled = handle.Cancel();
+    ASSERT_FALSE(handle);
+    cancelled_twice = handle.Cancel();
+    runner->PostDelayedTask(
+        []() { fml::MessageLoop::GetCurrent().Terminate(); },
+        fml::TimeDelta::FromMilliseconds(10));
+    loop.Run();
+  });
+  thread.join();
+  ASSERT_TRUE(cancelled);
+  ASSERT_FALSE(cancelled_twice);
+  ASSERT_FALSE(ran);
+}
+
+TEST(MessageLoop, CanCancelDueTasksThatDidNotRunYet) {
+  bool idle_ran = false;
+  bool cancelled = false;
+  std::thread thread([&idle_ran, &cancelled]() {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    auto& loop = fml::MessageLoop::GetCurrent();
+    auto runner = loop.GetTaskRunner();
+    // Both tasks become due together and the frame task runs first.
+    const auto target_time =
+        fml::TimePoint::Now() + fml::TimeDelta::FromMilliseconds(2);
+    auto idle_task = runner->PostTaskForTime([&idle_ran]() { idle_ran = true; },
+                                             target_time,
+                                             fml::TaskPriority::kIdle);
+    runner->PostTaskForTime(
+        [&idle_task, &cancelled]() { cancelled = idle_task.Cancel(); },
+        target_time, fml::TaskPriority::kFrame);
+    runner->PostDelayedTask(
+        []() { fml::MessageLoop::GetCurrent().Terminate(); },
+        fml::TimeDelta::FromMilliseconds(10));
+    loop.Run();
+  });
+  thread.join();
+  ASSERT_TRUE(cancelled);
+  ASSERT_FALSE(idle_ran);
+}
+
+TEST(MessageLoop, RescheduledTasksRunAtTheNewTime) {
+  bool rescheduled = false;
+  bool ran = false;
+  std::thread thread([&rescheduled, &ran]() {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    auto& loop = fml::MessageLoop::GetCurrent();
+    auto runner = loop.GetTaskRunner();
+    auto handle = runner->PostDelayedTask(
+        [&ran]() {
+          ran = true;
+          fml::MessageLoop::GetCurrent().Terminate();
+        },
+        fml::TimeDelta::FromSeconds(60));
+    rescheduled = handle.Reschedule(fml::TimePoint::Now() +
+                                    fml::TimeDelta::FromMilliseconds(2));
+    loop.Run();
+  });
+  thread.join();
+  ASSERT_TRUE(rescheduled);
+  ASSERT_TRUE(ran);
+}
+
+TEST(MessageLoop, TasksThatRanCannotBeCancelledOrRescheduled) {
+  bool cancelled = true;
+  bool rescheduled = true;
+  std::thread thread([&cancelled, &rescheduled]() {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    auto& loop = fml::MessageLoop::GetCurrent();
+    auto runner = loop.GetTaskRunner();
+    auto handle = runner->PostDelayedTask(
+        []() {}, fml::TimeDelta::FromMilliseconds(1));
+    runner->PostDelayedTask(
+        [&]() {
+          rescheduled = handle.Reschedule(fml::TimePoint::Now());
+          cancelled = handle.Cancel();
+          fml::MessageLoop::GetCurrent().Terminate();
+        },
+        fml::TimeDelta::FromMilliseconds(5));
+    ASSERT_FALSE(runner->PostTaskForTime([]() {}, fml::TimePoint::Now()));
+    loop.Run();
+  });
+  thread.join();
+  ASSERT_FALSE(rescheduled);
+  ASSERT_FALSE(cancelled);
+}
@@ -4,7 +4,9 @@
 
 #include "flutter/fml/platform/linux/message_loop_linux.h"
 
+#include <errno.h>
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <unistd.h>
 
 #include "flutter/fml/eintr_wrapper.h"
@@ -14,32 +16,42 @@ namespace fml {
 
 static constexpr int kClockType = CLOCK_MONOTONIC;
 
+// The loop waits on |event_fd_| and |timer_fd_|.
+static constexpr int kMaxEvents = 2;
+
 MessageLoopLinux::MessageLoopLinux()
     : epoll_fd_(FML_HANDLE_EINTR(::epoll_create(1 /* unused */))),
+      event_fd_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
       timer_fd_(::timerfd_create(kClockType, TFD_NONBLOCK | TFD_CLOEXEC)),
-      running_(false) {
+      running_(false),
+      event_pending_(false),
+      armed_time_(fml::TimePoint::Max()) {
   FML_CHECK(epoll_fd_.is_valid());
+  FML_CHECK(event_fd_.is_valid());
   FML_CHECK(timer_fd_.is_valid());
-  bool added_source = AddOrRemoveTimerSource(true);
-  FML_CHECK(added_source);
+  bool added_event_source = AddOrRemoveSource(event_fd_.get(), true);
+  FML_CHECK(added_event_source);
+  bool added_timer_source = AddOrRemoveSource(timer_fd_.get(), true);
+  FML_CHECK(added_timer_source);
 }
 
 MessageLoopLinux::~MessageLoopLinux() {
-  bool removed_source = AddOrRemoveTimerSource(false);
-  FML_CHECK(removed_source);
+  bool removed_timer_source = AddOrRemoveSource(timer_fd_.get(), false);
+  FML_CHECK(removed_timer_source);
+  bool removed_event_source = AddOrRemoveSource(event_fd_.get(), false);
+  FML_CHECK(removed_event_source);
 }
 
-bool MessageLoopLinux::AddOrRemoveTimerSource(bool add) {
+bool MessageLoopLinux::AddOrRemoveSource(int fd, bool add) {
   struct epoll_event event = {};
 
   event.events = EPOLLIN;
   // The data is just for informational purposes so we know when we were worken
   // by the FD.
-  event.data.fd = timer_fd_.get();
+  event.data.fd = fd;
 
-  int ctl_result =
-      ::epoll_ctl(epoll_fd_.get(), add ? EPOLL_CTL_ADD : EPOLL_CTL_DEL,
-                  timer_fd_.get(), &event);
+  int ctl_result = ::epoll_ctl(
+      epoll_fd_.get(), add ? EPOLL_CTL_ADD : EPOLL_CTL_DEL, fd, &event);
   return ctl_result == 0;
 }
 
@@ -47,26 +59,32 @@ void MessageLoopLinux::Run() {
   running_ = true;
 
   while (running_) {
-    struct epoll_event event = {};
+    struct epoll_event events[kMaxEvents] = {};
 
     int epoll_result = FML_HANDLE_EINTR(
-        ::epoll_wait(epoll_fd_.get(), &event, 1, -1 /* timeout */));
+        ::epoll_wait(epoll_fd_.get(), events, kMaxEvents, -1 /* timeout */));
 
-    // Errors are fatal.
-    if (event.events & (EPOLLERR | EPOLLHUP)) {
+    // Timeouts are fatal since we specified an infinite timeout already.
+    if (epoll_result <= 0) {
       running_ = false;
       continue;
     }
 
-    // Timeouts are fatal since we specified an infinite timeout already.
-    // Likewise, > 1 is not possible since we waited for one result.
-    if (epoll_result != 1) {
-      running_ = false;
-      continue;
+    // Both sources may be ready. Their tasks are run in one go.
+    bool event_fired = false;
+    bool timer_fired = false;
+    for (int i = 0; i < epoll_result; i++) {
+      // Errors are fatal.
+      if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+        running_ = false;
+        break;
+      }
+      event_fired |= events[i].data.fd == event_fd_.get();
+      timer_fired |= events[i].data.fd == timer_fd_.get();
     }
 
-    if (event.data.fd == timer_fd_.get()) {
-      OnEventFired();
+    if (running_) {
+      OnEventFired(event_fired, timer_fired);
     }
   }
 }
@@ -77,12 +95,55 @@ void MessageLoopLinux::Terminate() {
 }
 
 void MessageLoopLinux::WakeUp(fml::TimePoint time_point) {
+  if (time_point <= fml::TimePoint::Now()) {
+    // A due wakeup only has to be signalled once till the loop wakes up.
+    if (!event_pending_.exchange(true)) {
+      const uint64_t count = 1;
+      ssize_t size =
+          FML_HANDLE_EINTR(::write(event_fd_.get(), &count, sizeof(count)));
+      FML_DCHECK(size == sizeof(count));
+    }
+    return;
+  }
+
+  RearmTimer(time_point);
+}
+
+void MessageLoopLinux::RearmTimer(fml::TimePoint time_point) {
+  std::lock_guard<std::mutex> lock(timer_mutex_);
+  const bool armed = armed_time_ > fml::TimePoint::Now();
+  // |time_point| is always the time of the earliest task, so a later time
+  // means that earlier tasks were cancelled and the timer is moved out instead
+  // of waking up the loop for nothing. If the timer already fired, there is
+  // nothing to disarm.
+  if ((armed && armed_time_ == time_point) ||
+      (!armed && time_point == fml::TimePoint::Max())) {
+    return;
+  }
   bool result = TimerRearm(timer_fd_.get(), time_point);
   FML_DCHECK(result);
+  armed_time_ = time_point;
 }
 
-void MessageLoopLinux::OnEventFired() {
-  if (TimerDrain(timer_fd_.get())) {
+void MessageLoopLinux::OnEventFired(bool event_fired, bool timer_fired) {
+  bool run_tasks = false;
+  if (event_fired) {
+    // The eventfd is drained before the flag is cleared. Cleared the other
+    // way round, a wakeup signalled in between would be consumed by the read
+    // and leave the flag set with nothing to wake the loop ever again. The
+    // flag is still cleared before the tasks are collected, so the tasks of a
+    // wakeup that saw it set are run below.
+    uint64_t count = 0;
+    ssize_t size =
+        FML_HANDLE_EINTR(::read(event_fd_.get(), &count, sizeof(count)));
+    event_pending_ = false;
+    run_tasks = true;
+    FML_DCHECK(size == sizeof(count) || (size < 0 && errno == EAGAIN));
+  }
+  if (timer_fired) {
+    run_tasks |= TimerDrain(timer_fd_.get());
+  }
+  if (run_tasks) {
     RunExpiredTasksNow();
   }
 }
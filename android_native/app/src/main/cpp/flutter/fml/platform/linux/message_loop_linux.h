@@ -6,6 +6,7 @@
 #define FLUTTER_FML_PLATFORM_LINUX_MESSAGE_LOOP_LINUX_H_
 
 #include <atomic>
+#include <mutex>
 
 #include "flutter/fml/macros.h"
 #include "flutter/fml/message_loop_impl.h"
@@ -16,8 +17,16 @@ namespace fml {
 class MessageLoopLinux : public MessageLoopImpl {
  private:
   fml::UniqueFD epoll_fd_;
+  // Signalled for wakeups that are due already.
+  fml::UniqueFD event_fd_;
+  // Armed for wakeups in the future.
   fml::UniqueFD timer_fd_;
   bool running_;
+  // Whether |event_fd_| was signalled and the loop did not wake up for it yet.
+  std::atomic_bool event_pending_;
+  std::mutex timer_mutex_;
+  // The last time |timer_fd_| was armed for.
+  fml::TimePoint armed_time_;
 
   MessageLoopLinux();
 
@@ -29,9 +38,11 @@ class MessageLoopLinux : public MessageLoopImpl {
 
   void WakeUp(fml::TimePoint time_point) override;
 
-  void OnEventFired();
+  void OnEventFired(bool event_fired, bool timer_fired);
 
-  bool AddOrRemoveTimerSource(bool add);
+  void RearmTimer(fml::TimePoint time_point);
+
+  bool AddOrRemoveSource(int fd, bool add);
 
   FML_FRIEND_MAKE_REF_COUNTED(MessageLoopLinux);
   FML_FRIEND_REF_COUNTED_THREAD_SAFE(MessageLoopLinux);
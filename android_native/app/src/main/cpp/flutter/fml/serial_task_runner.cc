@@ -0,0 +1,117 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define FML_USED_ON_EMBEDDER
+
+#include "flutter/fml/serial_task_runner.h"
+
+#include <utility>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/message_loop_impl.h"
+
+namespace fml {
+
+fml::RefPtr<SerialTaskRunner> SerialTaskRunner::Create(
+    fml::RefPtr<TaskRunner> target) {
+  FML_DCHECK(target);
+  return fml::MakeRefCounted<SerialTaskRunner>(std::move(target));
+}
+
+SerialTaskRunner::SerialTaskRunner(fml::RefPtr<TaskRunner> target)
+    : TaskRunner(nullptr), target_(std::move(target)) {}
+
+SerialTaskRunner::~SerialTaskRunner() = default;
+
+void SerialTaskRunner::PostTask(fml::unique_closure task) {
+  PostTask(std::move(task), TaskPriority::kNormal);
+}
+
+TaskHandle SerialTaskRunner::PostTaskForTime(fml::unique_closure task,
+                                             fml::TimePoint target_time) {
+  return PostTaskForTime(std::move(task), target_time, TaskPriority::kNormal);
+}
+
+TaskHandle SerialTaskRunner::PostDelayedTask(fml::unique_closure task,
+                                             fml::TimeDelta delay) {
+  return PostDelayedTask(std::move(task), delay, TaskPriority::kNormal);
+}
+
+void SerialTaskRunner::PostTask(fml::unique_closure task,
+                                TaskPriority priority) {
+  FML_DCHECK(task != nullptr);
+  bool schedule = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Lane& lane = lanes_[static_cast<size_t>(priority)];
+    lane.tasks.emplace_back(std::move(task));
+    if (!lane.scheduled) {
+      lane.scheduled = true;
+      schedule = true;
+    }
+  }
+  if (schedule) {
+    ScheduleLane(priority);
+  }
+}
+
+TaskHandle SerialTaskRunner::PostTaskForTime(fml::unique_closure task,
+                                             fml::TimePoint target_time,
+                                             TaskPriority priority) {
+  // The task waits on |target_| so that its handle can cancel it and joins
+  // the queue of its lane once it is due.
+  return target_->PostTaskForTime(
+      [self = fml::Ref(this), task = std::move(task), priority]() mutable {
+        self->PostTask(std::move(task), priority);
+      },
+      target_time, priority);
+}
+
+TaskHandle SerialTaskRunner::PostDelayedTask(fml::unique_closure task,
+                                             fml::TimeDelta delay,
+                                             TaskPriority priority) {
+  return PostTaskForTime(std::move(task), fml::TimePoint::Now() + delay,
+                         priority);
+}
+
+bool SerialTaskRunner::RunsTasksOnCurrentThread() {
+  return target_->RunsTasksOnCurrentThread();
+}
+
+fml::RefPtr<TaskRunner> SerialTaskRunner::GetTargetTaskRunner() const {
+  return target_;
+}
+
+void SerialTaskRunner::ScheduleLane(TaskPriority priority) {
+  target_->PostTask(
+      [self = fml::Ref(this), priority]() { self->RunNextTask(priority); },
+      priority);
+}
+
+void SerialTaskRunner::RunNextTask(TaskPriority priority) {
+  fml::unique_closure task;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Lane& lane = lanes_[static_cast<size_t>(priority)];
+    FML_DCHECK(lane.scheduled && !lane.tasks.empty());
+    task = std::move(lane.tasks.front());
+    lane.tasks.pop_front();
+  }
+
+  task();
+
+  // Queue up behind the tasks other runners posted meanwhile.
+  bool schedule;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Lane& lane = lanes_[static_cast<size_t>(priority)];
+    lane.scheduled = !lane.tasks.empty();
+    schedule = lane.scheduled;
+  }
+  if (schedule) {
+    ScheduleLane(priority);
+  }
+}
+
+}  // namespace fml
@@ -0,0 +1,87 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_SERIAL_TASK_RUNNER_H_
+#define FLUTTER_FML_SERIAL_TASK_RUNNER_H_
+
+#include <array>
+#include <deque>
+#include <mutex>
+
+#include "flutter/fml/closure.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/ref_ptr.h"
+#include "flutter/fml/task_runner.h"
+
+namespace fml {
+
+// A queue of tasks multiplexed onto the thread of |target|, which other
+// serial task runners may share. Only one task of each priority lane is
+// handed to |target| at a time. So runners that share a thread take turns
+// task by task instead of one runner's backlog holding up the others.
+//
+// |target| must run its tasks on a single thread. Delayed tasks are queued
+// when they become due and can be cancelled through their handles.
+class SerialTaskRunner : public TaskRunner {
+ public:
+  static fml::RefPtr<SerialTaskRunner> Create(fml::RefPtr<TaskRunner> target);
+
+  // |fml::TaskRunner|
+  void PostTask(fml::unique_closure task) override;
+
+  // |fml::TaskRunner|
+  TaskHandle PostTaskForTime(fml::unique_closure task,
+                             fml::TimePoint target_time) override;
+
+  // |fml::TaskRunner|
+  TaskHandle PostDelayedTask(fml::unique_closure task,
+                             fml::TimeDelta delay) override;
+
+  // |fml::TaskRunner|
+  void PostTask(fml::unique_closure task, TaskPriority priority) override;
+
+  // |fml::TaskRunner|
+  TaskHandle PostTaskForTime(fml::unique_closure task,
+                             fml::TimePoint target_time,
+                             TaskPriority priority) override;
+
+  // |fml::TaskRunner|
+  TaskHandle PostDelayedTask(fml::unique_closure task,
+                             fml::TimeDelta delay,
+                             TaskPriority priority) override;
+
+  // |fml::TaskRunner|
+  bool RunsTasksOnCurrentThread() override;
+
+  // The runner the tasks are multiplexed onto.
+  fml::RefPtr<TaskRunner> GetTargetTaskRunner() const;
+
+ private:
+  struct Lane {
+    std::deque<fml::unique_closure> tasks;
+    // Whether a task that runs the next task of this lane is posted to
+    // |target_|.
+    bool scheduled = false;
+  };
+
+  const fml::RefPtr<TaskRunner> target_;
+  std::mutex mutex_;
+  std::array<Lane, kTaskPriorityCount> lanes_;
+
+  explicit SerialTaskRunner(fml::RefPtr<TaskRunner> target);
+
+  ~SerialTaskRunner() override;
+
+  void RunNextTask(TaskPriority priority);
+
+  void ScheduleLane(TaskPriority priority);
+
+  FML_FRIEND_MAKE_REF_COUNTED(SerialTaskRunner);
+  FML_FRIEND_REF_COUNTED_THREAD_SAFE(SerialTaskRunner);
+  FML_DISALLOW_COPY_AND_ASSIGN(SerialTaskRunner);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_SERIAL_TASK_RUNNER_H_
@@ -0,0 +1,70 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "flutter/fml/serial_task_runner.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+
+TEST(SerialTaskRunnerTest, RunsTasksInOrderOnTheTargetThread) {
+  fml::Thread thread("serial");
+  auto runner = SerialTaskRunner::Create(thread.GetTaskRunner());
+  ASSERT_EQ(runner->GetTargetTaskRunner(), thread.GetTaskRunner());
+  ASSERT_FALSE(runner->RunsTasksOnCurrentThread());
+
+  std::vector<int> order;
+  AutoResetWaitableEvent latch;
+  for (int i = 0; i < 10; i++) {
+    runner->PostTask([&order, runner, i]() {
+      ASSERT_TRUE(runner->RunsTasksOnCurrentThread());
+      order.push_back(i);
+    });
+  }
+  runner->PostTask([&latch]() { latch.Signal(); });
+  latch.Wait();
+  ASSERT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST(SerialTaskRunnerTest, RunnersSharingAThreadTakeTurns) {
+  fml::Thread thread("serial");
+  auto first = SerialTaskRunner::Create(thread.GetTaskRunner());
+  auto second = SerialTaskRunner::Create(thread.GetTaskRunner());
+
+  std::vector<int> order;
+  AutoResetWaitableEvent latch;
+  // Hold the thread so that both backlogs are queued before anything runs.
+  AutoResetWaitableEvent posted;
+  thread.GetTaskRunner()->PostTask([&posted]() { posted.Wait(); });
+  for (int i = 0; i < 3; i++) {
+    first->PostTask([&order]() { order.push_back(1); });
+  }
+  for (int i = 0; i < 3; i++) {
+    second->PostTask([&order]() { order.push_back(2); });
+  }
+  second->PostTask([&latch]() { latch.Signal(); });
+  posted.Signal();
+  latch.Wait();
+  ASSERT_EQ(order, (std::vector<int>{1, 2, 1, 2, 1, 2}));
+}
+
+TEST(SerialTaskRunnerTest, CanCancelDelayedTasks) {
+  fml::Thread thread("serial");
+  auto runner = SerialTaskRunner::Create(thread.GetTaskRunner());
+  bool ran = false;
+  auto handle = runner->PostDelayedTask([&ran]() { ran = true; },
+                                        fml::TimeDelta::FromMilliseconds(2));
+  ASSERT_TRUE(handle.Cancel());
+
+  AutoResetWaitableEvent latch;
+  runner->PostDelayedTask([&latch]() { latch.Signal(); },
+                          fml::TimeDelta::FromMilliseconds(10));
+  latch.Wait();
+  ASSERT_FALSE(ran);
+}
+
+}  // namespace fml
@@ -0,0 +1,116 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_SYNCHRONIZATION_FUTEX_H_
+#define FLUTTER_FML_SYNCHRONIZATION_FUTEX_H_
+
+#include <stdint.h>
+
+#include <atomic>
+
+#include "flutter/fml/build_config.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+
+#if OS_LINUX || OS_ANDROID
+#define FML_HAS_FUTEX 1
+#else
+#define FML_HAS_FUTEX 0
+#endif
+
+#if FML_HAS_FUTEX
+#include <errno.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+namespace fml {
+
+#if FML_HAS_FUTEX
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "Futexes operate on plain 32 bit words.");
+
+// Blocks while |*word| is |expected| till |FutexWake| is called on |word|.
+// May return spuriously. Returns false if |timeout| passed first. A negative
+// |timeout| waits forever.
+inline bool FutexWait(std::atomic<uint32_t>* word,
+                      uint32_t expected,
+                      TimeDelta timeout = TimeDelta::FromNanoseconds(-1)) {
+  struct timespec relative_timeout;
+  struct timespec* timeout_pointer = nullptr;
+  if (timeout >= TimeDelta::Zero()) {
+    relative_timeout = timeout.ToTimespec();
+    timeout_pointer = &relative_timeout;
+  }
+  const long result =
+      ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(word),
+                FUTEX_WAIT_PRIVATE, expected, timeout_pointer, nullptr, 0);
+  return result == 0 || errno != ETIMEDOUT;
+}
+
+// Wakes up to |count| threads blocked in |FutexWait| on |word|.
+inline void FutexWake(std::atomic<uint32_t>* word, int count) {
+  ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), FUTEX_WAKE_PRIVATE,
+            count, nullptr, nullptr, 0);
+}
+
+#endif  // FML_HAS_FUTEX
+
+// Tells the CPU that the calling thread is busy waiting.
+inline void CpuRelax() {
+#if defined(__i386__) || defined(__x86_64__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Spins for a while before a thread blocks. Waits that are over quickly skip
+// the syscalls and the context switches of blocking. The spin budget grows
+// while spinning pays off and shrinks while it does not, so waits that are
+// usually long barely spin. Thread-safe.
+class AdaptiveSpinner {
+ public:
+  static constexpr uint32_t kMinSpins = 16;
+  static constexpr uint32_t kMaxSpins = 4096;
+
+  AdaptiveSpinner() : spins_(kMinSpins * 4) {}
+
+  // Spins till |condition()| returns true or the budget is used up. Returns
+  // the last result of |condition()|.
+  template <typename Condition>
+  bool SpinUntil(Condition condition) {
+    const uint32_t budget = spins_.load(std::memory_order_relaxed);
+    for (uint32_t spin = 0; spin < budget; spin++) {
+      if (condition()) {
+        // Leave room for waits a little longer than this one.
+        uint32_t next = spin * 2 > budget ? budget * 2 : budget;
+        if (next > kMaxSpins) {
+          next = kMaxSpins;
+        }
+        spins_.store(next, std::memory_order_relaxed);
+        return true;
+      }
+      CpuRelax();
+    }
+    uint32_t next = budget / 2;
+    if (next < kMinSpins) {
+      next = kMinSpins;
+    }
+    spins_.store(next, std::memory_order_relaxed);
+    return condition();
+  }
+
+ private:
+  std::atomic<uint32_t> spins_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(AdaptiveSpinner);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_SYNCHRONIZATION_FUTEX_H_
@@ -0,0 +1,155 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_SYNCHRONIZATION_MPSC_QUEUE_H_
+#define FLUTTER_FML_SYNCHRONIZATION_MPSC_QUEUE_H_
+
+#include <stddef.h>
+
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "flutter/fml/macros.h"
+
+namespace fml {
+
+// A lock-free queue that any number of threads may push to and a single
+// thread drains. Producers link their item to the head of a list with a
+// compare-and-swap. The consumer takes the whole list with one exchange and
+// reverses it. So items pushed by one thread are drained in the order they
+// were pushed. Drained nodes are kept on a free list for later pushes, so a
+// steady stream of items does not allocate.
+template <typename T>
+class MpscQueue {
+ public:
+  // The most nodes kept on the free list. The rest are deleted once drained.
+  static constexpr size_t kMaxFreeNodes = 64;
+
+  MpscQueue() : head_(nullptr), free_(nullptr), free_count_(0) {}
+
+  ~MpscQueue() {
+    Node* list = head_.exchange(nullptr);
+    while (list != nullptr) {
+      Node* next = list->next;
+      list->item().~T();
+      delete list;
+      list = next;
+    }
+    list = free_.exchange(nullptr);
+    while (list != nullptr) {
+      Node* next = list->next;
+      delete list;
+      list = next;
+    }
+  }
+
+  // Can be called on any thread. Returns true if the queue was empty before
+  // this push. Exactly one of the pushes made since the last drain returns
+  // true. So that producer can be the only one to notify the consumer.
+  bool Push(T item) {
+    Node* node = TakeFreeNode();
+    if (node == nullptr) {
+      node = new Node();
+    }
+    new (&node->storage) T(std::move(item));
+    node->next = head_.load(std::memory_order_relaxed);
+    while (!head_.compare_exchange_weak(node->next, node)) {
+    }
+    return node->next == nullptr;
+  }
+
+  // Must only be called on the consumer thread. Calls |consumer| with every
+  // item pushed till now and returns the number of items drained.
+  template <typename Consumer>
+  size_t Drain(Consumer consumer) {
+    Node* list = head_.exchange(nullptr);
+    if (list == nullptr) {
+      return 0;
+    }
+
+    // The list is newest first.
+    Node* oldest = nullptr;
+    while (list != nullptr) {
+      Node* next = list->next;
+      list->next = oldest;
+      oldest = list;
+      list = next;
+    }
+
+    size_t count = 0;
+    while (oldest != nullptr) {
+      Node* next = oldest->next;
+      consumer(std::move(oldest->item()));
+      oldest->item().~T();
+      RecycleNode(oldest);
+      oldest = next;
+      count++;
+    }
+    return count;
+  }
+
+  // The result may be stale by the time it is used unless all producers are
+  // known to be done.
+  bool IsEmpty() const { return head_.load() == nullptr; }
+
+ private:
+  // The item is only constructed while the node is in the queue.
+  struct Node {
+    Node* next = nullptr;
+    std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+
+    T& item() { return *reinterpret_cast<T*>(&storage); }
+  };
+
+  std::atomic<Node*> head_;
+  // Pushed to by the consumer only. Producers pop one node at a time while
+  // holding |free_lock_|. A node cannot be popped and pushed again while
+  // another producer reads its link, which rules out the ABA problem.
+  std::atomic<Node*> free_;
+  std::atomic_flag free_lock_ = ATOMIC_FLAG_INIT;
+  // Approximate. Only bounds the size of the free list.
+  std::atomic<size_t> free_count_;
+
+  // Returns nullptr if the free list is empty or another producer is
+  // popping from it. Producers allocate instead of waiting for each other.
+  Node* TakeFreeNode() {
+    if (free_lock_.test_and_set(std::memory_order_acquire)) {
+      return nullptr;
+    }
+    Node* node = free_.load(std::memory_order_acquire);
+    while (node != nullptr &&
+           !free_.compare_exchange_weak(node, node->next,
+                                        std::memory_order_acquire)) {
+    }
+    free_lock_.clear(std::memory_order_release);
+    if (node != nullptr) {
+      free_count_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return node;
+  }
+
+  void RecycleNode(Node* node) {
+    if (free_count_.load(std::memory_order_relaxed) >= kMaxFreeNodes) {
+      delete node;
+      return;
+    }
+    free_count_.fetch_add(1, std::memory_order_relaxed);
+    node->next = free_.load(std::memory_order_relaxed);
+    while (!free_.compare_exchange_weak(node->next, node,
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed)) {
+    }
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(MpscQueue);
+};
+
+template <typename T>
+constexpr size_t MpscQueue<T>::kMaxFreeNodes;
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_SYNCHRONIZATION_MPSC_QUEUE_H_
@@ -0,0 +1,89 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "flutter/fml/synchronization/mpsc_queue.h"
+#include "flutter/testing/testing.h"
+
+namespace fml {
+
+TEST(MpscQueueTest, DrainsInPushOrder) {
+  MpscQueue<int> queue;
+  ASSERT_TRUE(queue.IsEmpty());
+  ASSERT_TRUE(queue.Push(1));
+  ASSERT_FALSE(queue.Push(2));
+  ASSERT_FALSE(queue.Push(3));
+  ASSERT_FALSE(queue.IsEmpty());
+
+  std::vector<int> items;
+  ASSERT_EQ(queue.Drain([&items](int item) { items.push_back(item); }), 3u);
+  ASSERT_EQ(items, (std::vector<int>{1, 2, 3}));
+  ASSERT_TRUE(queue.IsEmpty());
+  ASSERT_EQ(queue.Drain([](int) {}), 0u);
+
+  // The next push after a drain is the first again.
+  ASSERT_TRUE(queue.Push(4));
+}
+
+TEST(MpscQueueTest, CollectsUndrainedItems) {
+  auto item = std::make_shared<int>(1);
+  {
+    MpscQueue<std::shared_ptr<int>> queue;
+    queue.Push(item);
+    queue.Push(item);
+    ASSERT_EQ(item.use_count(), 3);
+  }
+  ASSERT_EQ(item.use_count(), 1);
+}
+
+TEST(MpscQueueTest, DestroysItemsOnceDrained) {
+  auto item = std::make_shared<int>(1);
+  MpscQueue<std::shared_ptr<int>> queue;
+  for (size_t round = 0; round < 3; round++) {
+    queue.Push(item);
+    queue.Push(item);
+    ASSERT_EQ(item.use_count(), 3);
+    // The consumer drops its copies right away. The recycled nodes must not
+    // keep any either.
+    ASSERT_EQ(queue.Drain([](std::shared_ptr<int>) {}), 2u);
+    ASSERT_EQ(item.use_count(), 1);
+  }
+}
+
+TEST(MpscQueueTest, KeepsTheOrderOfEachProducer) {
+  const size_t producer_count = 4;
+  const size_t items_per_producer = 10000;
+  MpscQueue<std::pair<size_t, size_t>> queue;
+
+  std::vector<std::thread> producers;
+  for (size_t producer = 0; producer < producer_count; producer++) {
+    producers.emplace_back([&queue, producer]() {
+      for (size_t i = 0; i < items_per_producer; i++) {
+        queue.Push({producer, i});
+      }
+    });
+  }
+
+  std::vector<size_t> next(producer_count, 0);
+  size_t drained = 0;
+  while (drained < producer_count * items_per_producer) {
+    drained += queue.Drain([&next](std::pair<size_t, size_t> item) {
+      ASSERT_EQ(item.second, next[item.first]);
+      next[item.first]++;
+    });
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  ASSERT_TRUE(queue.IsEmpty());
+  for (size_t count : next) {
+    ASSERT_EQ(count, items_per_producer);
+  }
+}
+
+}  // namespace fml
@@ -4,15 +4,194 @@
 
 #include "flutter/fml/synchronization/waitable_event.h"
 
+#include <algorithm>
+
 #include "flutter/fml/logging.h"
 #include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/time/time_point.h"
 
 #include <errno.h>
+#include <limits.h>
 #include <time.h>
 
 namespace fml {
 
+#if FML_HAS_FUTEX
+
+namespace {
+
+// Bits of the futex words of the events.
+constexpr uint32_t kSignaled = 1u;
+// |AutoResetWaitableEvent|: a waiter.
+constexpr uint32_t kWaiter = 2u;
+// |ManualResetWaitableEvent|: there may be waiters and a signal.
+constexpr uint32_t kHasWaiters = 2u;
+constexpr uint32_t kSignalShift = 2u;
+
+TimePoint DeadlineAfter(TimeDelta timeout) {
+  return timeout >= TimePoint::Max() - TimePoint::Now()
+             ? TimePoint::Max()
+             : TimePoint::Now() + timeout;
+}
+
+// Returns the timeout for |FutexWait()|, which may have passed already.
+TimeDelta TimeoutUntil(TimePoint deadline) {
+  if (deadline == TimePoint::Max()) {
+    return TimeDelta::FromNanoseconds(-1);
+  }
+  return std::max(deadline - TimePoint::Now(), TimeDelta::Zero());
+}
+
+bool TryConsumeSignal(std::atomic<uint32_t>* state) {
+  uint32_t value = state->load(std::memory_order_relaxed);
+  while (value & kSignaled) {
+    if (state->compare_exchange_weak(value, value & ~kSignaled,
+                                     std::memory_order_acquire,
+                                     std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Waits for and consumes a signal of an auto reset event. Returns true if
+// |deadline| passed first.
+bool WaitForAutoReset(std::atomic<uint32_t>* state,
+                      AdaptiveSpinner* spinner,
+                      TimePoint deadline) {
+  if (TryConsumeSignal(state)) {
+    return false;
+  }
+  if (spinner->SpinUntil([state]() {
+        return (state->load(std::memory_order_relaxed) & kSignaled) != 0;
+      }) &&
+      TryConsumeSignal(state)) {
+    return false;
+  }
+
+  uint32_t value = state->fetch_add(kWaiter, std::memory_order_relaxed);
+  value += kWaiter;
+  while (true) {
+    if (value & kSignaled) {
+      // Consume the signal and leave in one step.
+      if (state->compare_exchange_weak(value, (value & ~kSignaled) - kWaiter,
+                                       std::memory_order_acquire,
+                                       std::memory_order_relaxed)) {
+        return false;
+      }
+      continue;
+    }
+    const TimeDelta timeout = TimeoutUntil(deadline);
+    if (timeout == TimeDelta::Zero()) {
+      if (state->compare_exchange_weak(value, value - kWaiter,
+                                       std::memory_order_relaxed)) {
+        return true;
+      }
+      continue;
+    }
+    FutexWait(state, value, timeout);
+    value = state->load(std::memory_order_relaxed);
+  }
+}
+
+// Waits for the next signal of a manual reset event. Returns true if
+// |deadline| passed first.
+bool WaitForManualReset(std::atomic<uint32_t>* state,
+                        AdaptiveSpinner* spinner,
+                        TimePoint deadline) {
+  uint32_t value = state->load(std::memory_order_acquire);
+  if (value & kSignaled) {
+    return false;
+  }
+  // Resets leave the word of an unsignaled event be. So it only moves on with
+  // the next |Signal()|.
+  const uint32_t signal_id = value >> kSignalShift;
+  if (spinner->SpinUntil([state, signal_id]() {
+        return state->load(std::memory_order_acquire) >> kSignalShift !=
+               signal_id;
+      })) {
+    return false;
+  }
+
+  value = state->load(std::memory_order_acquire);
+  while (value >> kSignalShift == signal_id) {
+    if (!(value & kHasWaiters) &&
+        !state->compare_exchange_weak(value, value | kHasWaiters,
+                                      std::memory_order_acquire)) {
+      continue;
+    }
+    const TimeDelta timeout = TimeoutUntil(deadline);
+    if (timeout == TimeDelta::Zero()) {
+      return true;
+    }
+    FutexWait(state, value | kHasWaiters, timeout);
+    value = state->load(std::memory_order_acquire);
+  }
+  return false;
+}
+
+}  // namespace
+
+// AutoResetWaitableEvent ------------------------------------------------------
+
+void AutoResetWaitableEvent::Signal() {
+  // The waiter may destroy this event as soon as the signal is visible. So
+  // only the address of |state_| is used afterwards.
+  const uint32_t value =
+      state_.fetch_or(kSignaled, std::memory_order_release);
+  if (!(value & kSignaled) && value >= kWaiter) {
+    FutexWake(&state_, 1);
+  }
+}
+
+void AutoResetWaitableEvent::Reset() {
+  state_.fetch_and(~kSignaled, std::memory_order_relaxed);
+}
+
+void AutoResetWaitableEvent::Wait() {
+  WaitForAutoReset(&state_, &spinner_, TimePoint::Max());
+}
+
+bool AutoResetWaitableEvent::WaitWithTimeout(TimeDelta timeout) {
+  return WaitForAutoReset(&state_, &spinner_, DeadlineAfter(timeout));
+}
+
+bool AutoResetWaitableEvent::IsSignaledForTest() {
+  return (state_.load() & kSignaled) != 0;
+}
+
+// ManualResetWaitableEvent ----------------------------------------------------
+
+void ManualResetWaitableEvent::Signal() {
+  uint32_t value = state_.load(std::memory_order_relaxed);
+  while (!state_.compare_exchange_weak(
+      value,
+      ((value & ~kHasWaiters) + (1u << kSignalShift)) | kSignaled,
+      std::memory_order_release, std::memory_order_relaxed)) {
+  }
+  if (value & kHasWaiters) {
+    FutexWake(&state_, INT_MAX);
+  }
+}
+
+void ManualResetWaitableEvent::Reset() {
+  state_.fetch_and(~kSignaled, std::memory_order_relaxed);
+}
+
+void ManualResetWaitableEvent::Wait() {
+  WaitForManualReset(&state_, &spinner_, TimePoint::Max());
+}
+
+bool ManualResetWaitableEvent::WaitWithTimeout(TimeDelta timeout) {
+  return WaitForManualReset(&state_, &spinner_, DeadlineAfter(timeout));
+}
+
+bool ManualResetWaitableEvent::IsSignaledForTest() {
+  return (state_.load() & kSignaled) != 0;
+}
+
+#else  // FML_HAS_FUTEX
+
 // Waits with a timeout on |condition()|. Returns true on timeout, or false if
 // |condition()| ever returns true. |condition()| should have no side effects
 // (and will always be called with |*mutex| held).
@@ -164,4 +343,6 @@ bool ManualResetWaitableEvent::IsSignaledForTest() {
   return signaled_;
 }
 
+#endif  // FML_HAS_FUTEX
+
 }  // namespace fml
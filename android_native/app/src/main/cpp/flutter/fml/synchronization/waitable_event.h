@@ -10,10 +10,14 @@
 #ifndef FLUTTER_FML_SYNCHRONIZATION_WAITABLE_EVENT_H_
 #define FLUTTER_FML_SYNCHRONIZATION_WAITABLE_EVENT_H_
 
+#include <stdint.h>
+
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 
 #include "flutter/fml/macros.h"
+#include "flutter/fml/synchronization/futex.h"
 #include "flutter/fml/synchronization/thread_annotations.h"
 #include "flutter/fml/time/time_delta.h"
 
@@ -25,7 +29,9 @@ namespace fml {
 // returns to the unsignaled state after unblocking one waiter. (This is similar
 // to Windows's auto-reset Event, which is also imitated by Chromium's
 // auto-reset |base::WaitableEvent|. However, there are some limitations -- see
-// |Signal()|.) This class is thread-safe.
+// |Signal()|.) On Linux and Android, waits spin briefly and then block on a
+// futex, so neither |Signal()| nor an uncontended |Wait()| takes a lock. This
+// class is thread-safe.
 class AutoResetWaitableEvent final {
  public:
   AutoResetWaitableEvent() {}
@@ -39,7 +45,7 @@ class AutoResetWaitableEvent final {
   //   call to |Signal()|.
   // * A |Signal()|, followed by a |Reset()|, may cause *no* waiting thread to
   //   be unblocked.
-  // * We rely on pthreads's queueing for picking which waiting thread to
+  // * We rely on the platform's queueing for picking which waiting thread to
   //   unblock, rather than enforcing FIFO ordering.
   void Signal();
 
@@ -63,11 +69,21 @@ class AutoResetWaitableEvent final {
   bool IsSignaledForTest();
 
  private:
+#if FML_HAS_FUTEX
+  // Bit 0 is set while this event is in the signaled state. The remaining
+  // bits count the threads blocked or about to block on this futex word, so
+  // |Signal()| skips the wake-up syscall while there are none. Keeping both in
+  // one word lets a waiter destroy the event as soon as it was released.
+  std::atomic<uint32_t> state_ = {0};
+
+  AdaptiveSpinner spinner_;
+#else
   std::condition_variable cv_;
   std::mutex mutex_;
 
   // True if this event is in the signaled state.
   bool signaled_ = false;
+#endif
 
   FML_DISALLOW_COPY_AND_ASSIGN(AutoResetWaitableEvent);
 };
@@ -77,6 +93,7 @@ class AutoResetWaitableEvent final {
 // An event that can be signaled and waited on. This version remains signaled
 // until explicitly reset. (This is similar to Windows's manual-reset Event,
 // which is also imitated by Chromium's manual-reset |base::WaitableEvent|.)
+// Like |AutoResetWaitableEvent|, it is built on a futex on Linux and Android.
 // This class is thread-safe.
 class ManualResetWaitableEvent final {
  public:
@@ -105,6 +122,15 @@ class ManualResetWaitableEvent final {
   bool IsSignaledForTest();
 
  private:
+#if FML_HAS_FUTEX
+  // Bit 0 is set while this event is in the signaled state and bit 1 while
+  // threads may be blocked on this futex word. The remaining bits count the
+  // calls to |Signal()|, so a waiter can tell it was signaled even if the
+  // event was reset again before it woke up.
+  std::atomic<uint32_t> state_ = {0};
+
+  AdaptiveSpinner spinner_;
+#else
   std::condition_variable cv_;
   std::mutex mutex_;
 
@@ -119,6 +145,7 @@ class ManualResetWaitableEvent final {
   // |std::condition_variable::notify_all()|. A waiting thread knows it was
   // awoken if |signal_id_| is different from when it started waiting.
   unsigned signal_id_ = 0u;
+#endif
 
   FML_DISALLOW_COPY_AND_ASSIGN(ManualResetWaitableEvent);
 };
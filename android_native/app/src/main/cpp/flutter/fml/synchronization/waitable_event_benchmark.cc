@@ -0,0 +1,130 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "benchmark/benchmark.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+
+namespace fml {
+namespace {
+
+// The mutex and condition variable event that |AutoResetWaitableEvent| uses
+// where there are no futexes. The baseline for the benchmarks below.
+class CondVarAutoResetEvent {
+ public:
+  CondVarAutoResetEvent() = default;
+
+  void Signal() {
+    std::lock_guard<std::mutex> locker(mutex_);
+    signaled_ = true;
+    cv_.notify_one();
+  }
+
+  void Wait() {
+    std::unique_lock<std::mutex> locker(mutex_);
+    while (!signaled_)
+      cv_.wait(locker);
+    signaled_ = false;
+  }
+
+ private:
+  std::condition_variable cv_;
+  std::mutex mutex_;
+  bool signaled_ = false;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(CondVarAutoResetEvent);
+};
+
+// The cost of an event nobody else is waiting on.
+template <typename Event>
+void BM_SignalWaitUncontended(benchmark::State& state) {
+  Event event;
+  for (auto _ : state) {
+    event.Signal();
+    event.Wait();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_TEMPLATE(BM_SignalWaitUncontended, AutoResetWaitableEvent);
+BENCHMARK_TEMPLATE(BM_SignalWaitUncontended, CondVarAutoResetEvent);
+
+// Hands control back and forth between two threads. Half of an iteration is
+// the time from a signal to the wake-up of its waiter.
+template <typename Event>
+void BM_SignalToWakeLatency(benchmark::State& state) {
+  Event ping;
+  Event pong;
+  std::atomic_bool done(false);
+  std::thread thread([&]() {
+    while (true) {
+      ping.Wait();
+      if (done.load(std::memory_order_relaxed)) {
+        return;
+      }
+      pong.Signal();
+    }
+  });
+  for (auto _ : state) {
+    ping.Signal();
+    pong.Wait();
+  }
+  done = true;
+  ping.Signal();
+  thread.join();
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+
+BENCHMARK_TEMPLATE(BM_SignalToWakeLatency, AutoResetWaitableEvent)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SignalToWakeLatency, CondVarAutoResetEvent)
+    ->UseRealTime();
+
+void BM_ManualResetWaitableEventWaitSignaled(benchmark::State& state) {
+  ManualResetWaitableEvent event;
+  event.Signal();
+  for (auto _ : state) {
+    event.Wait();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_ManualResetWaitableEventWaitSignaled);
+
+// A latch that is counted down by another thread than the one waiting on it.
+void BM_CountDownLatchRoundTrip(benchmark::State& state) {
+  AutoResetWaitableEvent start;
+  std::atomic<CountDownLatch*> latch(nullptr);
+  std::thread thread([&]() {
+    while (true) {
+      start.Wait();
+      CountDownLatch* current = latch.load();
+      if (current == nullptr) {
+        return;
+      }
+      current->CountDown();
+    }
+  });
+  for (auto _ : state) {
+    CountDownLatch current(1);
+    latch = &current;
+    start.Signal();
+    current.Wait();
+  }
+  latch = nullptr;
+  start.Signal();
+  thread.join();
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_CountDownLatchRoundTrip)->UseRealTime();
+
+}  // namespace
+}  // namespace fml
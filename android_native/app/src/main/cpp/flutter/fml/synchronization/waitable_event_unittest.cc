@@ -129,6 +129,31 @@ TEST(AutoResetWaitableEventTest, MultipleWaiters) {
   }
 }
 
+TEST(AutoResetWaitableEventTest, PingPong) {
+  // Quick hand-offs are caught while spinning, slower ones while blocked.
+  AutoResetWaitableEvent ping;
+  AutoResetWaitableEvent pong;
+  constexpr size_t kRoundTrips = 10000u;
+
+  std::thread thread([&ping, &pong]() {
+    for (size_t i = 0u; i < kRoundTrips; i++) {
+      ping.Wait();
+      if (i % 1000u == 0u)
+        EpsilonRandomSleep();
+      pong.Signal();
+    }
+  });
+
+  for (size_t i = 0u; i < kRoundTrips; i++) {
+    ping.Signal();
+    EXPECT_FALSE(pong.WaitWithTimeout(kActionTimeout));
+  }
+  thread.join();
+
+  EXPECT_FALSE(ping.IsSignaledForTest());
+  EXPECT_FALSE(pong.IsSignaledForTest());
+}
+
 // ManualResetWaitableEvent ----------------------------------------------------
 
 TEST(ManualResetWaitableEventTest, Basic) {
@@ -183,5 +208,32 @@ TEST(ManualResetWaitableEventTest, SignalMultiple) {
   }
 }
 
+TEST(ManualResetWaitableEventTest, SignalThenResetWakesWaiters) {
+  ManualResetWaitableEvent ev;
+  std::atomic_uint wake_count(0u);
+
+  std::vector<std::thread> threads;
+  for (size_t j = 0u; j < 4u; j++) {
+    threads.push_back(std::thread([&ev, &wake_count]() {
+      if (rand() % 2 == 0)
+        ev.Wait();
+      else
+        EXPECT_FALSE(ev.WaitWithTimeout(kActionTimeout));
+      wake_count.fetch_add(1u);
+    }));
+  }
+
+  SleepFor(kTinyTimeout);
+
+  // The waiters were signaled even if they only wake up after the reset.
+  ev.Signal();
+  ev.Reset();
+
+  for (auto& thread : threads)
+    thread.join();
+  EXPECT_EQ(4u, wake_count.load());
+  EXPECT_FALSE(ev.IsSignaledForTest());
+}
+
 }  // namespace
 }  // namespace fml
@@ -0,0 +1,61 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define FML_USED_ON_EMBEDDER
+
+#include "flutter/fml/task_handle.h"
+
+#include <utility>
+
+#include "flutter/fml/message_loop_impl.h"
+
+namespace fml {
+
+TaskHandle::TaskHandle() : priority_(TaskPriority::kNormal), order_(0) {}
+
+TaskHandle::TaskHandle(fml::RefPtr<MessageLoopImpl> loop,
+                       TaskPriority priority,
+                       fml::TimePoint target_time,
+                       size_t order)
+    : loop_(std::move(loop)),
+      priority_(priority),
+      target_time_(target_time),
+      order_(order) {}
+
+TaskHandle::TaskHandle(TaskHandle&& other)
+    : loop_(std::move(other.loop_)),
+      priority_(other.priority_),
+      target_time_(other.target_time_),
+      order_(other.order_) {}
+
+TaskHandle& TaskHandle::operator=(TaskHandle&& other) {
+  loop_ = std::move(other.loop_);
+  priority_ = other.priority_;
+  target_time_ = other.target_time_;
+  order_ = other.order_;
+  return *this;
+}
+
+TaskHandle::~TaskHandle() = default;
+
+bool TaskHandle::Cancel() {
+  if (!loop_) {
+    return false;
+  }
+  auto loop = std::move(loop_);
+  return loop->CancelTask(priority_, target_time_, order_);
+}
+
+bool TaskHandle::Reschedule(fml::TimePoint target_time) {
+  if (!loop_) {
+    return false;
+  }
+  if (!loop_->RescheduleTask(priority_, target_time_, order_, target_time)) {
+    return false;
+  }
+  target_time_ = target_time;
+  return true;
+}
+
+}  // namespace fml
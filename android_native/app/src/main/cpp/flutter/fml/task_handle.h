@@ -0,0 +1,63 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_TASK_HANDLE_H_
+#define FLUTTER_FML_TASK_HANDLE_H_
+
+#include <cstddef>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/ref_ptr.h"
+#include "flutter/fml/task_priority.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace fml {
+
+class MessageLoopImpl;
+
+// Refers to a task posted for a later time so that it can be cancelled or
+// moved before it runs. Tasks that are due when they are posted get an empty
+// handle since they are about to run anyway. Collecting the handle does not
+// cancel the task.
+class TaskHandle {
+ public:
+  TaskHandle();
+
+  TaskHandle(TaskHandle&& other);
+
+  TaskHandle& operator=(TaskHandle&& other);
+
+  ~TaskHandle();
+
+  // Removes the task from its message loop and collects it on the calling
+  // thread. Returns false if the task already ran, is running or the handle
+  // is empty. The handle is empty afterwards.
+  bool Cancel();
+
+  // Makes the task run at |target_time| instead. Returns false if the task
+  // already ran, is running or the handle is empty.
+  bool Reschedule(fml::TimePoint target_time);
+
+  // Whether the handle refers to a task. The task may have run already.
+  explicit operator bool() const { return static_cast<bool>(loop_); }
+
+ private:
+  friend class MessageLoopImpl;
+
+  fml::RefPtr<MessageLoopImpl> loop_;
+  TaskPriority priority_;
+  fml::TimePoint target_time_;
+  size_t order_;
+
+  TaskHandle(fml::RefPtr<MessageLoopImpl> loop,
+             TaskPriority priority,
+             fml::TimePoint target_time,
+             size_t order);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TaskHandle);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_TASK_HANDLE_H_
@@ -0,0 +1,31 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_TASK_PRIORITY_H_
+#define FLUTTER_FML_TASK_PRIORITY_H_
+
+#include <stddef.h>
+
+namespace fml {
+
+// The lane a task is queued in. Of the tasks that are due, the ones in higher
+// priority lanes run first. Lower lanes are guaranteed to make progress
+// eventually. See |MessageLoopImpl::kMaxStarvedTasks|.
+enum class TaskPriority {
+  // Input events. Latency is directly visible to the user.
+  kInput,
+  // Work needed to produce the next frame, like vsync callbacks and draws.
+  kFrame,
+  // Everything else.
+  kNormal,
+  // Work that is only worth doing when nothing else is pending, like idle
+  // notifications.
+  kIdle,
+};
+
+constexpr size_t kTaskPriorityCount = 4;
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_TASK_PRIORITY_H_
@@ -19,17 +19,35 @@ TaskRunner::TaskRunner(fml::RefPtr<MessageLoopImpl> loop)
 
 TaskRunner::~TaskRunner() = default;
 
-void TaskRunner::PostTask(fml::closure task) {
+void TaskRunner::PostTask(fml::unique_closure task) {
   loop_->PostTask(std::move(task), fml::TimePoint::Now());
 }
 
-void TaskRunner::PostTaskForTime(fml::closure task,
-                                 fml::TimePoint target_time) {
-  loop_->PostTask(std::move(task), target_time);
+TaskHandle TaskRunner::PostTaskForTime(fml::unique_closure task,
+                                       fml::TimePoint target_time) {
+  return loop_->PostTask(std::move(task), target_time);
 }
 
-void TaskRunner::PostDelayedTask(fml::closure task, fml::TimeDelta delay) {
-  loop_->PostTask(std::move(task), fml::TimePoint::Now() + delay);
+TaskHandle TaskRunner::PostDelayedTask(fml::unique_closure task,
+                                       fml::TimeDelta delay) {
+  return loop_->PostTask(std::move(task), fml::TimePoint::Now() + delay);
+}
+
+void TaskRunner::PostTask(fml::unique_closure task, TaskPriority priority) {
+  loop_->PostTask(std::move(task), fml::TimePoint::Now(), priority);
+}
+
+TaskHandle TaskRunner::PostTaskForTime(fml::unique_closure task,
+                                       fml::TimePoint target_time,
+                                       TaskPriority priority) {
+  return loop_->PostTask(std::move(task), target_time, priority);
+}
+
+TaskHandle TaskRunner::PostDelayedTask(fml::unique_closure task,
+                                       fml::TimeDelta delay,
+                                       TaskPriority priority) {
+  return loop_->PostTask(std::move(task), fml::TimePoint::Now() + delay,
+                         priority);
 }
 
 bool TaskRunner::RunsTasksOnCurrentThread() {
@@ -40,7 +58,7 @@ bool TaskRunner::RunsTasksOnCurrentThread() {
 }
 
 void TaskRunner::RunNowOrPostTask(fml::RefPtr<fml::TaskRunner> runner,
-                                  fml::closure task) {
+                                  fml::unique_closure task) {
   FML_DCHECK(runner);
   if (runner->RunsTasksOnCurrentThread()) {
     task();
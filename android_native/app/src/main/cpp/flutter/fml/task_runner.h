@@ -9,6 +9,8 @@
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/memory/ref_ptr.h"
+#include "flutter/fml/task_handle.h"
+#include "flutter/fml/task_priority.h"
 #include "flutter/fml/time/time_point.h"
 
 namespace fml {
@@ -17,18 +19,34 @@ class MessageLoopImpl;
 
 class TaskRunner : public fml::RefCountedThreadSafe<TaskRunner> {
  public:
-  virtual void PostTask(fml::closure task);
+  virtual void PostTask(fml::unique_closure task);
 
-  virtual void PostTaskForTime(fml::closure task, fml::TimePoint target_time);
+  // The returned handle cancels or reschedules the task. It is empty if the
+  // task was due when posted.
+  virtual TaskHandle PostTaskForTime(fml::unique_closure task,
+                                     fml::TimePoint target_time);
 
-  virtual void PostDelayedTask(fml::closure task, fml::TimeDelta delay);
+  virtual TaskHandle PostDelayedTask(fml::unique_closure task,
+                                     fml::TimeDelta delay);
+
+  // Like the above but queue the task in the lane of |priority|. The tasks
+  // posted without a priority are |TaskPriority::kNormal|.
+  virtual void PostTask(fml::unique_closure task, TaskPriority priority);
+
+  virtual TaskHandle PostTaskForTime(fml::unique_closure task,
+                                     fml::TimePoint target_time,
+                                     TaskPriority priority);
+
+  virtual TaskHandle PostDelayedTask(fml::unique_closure task,
+                                     fml::TimeDelta delay,
+                                     TaskPriority priority);
 
   virtual bool RunsTasksOnCurrentThread();
 
   virtual ~TaskRunner();
 
   static void RunNowOrPostTask(fml::RefPtr<fml::TaskRunner> runner,
-                               fml::closure task);
+                               fml::unique_closure task);
 
  protected:
   TaskRunner(fml::RefPtr<MessageLoopImpl> loop);
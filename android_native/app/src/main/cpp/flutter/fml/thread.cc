@@ -14,25 +14,39 @@
 #include <pthread.h>
 #endif
 
+#if OS_LINUX || OS_ANDROID
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstring>
 #include <memory>
 #include <string>
 
+#include "flutter/fml/logging.h"
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/trace_recorder.h"
 
 namespace fml {
 
-Thread::Thread(const std::string& name) : joined_(false) {
+Thread::Thread(const std::string& name, const ThreadConfig& config)
+    : joined_(false) {
   fml::AutoResetWaitableEvent latch;
   fml::RefPtr<fml::TaskRunner> runner;
-  thread_ = std::make_unique<std::thread>([&latch, &runner, name]() -> void {
-    SetCurrentThreadName(name);
-    fml::MessageLoop::EnsureInitializedForCurrentThread();
-    auto& loop = MessageLoop::GetCurrent();
-    runner = loop.GetTaskRunner();
-    latch.Signal();
-    loop.Run();
-  });
+  thread_ = std::make_unique<std::thread>(
+      [&latch, &runner, name, config]() -> void {
+        SetCurrentThreadName(name);
+        SetCurrentThreadConfig(config);
+        fml::MessageLoop::EnsureInitializedForCurrentThread();
+        auto& loop = MessageLoop::GetCurrent();
+        runner = loop.GetTaskRunner();
+        latch.Signal();
+        loop.Run();
+      });
   latch.Wait();
   task_runner_ = runner;
 }
@@ -70,6 +84,7 @@ void Thread::SetCurrentThreadName(const std::string& name) {
   if (name == "") {
     return;
   }
+  fml::tracing::TraceRecorder::GetInstance().SetCurrentThreadName(name);
 #if OS_MACOSX
   pthread_setname_np(name.c_str());
 #elif OS_LINUX || OS_ANDROID
@@ -91,4 +106,84 @@ void Thread::SetCurrentThreadName(const std::string& name) {
 #endif
 }
 
+bool Thread::SetCurrentThreadConfig(const ThreadConfig& config) {
+  if (config.IsDefault()) {
+    return true;
+  }
+#if OS_LINUX || OS_ANDROID
+  bool applied = true;
+
+  const ThreadConfig::Policy config_policy =
+      config.policy == ThreadConfig::Policy::kDefault && config.nice != 0
+          ? ThreadConfig::Policy::kNormal
+          : config.policy;
+  if (config_policy != ThreadConfig::Policy::kDefault) {
+    int policy = SCHED_OTHER;
+    sched_param param = {};
+    switch (config_policy) {
+      case ThreadConfig::Policy::kDefault:
+      case ThreadConfig::Policy::kNormal:
+        policy = SCHED_OTHER;
+        break;
+      case ThreadConfig::Policy::kBatch:
+        policy = SCHED_BATCH;
+        break;
+      case ThreadConfig::Policy::kIdle:
+        policy = SCHED_IDLE;
+        break;
+      case ThreadConfig::Policy::kFifo:
+        policy = SCHED_FIFO;
+        param.sched_priority = config.realtime_priority;
+        break;
+      case ThreadConfig::Policy::kRoundRobin:
+        policy = SCHED_RR;
+        param.sched_priority = config.realtime_priority;
+        break;
+    }
+    int result = pthread_setschedparam(pthread_self(), policy, &param);
+    if (result != 0) {
+      FML_LOG(ERROR) << "Could not set the scheduling policy " << policy
+                     << " of the thread: " << strerror(result);
+      applied = false;
+    }
+    // The nice value is per thread on Linux.
+    if (result == 0 && (policy == SCHED_OTHER || policy == SCHED_BATCH) &&
+        ::setpriority(PRIO_PROCESS, ::syscall(SYS_gettid), config.nice) != 0) {
+      FML_LOG(ERROR) << "Could not set the nice value " << config.nice
+                     << " of the thread: " << strerror(errno);
+      applied = false;
+    }
+  }
+
+  if (config.cpu_affinity_mask != 0) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (size_t cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; cpu++) {
+      if (config.cpu_affinity_mask & (uint64_t{1} << cpu)) {
+        CPU_SET(cpu, &cpus);
+      }
+    }
+    // Zero is the calling thread.
+    if (::sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+      FML_LOG(ERROR) << "Could not set the CPU affinity of the thread: "
+                     << strerror(errno);
+      applied = false;
+    }
+  }
+
+  return applied;
+#else
+  FML_DLOG(INFO) << "Thread configurations are not supported on this platform.";
+  return false;
+#endif
+}
+
+int Thread::GetCurrentCPU() {
+#if OS_LINUX || OS_ANDROID
+  return ::sched_getcpu();
+#else
+  return -1;
+#endif
+}
+
 }  // namespace fml
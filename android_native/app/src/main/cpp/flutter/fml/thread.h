@@ -6,7 +6,9 @@
 #define FLUTTER_FML_THREAD_H_
 
 #include <atomic>
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <thread>
 
 #include "flutter/fml/macros.h"
@@ -14,9 +16,52 @@
 
 namespace fml {
 
+// How the OS schedules a thread. Only Linux and Android support these. The
+// defaults leave the scheduling to the OS.
+struct ThreadConfig {
+  enum class Policy {
+    // Leaves the policy as it is. A nonzero |nice| switches to |kNormal|
+    // since the nice value only applies to the normal and batch policies.
+    kDefault,
+    // SCHED_OTHER with |nice|.
+    kNormal,
+    // SCHED_BATCH with |nice|. For throughput oriented threads.
+    kBatch,
+    // SCHED_IDLE. Only runs when nothing else wants to.
+    kIdle,
+    // SCHED_FIFO with |realtime_priority|. Usually needs privileges.
+    kFifo,
+    // SCHED_RR with |realtime_priority|. Usually needs privileges.
+    kRoundRobin,
+  };
+
+  Policy policy = Policy::kDefault;
+  // From -20 (most favorable) to 19. Lowering it may need privileges.
+  int nice = 0;
+  // From 1 to 99.
+  int realtime_priority = 1;
+  // A bit per CPU the thread may run on. Zero allows all CPUs.
+  uint64_t cpu_affinity_mask = 0;
+
+  bool IsDefault() const {
+    return policy == Policy::kDefault && nice == 0 && cpu_affinity_mask == 0;
+  }
+
+  bool operator==(const ThreadConfig& other) const {
+    return policy == other.policy && nice == other.nice &&
+           realtime_priority == other.realtime_priority &&
+           cpu_affinity_mask == other.cpu_affinity_mask;
+  }
+
+  bool operator!=(const ThreadConfig& other) const {
+    return !operator==(other);
+  }
+};
+
 class Thread {
  public:
-  explicit Thread(const std::string& name = "");
+  explicit Thread(const std::string& name = "",
+                  const ThreadConfig& config = ThreadConfig());
 
   ~Thread();
 
@@ -24,13 +69,21 @@ class Thread {
 
   void Join();
 
+  static void SetCurrentThreadName(const std::string& name);
+
+  // Applies |config| to the calling thread. Returns false if the OS refused
+  // a part of it. The other parts are applied anyway.
+  static bool SetCurrentThreadConfig(const ThreadConfig& config);
+
+  // The CPU the calling thread runs on or -1 if that is unknown. The thread
+  // may have migrated by the time this returns.
+  static int GetCurrentCPU();
+
  private:
   std::unique_ptr<std::thread> thread_;
   fml::RefPtr<fml::TaskRunner> task_runner_;
   std::atomic_bool joined_;
 
-  static void SetCurrentThreadName(const std::string& name);
-
   FML_DISALLOW_COPY_AND_ASSIGN(Thread);
 };
 
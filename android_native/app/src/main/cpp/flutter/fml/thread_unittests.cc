@@ -4,8 +4,16 @@
 
 #include "gtest/gtest.h"
 
+#include "flutter/fml/build_config.h"
 #include "flutter/fml/thread.h"
 
+#if OS_LINUX || OS_ANDROID
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 TEST(Thread, CanStartAndEnd) {
   fml::Thread thread;
   ASSERT_TRUE(thread.GetTaskRunner());
@@ -24,3 +32,70 @@ TEST(Thread, HasARunningMessageLoop) {
   thread.Join();
   ASSERT_TRUE(done);
 }
+
+#if OS_LINUX || OS_ANDROID
+
+TEST(Thread, AppliesTheCPUAffinity) {
+  // Pin the thread to the last CPU this process may use.
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  ASSERT_EQ(::sched_getaffinity(0, sizeof(allowed), &allowed), 0);
+  int pinned_cpu = -1;
+  for (int cpu = 0; cpu < 64; cpu++) {
+    if (CPU_ISSET(cpu, &allowed)) {
+      pinned_cpu = cpu;
+    }
+  }
+  ASSERT_GE(pinned_cpu, 0);
+
+  fml::ThreadConfig config;
+  config.cpu_affinity_mask = uint64_t{1} << pinned_cpu;
+  fml::Thread thread("affinity", config);
+  int cpu = -1;
+  bool only_pinned_cpu = false;
+  thread.GetTaskRunner()->PostTask([&cpu, &only_pinned_cpu, pinned_cpu]() {
+    cpu = fml::Thread::GetCurrentCPU();
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    ASSERT_EQ(::sched_getaffinity(0, sizeof(cpus), &cpus), 0);
+    only_pinned_cpu = CPU_COUNT(&cpus) == 1 && CPU_ISSET(pinned_cpu, &cpus);
+  });
+  thread.Join();
+  ASSERT_EQ(cpu, pinned_cpu);
+  ASSERT_TRUE(only_pinned_cpu);
+}
+
+TEST(Thread, AppliesThePolicyAndNiceValue) {
+  fml::ThreadConfig config;
+  config.policy = fml::ThreadConfig::Policy::kBatch;
+  // Raising the nice value needs no privileges.
+  config.nice = 5;
+  fml::Thread thread("batch", config);
+  int policy = -1;
+  int nice = 0;
+  thread.GetTaskRunner()->PostTask([&policy, &nice]() {
+    policy = ::sched_getscheduler(0);
+    nice = ::getpriority(PRIO_PROCESS, ::syscall(SYS_gettid));
+  });
+  thread.Join();
+  ASSERT_EQ(policy, SCHED_BATCH);
+  ASSERT_EQ(nice, 5);
+}
+
+TEST(Thread, AppliesTheNiceValueWithoutAPolicy) {
+  fml::ThreadConfig config;
+  config.nice = 3;
+  ASSERT_FALSE(config.IsDefault());
+  fml::Thread thread("nice", config);
+  int policy = -1;
+  int nice = 0;
+  thread.GetTaskRunner()->PostTask([&policy, &nice]() {
+    policy = ::sched_getscheduler(0);
+    nice = ::getpriority(PRIO_PROCESS, ::syscall(SYS_gettid));
+  });
+  thread.Join();
+  ASSERT_EQ(policy, SCHED_OTHER);
+  ASSERT_EQ(nice, 3);
+}
+
+#endif  // OS_LINUX || OS_ANDROID
@@ -4,50 +4,47 @@
 
 #include "flutter/fml/trace_event.h"
 
-//#include "third_party/dart/runtime/include/dart_tools_api.h"
+#include <string>
+
+#include "flutter/fml/trace_recorder.h"
 
 namespace fml {
 namespace tracing {
 
+static inline TraceRecorder& Recorder() {
+  return TraceRecorder::GetInstance();
+}
+
+static void AddEvent(TracePhase phase,
+                     TraceArg category_group,
+                     TraceArg name,
+                     TraceIDArg id,
+                     size_t argument_count = 0,
+                     const TraceArg* argument_names = nullptr,
+                     const TraceArg* argument_values = nullptr) {
+  auto& recorder = Recorder();
+  if (!recorder.IsCategoryEnabled(category_group)) {
+    return;
+  }
+  recorder.AddEvent(phase, category_group, name, id, argument_count,
+                    argument_names, argument_values);
+}
+
 void TraceCounter(TraceArg category_group, TraceArg name, TraceIDArg count) {
-//  auto count_string = std::to_string(count);
-//  const char* arg_names[] = {name};
-//  const char* arg_values[] = {count_string.c_str()};
-//  Dart_TimelineEvent(name,                         // label
-//                     Dart_TimelineGetMicros(),     // timestamp0
-//                     0,                            // timestamp1_or_async_id
-//                     Dart_Timeline_Event_Counter,  // event type
-//                     1,                            // argument_count
-//                     arg_names,                    // argument_names
-//                     arg_values                    // argument_values
-//  );
+  AddEvent(TracePhase::kCounter, category_group, name, count);
 }
 
 void TraceEvent0(TraceArg category_group, TraceArg name) {
-//  Dart_TimelineEvent(name,                       // label
-//                     Dart_TimelineGetMicros(),   // timestamp0
-//                     0,                          // timestamp1_or_async_id
-//                     Dart_Timeline_Event_Begin,  // event type
-//                     0,                          // argument_count
-//                     nullptr,                    // argument_names
-//                     nullptr                     // argument_values
-//  );
+  Recorder().BeginDuration(category_group, name, 0, nullptr, nullptr);
 }
 
 void TraceEvent1(TraceArg category_group,
                  TraceArg name,
                  TraceArg arg1_name,
                  TraceArg arg1_val) {
-//  const char* arg_names[] = {arg1_name};
-//  const char* arg_values[] = {arg1_val};
-//  Dart_TimelineEvent(name,                       // label
-//                     Dart_TimelineGetMicros(),   // timestamp0
-//                     0,                          // timestamp1_or_async_id
-//                     Dart_Timeline_Event_Begin,  // event type
-//                     1,                          // argument_count
-//                     arg_names,                  // argument_names
-//                     arg_values                  // argument_values
-//  );
+  const char* arg_names[] = {arg1_name};
+  const char* arg_values[] = {arg1_val};
+  Recorder().BeginDuration(category_group, name, 1, arg_names, arg_values);
 }
 
 void TraceEvent2(TraceArg category_group,
@@ -56,53 +53,25 @@ void TraceEvent2(TraceArg category_group,
                  TraceArg arg1_val,
                  TraceArg arg2_name,
                  TraceArg arg2_val) {
-//  const char* arg_names[] = {arg1_name, arg2_name};
-//  const char* arg_values[] = {arg1_val, arg2_val};
-//  Dart_TimelineEvent(name,                       // label
-//                     Dart_TimelineGetMicros(),   // timestamp0
-//                     0,                          // timestamp1_or_async_id
-//                     Dart_Timeline_Event_Begin,  // event type
-//                     2,                          // argument_count
-//                     arg_names,                  // argument_names
-//                     arg_values                  // argument_values
-//  );
+  const char* arg_names[] = {arg1_name, arg2_name};
+  const char* arg_values[] = {arg1_val, arg2_val};
+  Recorder().BeginDuration(category_group, name, 2, arg_names, arg_values);
 }
 
 void TraceEventEnd(TraceArg name) {
-//  Dart_TimelineEvent(name,                      // label
-//                     Dart_TimelineGetMicros(),  // timestamp0
-//                     0,                         // timestamp1_or_async_id
-//                     Dart_Timeline_Event_End,   // event type
-//                     0,                         // argument_count
-//                     nullptr,                   // argument_names
-//                     nullptr                    // argument_values
-//  );
+  Recorder().EndDuration(name);
 }
 
 void TraceEventAsyncBegin0(TraceArg category_group,
                            TraceArg name,
                            TraceIDArg id) {
-//  Dart_TimelineEvent(name,                             // label
-//                     Dart_TimelineGetMicros(),         // timestamp0
-//                     id,                               // timestamp1_or_async_id
-//                     Dart_Timeline_Event_Async_Begin,  // event type
-//                     0,                                // argument_count
-//                     nullptr,                          // argument_names
-//                     nullptr                           // argument_values
-//  );
+  AddEvent(TracePhase::kAsyncBegin, category_group, name, id);
 }
 
 void TraceEventAsyncEnd0(TraceArg category_group,
                          TraceArg name,
                          TraceIDArg id) {
-//  Dart_TimelineEvent(name,                           // label
-//                     Dart_TimelineGetMicros(),       // timestamp0
-//                     id,                             // timestamp1_or_async_id
-//                     Dart_Timeline_Event_Async_End,  // event type
-//                     0,                              // argument_count
-//                     nullptr,                        // argument_names
-//                     nullptr                         // argument_values
-//  );
+  AddEvent(TracePhase::kAsyncEnd, category_group, name, id);
 }
 
 void TraceEventAsyncBegin1(TraceArg category_group,
@@ -110,16 +79,10 @@ void TraceEventAsyncBegin1(TraceArg category_group,
                            TraceIDArg id,
                            TraceArg arg1_name,
                            TraceArg arg1_val) {
-//  const char* arg_names[] = {arg1_name};
-//  const char* arg_values[] = {arg1_val};
-//  Dart_TimelineEvent(name,                             // label
-//                     Dart_TimelineGetMicros(),         // timestamp0
-//                     id,                               // timestamp1_or_async_id
-//                     Dart_Timeline_Event_Async_Begin,  // event type
-//                     1,                                // argument_count
-//                     arg_names,                        // argument_names
-//                     arg_values                        // argument_values
-//  );
+  const char* arg_names[] = {arg1_name};
+  const char* arg_values[] = {arg1_val};
+  AddEvent(TracePhase::kAsyncBegin, category_group, name, id, 1, arg_names,
+           arg_values);
 }
 
 void TraceEventAsyncEnd1(TraceArg category_group,
@@ -127,64 +90,30 @@ void TraceEventAsyncEnd1(TraceArg category_group,
                          TraceIDArg id,
                          TraceArg arg1_name,
                          TraceArg arg1_val) {
-//  const char* arg_names[] = {arg1_name};
-//  const char* arg_values[] = {arg1_val};
-//  Dart_TimelineEvent(name,                           // label
-//                     Dart_TimelineGetMicros(),       // timestamp0
-//                     id,                             // timestamp1_or_async_id
-//                     Dart_Timeline_Event_Async_End,  // event type
-//                     1,                              // argument_count
-//                     arg_names,                      // argument_names
-//                     arg_values                      // argument_values
-//  );
+  const char* arg_names[] = {arg1_name};
+  const char* arg_values[] = {arg1_val};
+  AddEvent(TracePhase::kAsyncEnd, category_group, name, id, 1, arg_names,
+           arg_values);
 }
 
 void TraceEventInstant0(TraceArg category_group, TraceArg name) {
-//  Dart_TimelineEvent(name,                         // label
-//                     Dart_TimelineGetMicros(),     // timestamp0
-//                     0,                            // timestamp1_or_async_id
-//                     Dart_Timeline_Event_Instant,  // event type
-//                     0,                            // argument_count
-//                     nullptr,                      // argument_names
-//                     nullptr                       // argument_values
-//  );
+  AddEvent(TracePhase::kInstant, category_group, name, 0);
 }
 
 void TraceEventFlowBegin0(TraceArg category_group,
                           TraceArg name,
                           TraceIDArg id) {
-//  Dart_TimelineEvent(name,                            // label
-//                     Dart_TimelineGetMicros(),        // timestamp0
-//                     id,                              // timestamp1_or_async_id
-//                     Dart_Timeline_Event_Flow_Begin,  // event type
-//                     0,                               // argument_count
-//                     nullptr,                         // argument_names
-//                     nullptr                          // argument_values
-//  );
+  AddEvent(TracePhase::kFlowBegin, category_group, name, id);
 }
 
 void TraceEventFlowStep0(TraceArg category_group,
                          TraceArg name,
                          TraceIDArg id) {
-//  Dart_TimelineEvent(name,                           // label
-//                     Dart_TimelineGetMicros(),       // timestamp0
-//                     id,                             // timestamp1_or_async_id
-//                     Dart_Timeline_Event_Flow_Step,  // event type
-//                     0,                              // argument_count
-//                     nullptr,                        // argument_names
-//                     nullptr                         // argument_values
-//  );
+  AddEvent(TracePhase::kFlowStep, category_group, name, id);
 }
 
 void TraceEventFlowEnd0(TraceArg category_group, TraceArg name, TraceIDArg id) {
-//  Dart_TimelineEvent(name,                          // label
-//                     Dart_TimelineGetMicros(),      // timestamp0
-//                     id,                            // timestamp1_or_async_id
-//                     Dart_Timeline_Event_Flow_End,  // event type
-//                     0,                             // argument_count
-//                     nullptr,                       // argument_names
-//                     nullptr                        // argument_values
-//  );
+  AddEvent(TracePhase::kFlowEnd, category_group, name, id);
 }
 
 }  // namespace tracing
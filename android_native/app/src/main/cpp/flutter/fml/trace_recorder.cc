@@ -0,0 +1,632 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define FML_USED_ON_EMBEDDER
+
+#include "flutter/fml/trace_recorder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include "flutter/fml/build_config.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/thread_local.h"
+#include "flutter/fml/time/time_point.h"
+
+#if OS_WIN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace fml {
+namespace tracing {
+
+namespace {
+
+constexpr size_t kChunkEventCount = 1024;
+constexpr size_t kMaxChunks =
+    TraceRecorder::kEndlessBufferEventCount / kChunkEventCount;
+constexpr size_t kMaxArguments = 2;
+constexpr size_t kMaxNameLength = 48;
+constexpr size_t kMaxArgumentValueLength = 32;
+// Buffers of threads that have exited are kept around (so their events show
+// up in exported traces) till there are this many buffers. After that, they
+// are recycled for new threads.
+constexpr size_t kMaxRetainedThreadBuffers = 32;
+// The slot sequence of a slot that has never been written to.
+constexpr uint64_t kEmptySlotSequence = 0;
+
+struct TraceEventRecord {
+  int64_t timestamp_micros;
+  TraceIDArg id;
+  TraceArg category_group;
+  TraceArg argument_names[kMaxArguments];
+  TracePhase phase;
+  uint8_t argument_count;
+  char name[kMaxNameLength];
+  char argument_values[kMaxArguments][kMaxArgumentValueLength];
+};
+
+// Each slot is guarded by a sequence number so that readers can detect slots
+// that were (re)written while they were being copied out. For the event at
+// index N, the sequence is 2N+1 while the slot is being written and 2N+2 once
+// the write is complete.
+struct TraceEventSlot {
+  std::atomic<uint64_t> sequence;
+  TraceEventRecord record;
+};
+
+struct TraceEventChunk {
+  TraceEventSlot slots[kChunkEventCount];
+
+  TraceEventChunk() {
+    for (auto& slot : slots) {
+      slot.sequence.store(kEmptySlotSequence, std::memory_order_relaxed);
+    }
+  }
+};
+
+void CopyTruncated(char* destination, const char* source, size_t size) {
+  if (source == nullptr) {
+    destination[0] = '\0';
+    return;
+  }
+  strncpy(destination, source, size - 1);
+  destination[size - 1] = '\0';
+}
+
+int64_t GetProcessID() {
+#if OS_WIN
+  return static_cast<int64_t>(::GetCurrentProcessId());
+#else
+  return static_cast<int64_t>(::getpid());
+#endif
+}
+
+void WriteJSONString(std::ostream& stream, const char* string) {
+  stream << '"';
+  for (const char* c = string; c != nullptr && *c != '\0'; c++) {
+    switch (*c) {
+      case '"':
+        stream << "\\\"";
+        break;
+      case '\\':
+        stream << "\\\\";
+        break;
+      case '\n':
+        stream << "\\n";
+        break;
+      case '\t':
+        stream << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(*c) < 0x20) {
+          // Drop other control characters.
+          break;
+        }
+        stream << *c;
+        break;
+    }
+  }
+  stream << '"';
+}
+
+}  // namespace
+
+class TraceRecorder::ThreadBuffer {
+ public:
+  explicit ThreadBuffer(size_t thread_id)
+      : thread_id_(thread_id),
+        retired_(false),
+        write_count_(0),
+        base_(0),
+        chunks_(new std::atomic<TraceEventChunk*>[kMaxChunks]),
+        duration_bits_(0),
+        duration_depth_(0) {
+    for (size_t i = 0; i < kMaxChunks; i++) {
+      chunks_[i].store(nullptr, std::memory_order_relaxed);
+    }
+  }
+
+  ~ThreadBuffer() {
+    for (size_t i = 0; i < kMaxChunks; i++) {
+      delete chunks_[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  // Only called on the thread that owns this buffer.
+  void Add(const TraceEventRecord& record, bool endless) {
+    const uint64_t index = write_count_.load(std::memory_order_relaxed);
+    const uint64_t capacity = Capacity(endless);
+
+    if (endless &&
+        index - base_.load(std::memory_order_relaxed) >= capacity) {
+      // The endless buffer is full. Drop the event.
+      return;
+    }
+
+    TraceEventSlot* slot = GetSlot(index % capacity, true);
+    if (slot == nullptr) {
+      return;
+    }
+
+    slot->sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->record = record;
+    slot->sequence.store(2 * index + 2, std::memory_order_release);
+    write_count_.store(index + 1, std::memory_order_release);
+  }
+
+  // May be called on any thread. Invokes |visitor| with a consistent copy of
+  // each event currently in the buffer in the order they were recorded.
+  template <class Visitor>
+  void ForEach(bool endless, Visitor visitor) const {
+    const uint64_t count = write_count_.load(std::memory_order_acquire);
+    const uint64_t capacity = Capacity(endless);
+    uint64_t start = base_.load(std::memory_order_acquire);
+    if (count > capacity) {
+      start = std::max<uint64_t>(start, count - capacity);
+    }
+
+    for (uint64_t index = start; index < count; index++) {
+      const TraceEventSlot* slot = GetSlot(index % capacity, false);
+      if (slot == nullptr) {
+        continue;
+      }
+      const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+      if (sequence != 2 * index + 2) {
+        // The slot has been overwritten by a newer event (or is being
+        // written to).
+        continue;
+      }
+      TraceEventRecord record;
+      memcpy(&record, &slot->record, sizeof(record));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot->sequence.load(std::memory_order_relaxed) != sequence) {
+        continue;
+      }
+      visitor(record);
+    }
+  }
+
+  // May be called on any thread.
+  void Clear() {
+    base_.store(write_count_.load(std::memory_order_acquire),
+                std::memory_order_release);
+  }
+
+  // Only called on the thread that owns this buffer.
+  void PushDuration(bool recorded) {
+    if (duration_depth_ < 64) {
+      const uint64_t bit = uint64_t{1} << duration_depth_;
+      duration_bits_ = recorded ? (duration_bits_ | bit)
+                                : (duration_bits_ & ~bit);
+    }
+    duration_depth_++;
+  }
+
+  // Only called on the thread that owns this buffer. Returns if the duration
+  // being ended was recorded.
+  bool PopDuration() {
+    if (duration_depth_ == 0) {
+      return false;
+    }
+    duration_depth_--;
+    if (duration_depth_ >= 64) {
+      return true;
+    }
+    return (duration_bits_ >> duration_depth_) & 1;
+  }
+
+  void ResetDurations() {
+    duration_bits_ = 0;
+    duration_depth_ = 0;
+  }
+
+  size_t thread_id() const { return thread_id_; }
+
+  void set_thread_id(size_t thread_id) { thread_id_ = thread_id; }
+
+  const std::string& name() const { return name_; }
+
+  void set_name(std::string name) { name_ = std::move(name); }
+
+  bool retired() const { return retired_.load(std::memory_order_acquire); }
+
+  void set_retired(bool retired) {
+    retired_.store(retired, std::memory_order_release);
+  }
+
+ private:
+  // Guarded by the recorder mutex.
+  size_t thread_id_;
+  std::string name_;
+
+  std::atomic_bool retired_;
+  std::atomic<uint64_t> write_count_;
+  std::atomic<uint64_t> base_;
+  std::unique_ptr<std::atomic<TraceEventChunk*>[]> chunks_;
+
+  // Accessed only on the owning thread.
+  uint64_t duration_bits_;
+  size_t duration_depth_;
+
+  static uint64_t Capacity(bool endless) {
+    return endless ? kEndlessBufferEventCount : kRingBufferEventCount;
+  }
+
+  TraceEventSlot* GetSlot(uint64_t position, bool create) const {
+    const size_t chunk_index = position / kChunkEventCount;
+    FML_DCHECK(chunk_index < kMaxChunks);
+    TraceEventChunk* chunk =
+        chunks_[chunk_index].load(std::memory_order_acquire);
+    if (chunk == nullptr) {
+      if (!create) {
+        return nullptr;
+      }
+      // Only the owning thread creates chunks. So there is no race here.
+      chunk = new TraceEventChunk();
+      chunks_[chunk_index].store(chunk, std::memory_order_release);
+    }
+    return &chunk->slots[position % kChunkEventCount];
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ThreadBuffer);
+};
+
+struct TraceRecorder::Category {
+  std::atomic<const char*> name;
+  std::atomic_bool enabled;
+};
+
+FML_THREAD_LOCAL ThreadLocal tls_trace_buffer([](intptr_t value) {
+  // The buffer is owned by the recorder. Let it know the thread is gone so
+  // that the buffer may be recycled.
+  auto* buffer = reinterpret_cast<TraceRecorder::ThreadBuffer*>(value);
+  if (buffer != nullptr) {
+    buffer->set_retired(true);
+  }
+});
+
+constexpr size_t TraceRecorder::kRingBufferEventCount;
+constexpr size_t TraceRecorder::kEndlessBufferEventCount;
+constexpr size_t TraceRecorder::kMaxCategories;
+
+TraceRecorder& TraceRecorder::GetInstance() {
+  // Intentionally leaked. Threads may still be tracing during static
+  // destruction.
+  static TraceRecorder* recorder = new TraceRecorder();
+  return *recorder;
+}
+
+TraceRecorder::TraceRecorder()
+    : enabled_(false),
+      endless_(false),
+      all_categories_enabled_(true),
+      category_count_(0),
+      categories_(new Category[kMaxCategories]),
+      next_thread_id_(1) {}
+
+TraceRecorder::~TraceRecorder() = default;
+
+void TraceRecorder::SetEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void TraceRecorder::SetEnabledCategories(
+    const std::vector<std::string>& categories) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  enabled_categories_ = categories;
+  all_categories_enabled_.store(enabled_categories_.empty(),
+                                std::memory_order_relaxed);
+  const size_t count = category_count_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < count; i++) {
+    categories_[i].enabled.store(
+        IsCategoryNameEnabledLocked(
+            categories_[i].name.load(std::memory_order_relaxed)),
+        std::memory_order_relaxed);
+  }
+}
+
+bool TraceRecorder::IsCategoryNameEnabledLocked(
+    const char* category_group) const {
+  if (enabled_categories_.empty()) {
+    return true;
+  }
+  // A category group may be a comma separated list of categories.
+  std::stringstream stream(category_group == nullptr ? "" : category_group);
+  std::string category;
+  while (std::getline(stream, category, ',')) {
+    if (std::find(enabled_categories_.begin(), enabled_categories_.end(),
+                  category) != enabled_categories_.end()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TraceRecorder::IsCategoryEnabled(TraceArg category_group) {
+  if (!IsEnabled()) {
+    return false;
+  }
+
+  if (all_categories_enabled_.load(std::memory_order_relaxed)) {
+    return true;
+  }
+
+  // Fast path: Category groups are string literals. So just compare the
+  // pointers of the ones we have already seen.
+  size_t count = category_count_.load(std::memory_order_acquire);
+  for (size_t i = 0; i < count; i++) {
+    if (categories_[i].name.load(std::memory_order_relaxed) ==
+        category_group) {
+      return categories_[i].enabled.load(std::memory_order_relaxed);
+    }
+  }
+
+  // Slow path: Register the category group.
+  std::lock_guard<std::mutex> lock(mutex_);
+  count = category_count_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < count; i++) {
+    if (categories_[i].name.load(std::memory_order_relaxed) ==
+        category_group) {
+      return categories_[i].enabled.load(std::memory_order_relaxed);
+    }
+  }
+
+  const bool enabled = IsCategoryNameEnabledLocked(category_group);
+  if (count < kMaxCategories) {
+    categories_[count].name.store(category_group, std::memory_order_relaxed);
+    categories_[count].enabled.store(enabled, std::memory_order_relaxed);
+    category_count_.store(count + 1, std::memory_order_release);
+  }
+  return enabled;
+}
+
+void TraceRecorder::SetEndlessBuffer(bool endless) {
+  if (endless_.exchange(endless) == endless) {
+    return;
+  }
+  Clear();
+}
+
+void TraceRecorder::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& buffer : buffers_) {
+    buffer->Clear();
+  }
+}
+
+TraceRecorder::ThreadBuffer* TraceRecorder::GetCurrentThreadBuffer(
+    bool create) {
+  auto* buffer = reinterpret_cast<ThreadBuffer*>(tls_trace_buffer.Get());
+  if (buffer != nullptr || !create) {
+    return buffer;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (buffers_.size() >= kMaxRetainedThreadBuffers) {
+    for (auto& retired : buffers_) {
+      if (retired->retired()) {
+        buffer = retired.get();
+        buffer->Clear();
+        buffer->set_name("");
+        buffer->set_thread_id(next_thread_id_++);
+        buffer->set_retired(false);
+        break;
+      }
+    }
+  }
+
+  if (buffer == nullptr) {
+    buffers_.emplace_back(std::make_unique<ThreadBuffer>(next_thread_id_++));
+    buffer = buffers_.back().get();
+  }
+
+  buffer->ResetDurations();
+  tls_trace_buffer.Set(reinterpret_cast<intptr_t>(buffer));
+  return buffer;
+}
+
+void TraceRecorder::SetCurrentThreadName(const std::string& name) {
+  auto* buffer = GetCurrentThreadBuffer(true);
+  std::lock_guard<std::mutex> lock(mutex_);
+  buffer->set_name(name);
+}
+
+static TraceEventRecord MakeRecord(TracePhase phase,
+                                   TraceArg category_group,
+                                   TraceArg name,
+                                   TraceIDArg id,
+                                   size_t argument_count,
+                                   const TraceArg* argument_names,
+                                   const TraceArg* argument_values) {
+  TraceEventRecord record;
+  record.timestamp_micros =
+      fml::TimePoint::Now().ToEpochDelta().ToMicroseconds();
+  record.id = id;
+  record.category_group = category_group;
+  record.phase = phase;
+  record.argument_count =
+      static_cast<uint8_t>(std::min(argument_count, kMaxArguments));
+  CopyTruncated(record.name, name, kMaxNameLength);
+  for (size_t i = 0; i < record.argument_count; i++) {
+    record.argument_names[i] = argument_names[i];
+    CopyTruncated(record.argument_values[i], argument_values[i],
+                  kMaxArgumentValueLength);
+  }
+  return record;
+}
+
+void TraceRecorder::AddEvent(TracePhase phase,
+                             TraceArg category_group,
+                             TraceArg name,
+                             TraceIDArg id,
+                             size_t argument_count,
+                             const TraceArg* argument_names,
+                             const TraceArg* argument_values) {
+  auto* buffer = GetCurrentThreadBuffer(true);
+  buffer->Add(MakeRecord(phase, category_group, name, id, argument_count,
+                         argument_names, argument_values),
+              IsEndlessBuffer());
+}
+
+bool TraceRecorder::BeginDuration(TraceArg category_group,
+                                  TraceArg name,
+                                  size_t argument_count,
+                                  const TraceArg* argument_names,
+                                  const TraceArg* argument_values) {
+  // Threads that have never recorded an event don't need to track their
+  // durations. This keeps the disabled case cheap.
+  auto* buffer = GetCurrentThreadBuffer(IsEnabled());
+  if (buffer == nullptr) {
+    return false;
+  }
+
+  const bool recorded = IsCategoryEnabled(category_group);
+  buffer->PushDuration(recorded);
+  if (recorded) {
+    buffer->Add(MakeRecord(TracePhase::kBegin, category_group, name, 0,
+                           argument_count, argument_names, argument_values),
+                IsEndlessBuffer());
+  }
+  return recorded;
+}
+
+void TraceRecorder::EndDuration(TraceArg name) {
+  auto* buffer = GetCurrentThreadBuffer(false);
+  if (buffer == nullptr || !buffer->PopDuration()) {
+    return;
+  }
+  // The end event is recorded even if the recorder was disabled since the
+  // begin event so that the exported durations stay balanced.
+  buffer->Add(MakeRecord(TracePhase::kEnd, nullptr, name, 0, 0, nullptr,
+                         nullptr),
+              IsEndlessBuffer());
+}
+
+size_t TraceRecorder::GetEventCount() const {
+  const bool endless = IsEndlessBuffer();
+  size_t count = 0;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& buffer : buffers_) {
+    buffer->ForEach(endless, [&count](const TraceEventRecord&) { count++; });
+  }
+  return count;
+}
+
+std::string TraceRecorder::GetChromeTraceJSON() const {
+  return GetChromeTraceJSON(fml::TimePoint::Min(), fml::TimePoint::Max());
+}
+
+std::string TraceRecorder::GetChromeTraceJSON(fml::TimePoint start,
+                                              fml::TimePoint end) const {
+  const int64_t start_micros = start.ToEpochDelta().ToMicroseconds();
+  const int64_t end_micros = end.ToEpochDelta().ToMicroseconds();
+  const bool endless = IsEndlessBuffer();
+  const int64_t pid = GetProcessID();
+  std::stringstream stream;
+  bool first = true;
+
+  auto separator = [&stream, &first]() {
+    if (!first) {
+      stream << ",\n";
+    }
+    first = false;
+  };
+
+  stream << "{\"traceEvents\":[\n";
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& buffer : buffers_) {
+    const size_t tid = buffer->thread_id();
+
+    if (!buffer->name().empty()) {
+      separator();
+      stream << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+             << ",\"tid\":" << tid << ",\"args\":{\"name\":";
+      WriteJSONString(stream, buffer->name().c_str());
+      stream << "}}";
+    }
+
+    buffer->ForEach(endless, [&](const TraceEventRecord& record) {
+      if (record.timestamp_micros < start_micros ||
+          record.timestamp_micros > end_micros) {
+        return;
+      }
+      separator();
+      stream << "{\"name\":";
+      WriteJSONString(stream, record.name);
+      if (record.category_group != nullptr) {
+        stream << ",\"cat\":";
+        WriteJSONString(stream, record.category_group);
+      }
+      stream << ",\"ph\":\"" << static_cast<char>(record.phase) << "\""
+             << ",\"ts\":" << record.timestamp_micros << ",\"pid\":" << pid
+             << ",\"tid\":" << tid;
+
+      switch (record.phase) {
+        case TracePhase::kAsyncBegin:
+        case TracePhase::kAsyncEnd:
+        case TracePhase::kFlowBegin:
+        case TracePhase::kFlowStep:
+        case TracePhase::kFlowEnd:
+          stream << ",\"id\":\"0x" << std::hex << record.id << std::dec
+                 << "\"";
+          break;
+        default:
+          break;
+      }
+
+      if (record.phase == TracePhase::kFlowEnd) {
+        // Bind the flow end to the enclosing slice.
+        stream << ",\"bp\":\"e\"";
+      }
+
+      if (record.phase == TracePhase::kInstant) {
+        stream << ",\"s\":\"t\"";
+      }
+
+      if (record.phase == TracePhase::kCounter) {
+        stream << ",\"args\":{";
+        WriteJSONString(stream, record.name);
+        stream << ":" << record.id << "}";
+      } else if (record.argument_count > 0) {
+        stream << ",\"args\":{";
+        for (size_t i = 0; i < record.argument_count; i++) {
+          if (i > 0) {
+            stream << ",";
+          }
+          WriteJSONString(stream, record.argument_names[i]);
+          stream << ":";
+          WriteJSONString(stream, record.argument_values[i]);
+        }
+        stream << "}";
+      }
+
+      stream << "}";
+    });
+  }
+
+  stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  return stream.str();
+}
+
+bool TraceRecorder::WriteChromeTraceJSON(const fml::UniqueFD& base_directory,
+                                         const char* file_name) const {
+  const std::string json = GetChromeTraceJSON();
+  fml::DataMapping mapping(std::vector<uint8_t>(json.begin(), json.end()));
+  if (!fml::WriteAtomically(base_directory, file_name, mapping)) {
+    FML_LOG(ERROR) << "Could not write the trace to " << file_name;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace tracing
+}  // namespace fml
@@ -0,0 +1,155 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_TRACE_RECORDER_H_
+#define FLUTTER_FML_TRACE_RECORDER_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_point.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/fml/unique_fd.h"
+
+namespace fml {
+namespace tracing {
+
+// The phase of a recorded event. The values match the "ph" field of the
+// Chrome trace event format so they can be written out verbatim.
+enum class TracePhase : char {
+  kBegin = 'B',
+  kEnd = 'E',
+  kCounter = 'C',
+  kInstant = 'i',
+  kAsyncBegin = 'b',
+  kAsyncEnd = 'e',
+  kFlowBegin = 's',
+  kFlowStep = 't',
+  kFlowEnd = 'f',
+};
+
+// Records the events emitted via the TRACE_EVENT* macros into per-thread
+// buffers. Each buffer is only ever written to by its owning thread so
+// recording an event takes no locks. Buffers may be read (exported) from any
+// thread at any time. Events that are being overwritten while they are being
+// exported are skipped.
+//
+// By default, each thread keeps the most recent |kRingBufferEventCount| events
+// and older events are overwritten. In endless mode, events are never
+// overwritten and each thread may record up to |kEndlessBufferEventCount|
+// events after which new events are dropped.
+class TraceRecorder {
+ public:
+  static constexpr size_t kRingBufferEventCount = 4096;
+  static constexpr size_t kEndlessBufferEventCount = 1024 * 1024;
+
+  static TraceRecorder& GetInstance();
+
+  // Starts or stops recording events. Disabling the recorder does not discard
+  // the events already recorded.
+  void SetEnabled(bool enabled);
+
+  bool IsEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  // Restricts recording to the specified category groups. Specify an empty
+  // list to record all categories (the default).
+  void SetEnabledCategories(const std::vector<std::string>& categories);
+
+  // Returns true if events in the given category group are currently being
+  // recorded. The category group must be a string with static storage
+  // duration (like the ones given to the TRACE_EVENT* macros).
+  bool IsCategoryEnabled(TraceArg category_group);
+
+  // Switches between the ring buffer and the endless buffer. Switching the
+  // buffer mode discards all events recorded so far.
+  void SetEndlessBuffer(bool endless);
+
+  bool IsEndlessBuffer() const {
+    return endless_.load(std::memory_order_relaxed);
+  }
+
+  // Discards all recorded events.
+  void Clear();
+
+  // Associates a name with the calling thread. This is used to label the
+  // thread in exported traces.
+  void SetCurrentThreadName(const std::string& name);
+
+  // Records an event on the calling thread. The category group and argument
+  // names must have static storage duration. The name and argument values are
+  // copied (and may be truncated).
+  void AddEvent(TracePhase phase,
+                TraceArg category_group,
+                TraceArg name,
+                TraceIDArg id,
+                size_t argument_count,
+                const TraceArg* argument_names,
+                const TraceArg* argument_values);
+
+  // Marks the start of a duration event on the calling thread. Returns true
+  // if the event was recorded. Every call must be balanced by a call to
+  // |EndDuration|.
+  bool BeginDuration(TraceArg category_group,
+                     TraceArg name,
+                     size_t argument_count,
+                     const TraceArg* argument_names,
+                     const TraceArg* argument_values);
+
+  // Ends the innermost duration on the calling thread. The end event is only
+  // recorded if the matching begin event was recorded.
+  void EndDuration(TraceArg name);
+
+  // Returns the number of events currently held in all thread buffers.
+  size_t GetEventCount() const;
+
+  // Returns the recorded events in the Chrome JSON trace event format. The
+  // result may be loaded into chrome://tracing or the Perfetto UI.
+  std::string GetChromeTraceJSON() const;
+
+  // Like |GetChromeTraceJSON| but only with the events recorded between
+  // |start| and |end| inclusive. Durations that straddle either bound are
+  // left with only their begin or end event.
+  std::string GetChromeTraceJSON(fml::TimePoint start,
+                                 fml::TimePoint end) const;
+
+  // Writes the result of |GetChromeTraceJSON| to the given file.
+  bool WriteChromeTraceJSON(const fml::UniqueFD& base_directory,
+                            const char* file_name) const;
+
+  class ThreadBuffer;
+
+ private:
+  struct Category;
+
+  static constexpr size_t kMaxCategories = 128;
+
+  std::atomic_bool enabled_;
+  std::atomic_bool endless_;
+  std::atomic_bool all_categories_enabled_;
+  std::atomic_size_t category_count_;
+  std::unique_ptr<Category[]> categories_;
+  mutable std::mutex mutex_;
+  std::vector<std::string> enabled_categories_;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+  size_t next_thread_id_;
+
+  TraceRecorder();
+
+  ~TraceRecorder();
+
+  ThreadBuffer* GetCurrentThreadBuffer(bool create);
+
+  bool IsCategoryNameEnabledLocked(const char* category_group) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TraceRecorder);
+};
+
+}  // namespace tracing
+}  // namespace fml
+
+#endif  // FLUTTER_FML_TRACE_RECORDER_H_
@@ -0,0 +1,183 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/time/time_point.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/fml/trace_recorder.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+namespace tracing {
+
+class TraceRecorderTest : public ::testing::Test {
+ protected:
+  void SetUp() override { Reset(); }
+
+  void TearDown() override { Reset(); }
+
+  static void Reset() {
+    auto& recorder = TraceRecorder::GetInstance();
+    recorder.SetEnabled(false);
+    recorder.SetEnabledCategories({});
+    recorder.SetEndlessBuffer(false);
+    recorder.Clear();
+  }
+
+  static TraceRecorder& Recorder() { return TraceRecorder::GetInstance(); }
+};
+
+TEST_F(TraceRecorderTest, DisabledByDefaultRecordsNothing) {
+  {
+    TRACE_EVENT0("flutter", "Disabled");
+    TRACE_EVENT_INSTANT0("flutter", "DisabledInstant");
+  }
+  ASSERT_EQ(Recorder().GetEventCount(), 0u);
+}
+
+TEST_F(TraceRecorderTest, RecordsBalancedDurations) {
+  Recorder().SetEnabled(true);
+  {
+    TRACE_EVENT0("flutter", "Outer");
+    TRACE_EVENT0("flutter", "Inner");
+  }
+  ASSERT_EQ(Recorder().GetEventCount(), 4u);
+}
+
+TEST_F(TraceRecorderTest, EndIsDroppedIfBeginWasNotRecorded) {
+  {
+    TRACE_EVENT0("flutter", "BeforeEnabling");
+    Recorder().SetEnabled(true);
+  }
+  ASSERT_EQ(Recorder().GetEventCount(), 0u);
+}
+
+TEST_F(TraceRecorderTest, EndIsRecordedIfDisabledAfterBegin) {
+  Recorder().SetEnabled(true);
+  {
+    TRACE_EVENT0("flutter", "Duration");
+    Recorder().SetEnabled(false);
+  }
+  ASSERT_EQ(Recorder().GetEventCount(), 2u);
+}
+
+TEST_F(TraceRecorderTest, FiltersCategories) {
+  Recorder().SetEnabled(true);
+  Recorder().SetEnabledCategories({"flutter"});
+  {
+    TRACE_EVENT0("skia", "Filtered");
+    TRACE_EVENT0("flutter", "Recorded");
+    TRACE_EVENT_INSTANT0("skia", "FilteredInstant");
+  }
+  ASSERT_EQ(Recorder().GetEventCount(), 2u);
+
+  Recorder().SetEnabledCategories({});
+  TRACE_EVENT_INSTANT0("skia", "RecordedInstant");
+  ASSERT_EQ(Recorder().GetEventCount(), 3u);
+}
+
+TEST_F(TraceRecorderTest, RingBufferKeepsMostRecentEvents) {
+  Recorder().SetEnabled(true);
+  std::thread thread([]() {
+    for (size_t i = 0; i < TraceRecorder::kRingBufferEventCount + 100; i++) {
+      TRACE_EVENT_INSTANT0("flutter", "Instant");
+    }
+  });
+  thread.join();
+  ASSERT_EQ(Recorder().GetEventCount(), TraceRecorder::kRingBufferEventCount);
+}
+
+TEST_F(TraceRecorderTest, EndlessBufferKeepsAllEvents) {
+  Recorder().SetEnabled(true);
+  Recorder().SetEndlessBuffer(true);
+  const size_t count = TraceRecorder::kRingBufferEventCount + 100;
+  std::thread thread([count]() {
+    for (size_t i = 0; i < count; i++) {
+      TRACE_EVENT_INSTANT0("flutter", "Instant");
+    }
+  });
+  thread.join();
+  ASSERT_EQ(Recorder().GetEventCount(), count);
+}
+
+TEST_F(TraceRecorderTest, ClearDiscardsEvents) {
+  Recorder().SetEnabled(true);
+  TRACE_EVENT_INSTANT0("flutter", "Instant");
+  ASSERT_EQ(Recorder().GetEventCount(), 1u);
+  Recorder().Clear();
+  ASSERT_EQ(Recorder().GetEventCount(), 0u);
+}
+
+TEST_F(TraceRecorderTest, RecordsEventsFromMultipleThreads) {
+  Recorder().SetEnabled(true);
+  // Once enough threads came and went, the buffers of exited threads are
+  // recycled. So no thread exits before all of them recorded their events.
+  fml::CountDownLatch recorded(4);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < 4; i++) {
+    threads.emplace_back([&recorded]() {
+      for (size_t j = 0; j < 100; j++) {
+        TRACE_EVENT0("flutter", "Work");
+      }
+      recorded.CountDown();
+      recorded.Wait();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(Recorder().GetEventCount(), 4u * 100u * 2u);
+}
+
+TEST_F(TraceRecorderTest, ChromeTraceJSON) {
+  Recorder().SetEnabled(true);
+  std::thread thread([]() {
+    Recorder().SetCurrentThreadName("test.thread");
+    {
+      TRACE_EVENT1("flutter", "Duration", "key", "va\"lue");
+    }
+    FML_TRACE_COUNTER("flutter", "Counter", 42);
+    TRACE_EVENT_ASYNC_BEGIN0("flutter", "Async", 0x1f);
+  });
+  thread.join();
+
+  const auto json = Recorder().GetChromeTraceJSON();
+  ASSERT_EQ(json.find("{\"traceEvents\":["), 0u);
+  ASSERT_NE(json.find("\"thread_name\""), std::string::npos);
+  ASSERT_NE(json.find("\"test.thread\""), std::string::npos);
+  ASSERT_NE(json.find("\"name\":\"Duration\",\"cat\":\"flutter\",\"ph\":\"B\""),
+            std::string::npos);
+  ASSERT_NE(json.find("\"ph\":\"E\""), std::string::npos);
+  ASSERT_NE(json.find("\"args\":{\"key\":\"va\\\"lue\"}"), std::string::npos);
+  ASSERT_NE(json.find("\"args\":{\"Counter\":42}"), std::string::npos);
+  ASSERT_NE(json.find("\"id\":\"0x1f\""), std::string::npos);
+}
+
+TEST_F(TraceRecorderTest, ChromeTraceJSONForTimeRange) {
+  Recorder().SetEnabled(true);
+  TRACE_EVENT_INSTANT0("flutter", "Before");
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  const auto start = fml::TimePoint::Now();
+  TRACE_EVENT_INSTANT0("flutter", "Within");
+  const auto end = fml::TimePoint::Now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  TRACE_EVENT_INSTANT0("flutter", "After");
+
+  const auto json = Recorder().GetChromeTraceJSON(start, end);
+  ASSERT_NE(json.find("\"Within\""), std::string::npos);
+  ASSERT_EQ(json.find("\"Before\""), std::string::npos);
+  ASSERT_EQ(json.find("\"After\""), std::string::npos);
+
+  const auto all = Recorder().GetChromeTraceJSON();
+  ASSERT_NE(all.find("\"Before\""), std::string::npos);
+  ASSERT_NE(all.find("\"After\""), std::string::npos);
+}
+
+}  // namespace tracing
+}  // namespace fml
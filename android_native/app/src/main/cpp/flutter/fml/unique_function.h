@@ -0,0 +1,206 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_UNIQUE_FUNCTION_H_
+#define FLUTTER_FML_UNIQUE_FUNCTION_H_
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/macros.h"
+
+namespace fml {
+
+template <typename Signature>
+class UniqueFunction;
+
+// A move-only alternative to |std::function|. Callables that fit in
+// |kInlineSize| bytes are stored inline instead of on the heap. That is
+// enough for lambdas that capture a weak pointer and a few values, and for
+// the result of |fml::MakeCopyable|. Since the callable is never copied, it
+// may capture move-only values directly.
+template <typename R, typename... Args>
+class UniqueFunction<R(Args...)> {
+ public:
+  static constexpr size_t kInlineSize = 6 * sizeof(void*);
+
+  UniqueFunction() = default;
+
+  UniqueFunction(std::nullptr_t) {}
+
+  template <typename Callable,
+            typename = std::enable_if_t<
+                !std::is_same<std::decay_t<Callable>, UniqueFunction>::value &&
+                !std::is_same<std::decay_t<Callable>, std::nullptr_t>::value>>
+  UniqueFunction(Callable&& callable) {
+    Init(std::forward<Callable>(callable));
+  }
+
+  UniqueFunction(UniqueFunction&& other) noexcept { MoveFrom(other); }
+
+  UniqueFunction& operator=(UniqueFunction&& other) noexcept {
+    if (this != &other) {
+      Reset();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  UniqueFunction& operator=(std::nullptr_t) {
+    Reset();
+    return *this;
+  }
+
+  ~UniqueFunction() { Reset(); }
+
+  R operator()(Args... args) {
+    FML_DCHECK(ops_ != nullptr);
+    return ops_->invoke(&storage_, std::forward<Args>(args)...);
+  }
+
+  explicit operator bool() const { return ops_ != nullptr; }
+
+  friend bool operator==(const UniqueFunction& function, std::nullptr_t) {
+    return !function;
+  }
+
+  friend bool operator!=(const UniqueFunction& function, std::nullptr_t) {
+    return static_cast<bool>(function);
+  }
+
+ private:
+  using Storage =
+      std::aligned_storage_t<kInlineSize, alignof(std::max_align_t)>;
+
+  struct Ops {
+    R (*invoke)(void* storage, Args&&... args);
+    // Move constructs the callable in |to| and destroys the one in |from|.
+    void (*relocate)(void* from, void* to);
+    void (*destroy)(void* storage);
+  };
+
+  template <typename Callable>
+  struct InlineOps {
+    static R Invoke(void* storage, Args&&... args) {
+      return (*static_cast<Callable*>(storage))(std::forward<Args>(args)...);
+    }
+
+    static void Relocate(void* from, void* to) {
+      auto* callable = static_cast<Callable*>(from);
+      new (to) Callable(std::move(*callable));
+      callable->~Callable();
+    }
+
+    static void Destroy(void* storage) {
+      static_cast<Callable*>(storage)->~Callable();
+    }
+
+    static const Ops* Get() {
+      static const Ops ops = {&Invoke, &Relocate, &Destroy};
+      return &ops;
+    }
+  };
+
+  template <typename Callable>
+  struct HeapOps {
+    static Callable*& Pointer(void* storage) {
+      return *static_cast<Callable**>(storage);
+    }
+
+    static R Invoke(void* storage, Args&&... args) {
+      return (*Pointer(storage))(std::forward<Args>(args)...);
+    }
+
+    static void Relocate(void* from, void* to) {
+      new (to) Callable*(Pointer(from));
+    }
+
+    static void Destroy(void* storage) { delete Pointer(storage); }
+
+    static const Ops* Get() {
+      static const Ops ops = {&Invoke, &Relocate, &Destroy};
+      return &ops;
+    }
+  };
+
+  // Moves are not required to be noexcept since the engine does not use
+  // exceptions. Many move constructors, like the one of |fml::RefPtr|, are not
+  // marked.
+  template <typename Callable>
+  static constexpr bool FitsInline() {
+    return sizeof(Callable) <= kInlineSize &&
+           alignof(Callable) <= alignof(Storage);
+  }
+
+  template <typename Callable>
+  static bool IsNull(const Callable&) {
+    return false;
+  }
+
+  template <typename Signature>
+  static bool IsNull(const std::function<Signature>& function) {
+    return !function;
+  }
+
+  template <typename Return, typename... Params>
+  static bool IsNull(Return (*function)(Params...)) {
+    return function == nullptr;
+  }
+
+  Storage storage_;
+  const Ops* ops_ = nullptr;
+
+  template <typename Callable>
+  void Init(Callable&& callable) {
+    using Stored = std::decay_t<Callable>;
+    if (IsNull(callable)) {
+      return;
+    }
+    // Dispatched at compile time so that the placement new of a callable
+    // too large for |storage_| is never instantiated.
+    Init<Stored>(std::forward<Callable>(callable),
+                 std::integral_constant<bool, FitsInline<Stored>()>());
+  }
+
+  template <typename Stored, typename Callable>
+  void Init(Callable&& callable, std::true_type /* fits_inline */) {
+    new (&storage_) Stored(std::forward<Callable>(callable));
+    ops_ = InlineOps<Stored>::Get();
+  }
+
+  template <typename Stored, typename Callable>
+  void Init(Callable&& callable, std::false_type /* fits_inline */) {
+    new (&storage_) Stored*(new Stored(std::forward<Callable>(callable)));
+    ops_ = HeapOps<Stored>::Get();
+  }
+
+  void MoveFrom(UniqueFunction& other) {
+    if (other.ops_ == nullptr) {
+      return;
+    }
+    other.ops_->relocate(&other.storage_, &storage_);
+    ops_ = other.ops_;
+    other.ops_ = nullptr;
+  }
+
+  void Reset() {
+    if (ops_ != nullptr) {
+      ops_->destroy(&storage_);
+      ops_ = nullptr;
+    }
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(UniqueFunction);
+};
+
+template <typename R, typename... Args>
+constexpr size_t UniqueFunction<R(Args...)>::kInlineSize;
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_UNIQUE_FUNCTION_H_
@@ -0,0 +1,131 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+#include "benchmark/benchmark.h"
+#include "flutter/fml/closure.h"
+#include "flutter/fml/make_copyable.h"
+#include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "flutter/fml/time/time_point.h"
+
+// Counts the allocations of all threads while |g_count_allocations| is set.
+static std::atomic_bool g_count_allocations(false);
+static std::atomic_size_t g_allocation_count(0);
+
+void* operator new(size_t size) {
+  if (g_count_allocations.load(std::memory_order_relaxed)) {
+    g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (void* allocation = std::malloc(size == 0 ? 1 : size)) {
+    return allocation;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* allocation) noexcept {
+  std::free(allocation);
+}
+
+void operator delete(void* allocation, size_t) noexcept {
+  std::free(allocation);
+}
+
+namespace fml {
+namespace {
+
+class ScopedAllocationCounter {
+ public:
+  ScopedAllocationCounter() {
+    g_allocation_count = 0;
+    g_count_allocations = true;
+  }
+
+  ~ScopedAllocationCounter() { g_count_allocations = false; }
+
+  size_t GetCount() const { return g_allocation_count; }
+};
+
+class Receiver {
+ public:
+  Receiver() : weak_factory_(this) {}
+
+  fml::WeakPtr<Receiver> GetWeakPtr() { return weak_factory_.GetWeakPtr(); }
+
+  void OnFrame(fml::TimePoint start, fml::TimePoint target) {
+    benchmark::DoNotOptimize(start);
+    benchmark::DoNotOptimize(target);
+  }
+
+ private:
+  fml::WeakPtrFactory<Receiver> weak_factory_;
+};
+
+// Wraps a callback shaped like the vsync and animator callbacks: a weak
+// pointer and two time points.
+template <typename Closure>
+void BM_WrapFrameCallback(benchmark::State& state) {
+  Receiver receiver;
+  auto weak = receiver.GetWeakPtr();
+  const auto now = fml::TimePoint::Now();
+  ScopedAllocationCounter counter;
+  for (auto _ : state) {
+    Closure task = [weak, now]() {
+      if (weak) {
+        weak->OnFrame(now, now);
+      }
+    };
+    task();
+  }
+  state.counters["allocations_per_task"] =
+      static_cast<double>(counter.GetCount()) / state.iterations();
+}
+
+BENCHMARK_TEMPLATE(BM_WrapFrameCallback, fml::closure);
+BENCHMARK_TEMPLATE(BM_WrapFrameCallback, fml::unique_closure);
+
+// Posts the tasks of one frame to a message loop: a vsync callback, a frame
+// request, a draw that hands over a move-only frame with
+// |fml::MakeCopyable|, and a reply to the UI thread.
+void BM_MessageLoopFrameTasks(benchmark::State& state) {
+  fml::Thread thread("benchmark");
+  auto runner = thread.GetTaskRunner();
+  Receiver receiver;
+  auto weak = receiver.GetWeakPtr();
+  fml::AutoResetWaitableEvent latch;
+
+  ScopedAllocationCounter counter;
+  for (auto _ : state) {
+    const auto now = fml::TimePoint::Now();
+    runner->PostTask([weak, now]() {
+      if (weak) {
+        weak->OnFrame(now, now);
+      }
+    });
+    runner->PostTask([weak, frame_number = state.iterations()]() {
+      benchmark::DoNotOptimize(frame_number);
+    });
+    auto frame = std::make_unique<fml::TimePoint>(now);
+    runner->PostTask(
+        fml::MakeCopyable([weak, frame = std::move(frame)]() mutable {
+          if (weak) {
+            weak->OnFrame(*frame, *frame);
+          }
+        }));
+    runner->PostTask([&latch]() { latch.Signal(); });
+    latch.Wait();
+  }
+  state.counters["allocations_per_frame"] =
+      static_cast<double>(counter.GetCount()) / state.iterations();
+}
+
+BENCHMARK(BM_MessageLoopFrameTasks);
+
+}  // namespace
+}  // namespace fml
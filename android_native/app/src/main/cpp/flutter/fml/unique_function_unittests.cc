@@ -0,0 +1,98 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <array>
+#include <memory>
+
+#include "flutter/fml/closure.h"
+#include "flutter/fml/make_copyable.h"
+#include "flutter/fml/unique_function.h"
+#include "gtest/gtest.h"
+
+namespace fml {
+
+TEST(UniqueFunctionTest, DefaultIsNull) {
+  unique_closure function;
+  ASSERT_FALSE(function);
+  ASSERT_TRUE(function == nullptr);
+
+  unique_closure from_null_closure = closure();
+  ASSERT_FALSE(from_null_closure);
+
+  void (*null_pointer)() = nullptr;
+  unique_closure from_null_pointer = null_pointer;
+  ASSERT_FALSE(from_null_pointer);
+}
+
+TEST(UniqueFunctionTest, CanInvokeWithArgumentsAndResult) {
+  UniqueFunction<int(int, int)> add = [](int a, int b) { return a + b; };
+  ASSERT_TRUE(add != nullptr);
+  ASSERT_EQ(add(2, 3), 5);
+}
+
+TEST(UniqueFunctionTest, CanCaptureMoveOnlyValues) {
+  auto value = std::make_unique<int>(42);
+  UniqueFunction<int()> function = [value = std::move(value)]() {
+    return *value;
+  };
+  ASSERT_EQ(function(), 42);
+}
+
+TEST(UniqueFunctionTest, CanPassMoveOnlyArguments) {
+  UniqueFunction<int(std::unique_ptr<int>)> function =
+      [](std::unique_ptr<int> value) { return value ? *value : 0; };
+  ASSERT_EQ(function(std::make_unique<int>(7)), 7);
+  ASSERT_EQ(function(nullptr), 0);
+}
+
+TEST(UniqueFunctionTest, MovingTransfersTheCallable) {
+  auto counter = std::make_shared<int>(0);
+  unique_closure first = [counter]() { (*counter)++; };
+  ASSERT_EQ(counter.use_count(), 2);
+
+  unique_closure second = std::move(first);
+  ASSERT_FALSE(first);
+  ASSERT_TRUE(second);
+  ASSERT_EQ(counter.use_count(), 2);
+  second();
+  ASSERT_EQ(*counter, 1);
+
+  unique_closure third;
+  third = std::move(second);
+  ASSERT_FALSE(second);
+  third();
+  ASSERT_EQ(*counter, 2);
+
+  third = nullptr;
+  ASSERT_EQ(counter.use_count(), 1);
+}
+
+TEST(UniqueFunctionTest, CollectsLargeCallables) {
+  auto counter = std::make_shared<int>(0);
+  std::array<char, 4 * unique_closure::kInlineSize> padding = {};
+  {
+    unique_closure function = [counter, padding]() { (*counter)++; };
+    unique_closure moved = std::move(function);
+    moved();
+    ASSERT_EQ(counter.use_count(), 2);
+  }
+  ASSERT_EQ(*counter, 1);
+  ASSERT_EQ(counter.use_count(), 1);
+}
+
+TEST(UniqueFunctionTest, AcceptsClosuresAndCopyableLambdas) {
+  int count = 0;
+  closure increment = [&count]() { count++; };
+  unique_closure copied = increment;
+  copied();
+  ASSERT_EQ(count, 1);
+
+  auto value = std::make_unique<int>(2);
+  unique_closure copyable = MakeCopyable(
+      [&count, value = std::move(value)]() { count += *value; });
+  copyable();
+  ASSERT_EQ(count, 3);
+}
+
+}  // namespace fml
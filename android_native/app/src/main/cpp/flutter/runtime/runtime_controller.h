@@ -54,6 +54,10 @@ class RuntimeController final : public WindowClient {
 
   bool NotifyIdle(int64_t deadline);
 
+  // Hands the timings of rasterized frames to the window. Each frame takes
+  // |FrameTiming::kCount| entries of microseconds since the epoch.
+  bool ReportTimings(std::vector<int64_t> timings);
+
   bool IsRootIsolateRunning() const;
 
   bool DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message);
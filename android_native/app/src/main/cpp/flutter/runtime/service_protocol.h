@@ -6,6 +6,7 @@
 #define FLUTTER_RUNTIME_SERVICE_PROTOCOL_H_
 
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 
@@ -4,6 +4,9 @@
 
 #include "flutter/shell/common/animator.h"
 
+#include <string>
+
+#include "flutter/fml/thread.h"
 #include "flutter/fml/trace_event.h"
 // TODO: boxue
 //#include "third_party/dart/runtime/include/dart_tools_api.h"
@@ -22,23 +25,30 @@ constexpr fml::TimeDelta kNotifyIdleTaskWaitTime =
 
 Animator::Animator(Delegate& delegate,
                    blink::TaskRunners task_runners,
-                   std::unique_ptr<VsyncWaiter> waiter)
+                   std::unique_ptr<VsyncWaiter> waiter,
+                   const blink::Settings& settings)
     : delegate_(delegate),
       task_runners_(std::move(task_runners)),
       waiter_(std::move(waiter)),
       last_begin_frame_time_(),
+      last_build_start_time_(),
       dart_frame_deadline_(0),
-      layer_tree_pipeline_(fml::MakeRefCounted<LayerTreePipeline>(2)),
+      layer_tree_pipeline_(fml::MakeRefCounted<LayerTreePipeline>(
+          settings.layer_tree_pipeline_depth,
+          settings.drop_superseded_frames
+              ? flutter::PipelineConsumePolicy::LatestWins
+              : flutter::PipelineConsumePolicy::InOrder)),
       pending_frame_semaphore_(1),
       frame_number_(1),
       paused_(false),
       regenerate_layer_tree_(false),
       frame_scheduled_(false),
-      notify_idle_task_id_(0),
       dimension_change_pending_(false),
       weak_factory_(this) {}
 
-Animator::~Animator() = default;
+Animator::~Animator() {
+  notify_idle_task_.Cancel();
+}
 
 void Animator::Stop() {
   paused_ = true;
@@ -79,9 +89,13 @@ static int64_t FxlToDartOrEarlier(fml::TimePoint time) {
 void Animator::BeginFrame(fml::TimePoint frame_start_time,
                           fml::TimePoint frame_target_time) {
   TRACE_EVENT_ASYNC_END0("flutter", "Frame Request Pending", frame_number_++);
+  TRACE_EVENT1("flutter", "Animator::BeginFrame", "cpu",
+               std::to_string(fml::Thread::GetCurrentCPU()).c_str());
 
   frame_scheduled_ = false;
-  notify_idle_task_id_++;
+  // Another frame is produced, so it is not safe (w.r.t. jank) to notify the
+  // engine that we are idle yet.
+  notify_idle_task_.Cancel();
   regenerate_layer_tree_ = false;
   pending_frame_semaphore_.Signal();
 
@@ -105,6 +119,7 @@ void Animator::BeginFrame(fml::TimePoint frame_start_time,
   FML_DCHECK(producer_continuation_);
 
   last_begin_frame_time_ = frame_start_time;
+  last_build_start_time_ = fml::TimePoint::Now();
   dart_frame_deadline_ = FxlToDartOrEarlier(frame_target_time);
   {
     TRACE_EVENT2("flutter", "Framework Workload", "mode", "basic", "frame",
@@ -120,23 +135,18 @@ void Animator::BeginFrame(fml::TimePoint frame_start_time,
     // viewport event).  Because of this, we hold off on calling
     // |OnAnimatorNotifyIdle| for a little bit, as that could cause garbage
     // collection to trigger at a highly undesirable time.
-    task_runners_.GetUITaskRunner()->PostDelayedTask(
-        [self = weak_factory_.GetWeakPtr(),
-         notify_idle_task_id = notify_idle_task_id_]() {
+    // The task is cancelled by the next frame, so it only runs if no further
+    // frames were produced.
+    notify_idle_task_ = task_runners_.GetUITaskRunner()->PostDelayedTask(
+        [self = weak_factory_.GetWeakPtr()]() {
           if (!self.get()) {
             return;
           }
-          // If our (this task's) task id is the same as the current one, then
-          // no further frames were produced, and it is safe (w.r.t. jank) to
-          // notify the engine we are idle.
-          if (notify_idle_task_id == self->notify_idle_task_id_) {
-            // self->delegate_.OnAnimatorNotifyIdle(Dart_TimelineGetMicros() +
-            //                                      100000);
-            fml::TimePoint fxl_now = fml::TimePoint::Now();
-            self->delegate_.OnAnimatorNotifyIdle(100000);
-          }
+          // self->delegate_.OnAnimatorNotifyIdle(Dart_TimelineGetMicros() +
+          //                                      100000);
+          self->delegate_.OnAnimatorNotifyIdle(100000);
         },
-        kNotifyIdleTaskWaitTime);
+        kNotifyIdleTaskWaitTime, fml::TaskPriority::kIdle);
   }
 }
 
@@ -148,9 +158,8 @@ void Animator::Render(std::unique_ptr<flow::LayerTree> layer_tree) {
   last_layer_tree_size_ = layer_tree->frame_size();
 
   if (layer_tree) {
-    // Note the frame time for instrumentation.
-    layer_tree->set_construction_time(fml::TimePoint::Now() -
-                                      last_begin_frame_time_);
+    // Note the frame times for instrumentation.
+    layer_tree->RecordBuildTime(last_begin_frame_time_, last_build_start_time_);
   }
 
   // Commit the pending continuation.
@@ -196,7 +205,7 @@ void Animator::RequestFrame(bool regenerate_layer_tree) {
     }
     TRACE_EVENT_ASYNC_BEGIN0("flutter", "Frame Request Pending", frame_number);
     self->AwaitVSync();
-  });
+  }, fml::TaskPriority::kFrame);
   frame_scheduled_ = true;
 }
 
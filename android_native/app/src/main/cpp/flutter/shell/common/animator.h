@@ -5,9 +5,11 @@
 #ifndef FLUTTER_SHELL_COMMON_ANIMATOR_H_
 #define FLUTTER_SHELL_COMMON_ANIMATOR_H_
 
+#include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/memory/ref_ptr.h"
 #include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/fml/task_handle.h"
 #include "flutter/fml/time/time_point.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/vsync_waiter.h"
@@ -32,7 +34,8 @@ class Animator final {
 
   Animator(Delegate& delegate,
            blink::TaskRunners task_runners,
-           std::unique_ptr<VsyncWaiter> waiter);
+           std::unique_ptr<VsyncWaiter> waiter,
+           const blink::Settings& settings);
 
   ~Animator();
 
@@ -64,6 +67,7 @@ class Animator final {
   std::shared_ptr<VsyncWaiter> waiter_;
 
   fml::TimePoint last_begin_frame_time_;
+  fml::TimePoint last_build_start_time_;
   int64_t dart_frame_deadline_;
   fml::RefPtr<LayerTreePipeline> layer_tree_pipeline_;
   flutter::Semaphore pending_frame_semaphore_;
@@ -72,7 +76,7 @@ class Animator final {
   bool paused_;
   bool regenerate_layer_tree_;
   bool frame_scheduled_;
-  int notify_idle_task_id_;
+  fml::TaskHandle notify_idle_task_;
   bool dimension_change_pending_;
   SkISize last_layer_tree_size_;
 
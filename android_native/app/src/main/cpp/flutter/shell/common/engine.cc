@@ -163,6 +163,11 @@ void Engine::NotifyIdle(int64_t deadline) {
   runtime_controller_->NotifyIdle(deadline);
 }
 
+void Engine::ReportTimings(std::vector<int64_t> timings) {
+  TRACE_EVENT0("flutter", "Engine::ReportTimings");
+  runtime_controller_->ReportTimings(std::move(timings));
+}
+
 // std::pair<bool, uint32_t> Engine::GetUIIsolateReturnCode() {
 //   return runtime_controller_->GetRootIsolateReturnCode();
 // }
@@ -362,6 +367,10 @@ void Engine::Render(std::unique_ptr<flow::LayerTree> layer_tree) {
     return;
 
   layer_tree->set_frame_size(frame_size);
+  if (!settings_.slow_frame_capture_path.empty()) {
+    layer_tree->set_rasterizer_tracing_threshold(
+        settings_.slow_frame_capture_threshold);
+  }
   animator_->Render(std::move(layer_tree));
 }
 
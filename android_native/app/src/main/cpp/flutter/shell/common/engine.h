@@ -7,6 +7,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "flutter/assets/asset_manager.h"
 #include "flutter/common/task_runners.h"
@@ -83,6 +84,9 @@ class Engine final : public blink::RuntimeDelegate {
 
   void NotifyIdle(int64_t deadline);
 
+  // See |blink::RuntimeController::ReportTimings|.
+  void ReportTimings(std::vector<int64_t> timings);
+
 //   Dart_Port GetUIIsolateMainPort();
 
 //   std::string GetUIIsolateName();
@@ -0,0 +1,171 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_capture_ring.h"
+
+#include <sstream>
+#include <utility>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/make_copyable.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/fml/trace_recorder.h"
+#include "flutter/fml/unique_fd.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkSerialProcs.h"
+#include "third_party/skia/include/core/SkTypeface.h"
+
+namespace shell {
+
+struct FrameCaptureRing::State {
+  std::string directory_path;
+  size_t capacity;
+  // Opened on the first write.
+  fml::UniqueFD directory;
+  uint64_t next_sequence = 0;
+};
+
+FrameCaptureRing::FrameCaptureRing(fml::RefPtr<fml::TaskRunner> task_runner,
+                                   std::string directory_path,
+                                   size_t capacity)
+    : task_runner_(std::move(task_runner)),
+      state_(std::make_shared<State>()) {
+  FML_DCHECK(task_runner_);
+  FML_DCHECK(capacity > 0);
+  state_->directory_path = std::move(directory_path);
+  state_->capacity = capacity;
+}
+
+FrameCaptureRing::~FrameCaptureRing() = default;
+
+void FrameCaptureRing::Add(FrameCapture capture) {
+  task_runner_->PostTask(fml::MakeCopyable(
+      [state = state_, capture = std::move(capture)]() mutable {
+        Write(state.get(), capture);
+      }));
+}
+
+static bool WriteFile(const fml::UniqueFD& directory,
+                      const char* file_name,
+                      const uint8_t* data,
+                      size_t size) {
+  fml::NonOwnedMapping mapping(data, size);
+  if (!fml::WriteAtomically(directory, file_name, mapping)) {
+    FML_LOG(ERROR) << "Could not write the frame capture file " << file_name;
+    return false;
+  }
+  return true;
+}
+
+static bool WriteFile(const fml::UniqueFD& directory,
+                      const char* file_name,
+                      const std::string& contents) {
+  return WriteFile(directory, file_name,
+                   reinterpret_cast<const uint8_t*>(contents.data()),
+                   contents.size());
+}
+
+static sk_sp<SkData> SerializeTypeface(SkTypeface* typeface, void* ctx) {
+  return typeface->serialize(SkTypeface::SerializeBehavior::kDoIncludeData);
+}
+
+static sk_sp<SkData> SerializeImage(SkImage* image, void* ctx) {
+  // Reading back a texture needs the GrContext of the GPU thread. Empty data
+  // leaves the image out. Null has Skia encode it.
+  return image->isTextureBacked() ? SkData::MakeEmpty() : nullptr;
+}
+
+static sk_sp<SkData> SerializePicture(SkPicture* picture) {
+  TRACE_EVENT0("flutter", "FrameCaptureRing::SerializePicture");
+  SkSerialProcs procs;
+  procs.fImageProc = SerializeImage;
+  procs.fTypefaceProc = SerializeTypeface;
+  return picture->serialize(&procs);
+}
+
+static std::string DescribeTiming(uint64_t sequence,
+                                  const blink::FrameTiming& timing) {
+  static const char* kPhaseNames[blink::FrameTiming::kCount] = {
+      "vsync_start",  "build_start",   "build_finish",
+      "raster_start", "raster_finish", "submit",
+  };
+  std::stringstream stream;
+  stream << "sequence: " << sequence << std::endl;
+  for (int i = 0; i < blink::FrameTiming::kCount; i++) {
+    const auto phase = static_cast<blink::FrameTiming::Phase>(i);
+    stream << kPhaseNames[i] << "_micros: "
+           << timing.Get(phase).ToEpochDelta().ToMicroseconds() << std::endl;
+  }
+  return stream.str();
+}
+
+void FrameCaptureRing::Write(State* state, const FrameCapture& capture) {
+  TRACE_EVENT0("flutter", "FrameCaptureRing::Write");
+  if (!state->directory.is_valid()) {
+    state->directory =
+        fml::OpenDirectory(state->directory_path.c_str(), true,
+                           fml::FilePermission::kReadWrite);
+    if (!state->directory.is_valid()) {
+      FML_LOG(ERROR) << "Could not open the frame capture directory "
+                     << state->directory_path;
+      return;
+    }
+  }
+
+  const uint64_t sequence = state->next_sequence++;
+  const std::string slot = std::to_string(sequence % state->capacity);
+  auto slot_directory = fml::OpenDirectory(
+      state->directory, slot.c_str(), true, fml::FilePermission::kReadWrite);
+  if (!slot_directory.is_valid()) {
+    FML_LOG(ERROR) << "Could not open the frame capture directory " << slot;
+    return;
+  }
+
+  // The trace is exported here rather than while capturing so that the GPU
+  // thread does not pay for it. The events of the frame are recent enough to
+  // still be in the ring buffers of the recorder.
+  const std::string trace =
+      fml::tracing::TraceRecorder::GetInstance().GetChromeTraceJSON(
+          capture.timing.Get(blink::FrameTiming::kVsyncStart),
+          capture.timing.Get(blink::FrameTiming::kSubmit));
+
+  sk_sp<SkData> picture =
+      capture.picture ? SerializePicture(capture.picture.get()) : nullptr;
+
+  // Do not leave the picture of the capture this one replaces behind.
+  if (!picture && fml::FileExists(slot_directory, "frame.skp")) {
+    fml::UnlinkFile(slot_directory, "frame.skp");
+  }
+
+  // Likewise for the layer profile.
+  const bool has_layer_profile = !capture.layer_profile.empty();
+  if (!has_layer_profile) {
+    for (const char* name : {"layer_profile.folded", "layer_types.txt"}) {
+      if (fml::FileExists(slot_directory, name)) {
+        fml::UnlinkFile(slot_directory, name);
+      }
+    }
+  }
+
+  const bool written =
+      (!has_layer_profile ||
+       (WriteFile(slot_directory, "layer_profile.folded",
+                  capture.layer_profile) &&
+        WriteFile(slot_directory, "layer_types.txt",
+                  capture.layer_type_profile))) &&
+      (!picture || WriteFile(slot_directory, "frame.skp", picture->bytes(),
+                             picture->size())) &&
+      WriteFile(slot_directory, "layer_tree.txt", capture.layer_tree) &&
+      WriteFile(slot_directory, "trace.json", trace) &&
+      WriteFile(slot_directory, "timing.txt",
+                DescribeTiming(sequence, capture.timing));
+  if (written) {
+    FML_LOG(INFO) << "Captured a slow frame to " << state->directory_path
+                  << "/" << slot;
+  }
+}
+
+}  // namespace shell
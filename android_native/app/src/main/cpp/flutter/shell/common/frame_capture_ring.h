@@ -0,0 +1,79 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_FRAME_CAPTURE_RING_H_
+#define SHELL_COMMON_FRAME_CAPTURE_RING_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+
+#include "flutter/common/settings.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/ref_ptr.h"
+#include "flutter/fml/task_runner.h"
+#include "third_party/skia/include/core/SkPicture.h"
+
+namespace shell {
+
+// What the rasterizer captured of a frame that took too long. See
+// |flow::LayerTree::rasterizer_tracing_threshold|.
+struct FrameCapture {
+  blink::FrameTiming timing;
+  // The picture of the frame. Serialized by the ring in the background.
+  sk_sp<SkPicture> picture;
+  // See |flow::LayerTree::Dump|.
+  std::string layer_tree;
+  // See |flow::LayerProfile|. Empty unless layer profiling is enabled.
+  std::string layer_profile;
+  std::string layer_type_profile;
+};
+
+// Writes frame captures to a directory on a background task runner. Each
+// capture goes to the subdirectory named after its slot in the ring, "0" up
+// to the capacity minus one, and consists of:
+//
+//  - "frame.skp", the picture of the frame. Can be loaded into the Skia
+//    debugger. Images backed by textures are left out since they can only be
+//    read back on the GPU thread.
+//  - "layer_tree.txt", the layer tree with the paint cost of each layer.
+//  - "layer_profile.folded" and "layer_types.txt", the measured preroll and
+//    paint times of the layers as folded stacks for flame graph tools and
+//    per layer type. Only written if layer profiling is enabled.
+//  - "trace.json", the trace events recorded from the vsync of the frame
+//    till its submission in the Chrome trace event format. Empty unless the
+//    trace recorder was enabled.
+//  - "timing.txt", the sequence number of the capture and the frame timing.
+//    Written last.
+//
+// Once all slots are used, the oldest capture is overwritten. So the
+// directory never holds more than |capacity| captures.
+class FrameCaptureRing {
+ public:
+  FrameCaptureRing(fml::RefPtr<fml::TaskRunner> task_runner,
+                   std::string directory_path,
+                   size_t capacity);
+
+  ~FrameCaptureRing();
+
+  // Writes the capture on the task runner. Pending writes complete even if
+  // the ring is destroyed first.
+  void Add(FrameCapture capture);
+
+ private:
+  struct State;
+
+  fml::RefPtr<fml::TaskRunner> task_runner_;
+  // Only accessed on |task_runner_|.
+  std::shared_ptr<State> state_;
+
+  static void Write(State* state, const FrameCapture& capture);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameCaptureRing);
+};
+
+}  // namespace shell
+
+#endif  // SHELL_COMMON_FRAME_CAPTURE_RING_H_
@@ -0,0 +1,105 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "flutter/shell/common/frame_capture_ring.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+
+namespace shell {
+namespace {
+
+const char* kSlots[] = {"0", "1"};
+const char* kFiles[] = {
+    "frame.skp",       "layer_tree.txt", "layer_profile.folded",
+    "layer_types.txt", "trace.json",     "timing.txt",
+};
+
+FrameCapture MakeCapture(bool with_picture_and_profile) {
+  FrameCapture capture;
+  capture.layer_tree = "ContainerLayer\n";
+  if (with_picture_and_profile) {
+    SkPictureRecorder recorder;
+    recorder.beginRecording(SkRect::MakeWH(16, 16))->drawColor(SK_ColorRED);
+    capture.picture = recorder.finishRecordingAsPicture();
+    capture.layer_profile = "Paint;ContainerLayer 10\n";
+    capture.layer_type_profile = "ContainerLayer\n";
+  }
+  return capture;
+}
+
+std::string ReadFile(const fml::UniqueFD& directory, const char* path) {
+  auto file = fml::OpenFile(directory, path, false, fml::FilePermission::kRead);
+  if (!file.is_valid()) {
+    return "";
+  }
+  fml::FileMapping mapping(file);
+  return std::string(reinterpret_cast<const char*>(mapping.GetMapping()),
+                     mapping.GetSize());
+}
+
+// Waits for the writes posted to |thread| so far.
+void Flush(fml::Thread& thread) {
+  fml::AutoResetWaitableEvent latch;
+  thread.GetTaskRunner()->PostTask([&latch]() { latch.Signal(); });
+  latch.Wait();
+}
+
+}  // namespace
+
+TEST(FrameCaptureRing, WrapsAroundAndRemovesStaleFiles) {
+  const std::string path = fml::CreateTemporaryDirectory();
+  ASSERT_FALSE(path.empty());
+  auto directory =
+      fml::OpenDirectory(path.c_str(), false, fml::FilePermission::kRead);
+  fml::Thread thread("io");
+  {
+    FrameCaptureRing ring(thread.GetTaskRunner(), path, 2);
+    for (int i = 0; i < 3; i++) {
+      ring.Add(MakeCapture(true));
+    }
+    Flush(thread);
+
+    // The third capture replaced the first.
+    ASSERT_FALSE(fml::FileExists(directory, "2"));
+    ASSERT_EQ(ReadFile(directory, "0/timing.txt").find("sequence: 2\n"), 0u);
+    ASSERT_EQ(ReadFile(directory, "1/timing.txt").find("sequence: 1\n"), 0u);
+    for (const char* slot : kSlots) {
+      for (const char* file : kFiles) {
+        const std::string file_path = std::string(slot) + "/" + file;
+        ASSERT_TRUE(fml::FileExists(directory, file_path.c_str()))
+            << file_path;
+      }
+    }
+    ASSERT_EQ(ReadFile(directory, "1/layer_profile.folded"),
+              "Paint;ContainerLayer 10\n");
+
+    // A capture without a picture or profile does not leave the ones of the
+    // capture it replaces behind.
+    ring.Add(MakeCapture(false));
+    Flush(thread);
+    ASSERT_EQ(ReadFile(directory, "1/timing.txt").find("sequence: 3\n"), 0u);
+    ASSERT_FALSE(fml::FileExists(directory, "1/frame.skp"));
+    ASSERT_FALSE(fml::FileExists(directory, "1/layer_profile.folded"));
+    ASSERT_FALSE(fml::FileExists(directory, "1/layer_types.txt"));
+    ASSERT_TRUE(fml::FileExists(directory, "0/frame.skp"));
+  }
+
+  for (const char* slot : kSlots) {
+    for (const char* file : kFiles) {
+      const std::string file_path = std::string(slot) + "/" + file;
+      fml::UnlinkFile(directory, file_path.c_str());
+    }
+    fml::UnlinkDirectory(directory, slot);
+  }
+  ASSERT_TRUE(fml::UnlinkDirectory(path.c_str()));
+}
+
+}  // namespace shell
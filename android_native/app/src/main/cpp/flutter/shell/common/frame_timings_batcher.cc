@@ -0,0 +1,73 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_timings_batcher.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace shell {
+
+FrameTimingsBatcher::FrameTimingsBatcher(
+    fml::RefPtr<fml::TaskRunner> task_runner,
+    size_t report_count,
+    fml::TimeDelta report_interval,
+    FlushCallback flush)
+    : task_runner_(std::move(task_runner)),
+      report_count_(std::max<size_t>(report_count, 1)),
+      report_interval_(report_interval),
+      flush_(std::move(flush)),
+      weak_factory_(this) {
+  FML_DCHECK(task_runner_);
+  FML_DCHECK(flush_);
+}
+
+FrameTimingsBatcher::~FrameTimingsBatcher() {
+  flush_task_.Cancel();
+}
+
+void FrameTimingsBatcher::Add(const blink::FrameTiming& timing) {
+  FML_DCHECK(task_runner_->RunsTasksOnCurrentThread());
+
+  pending_.push_back(timing);
+  if (pending_.size() >= report_count_) {
+    Flush();
+    return;
+  }
+
+  if (pending_.size() > 1) {
+    return;
+  }
+
+  // Frames may stop coming before the batch is full. So every batch is also
+  // flushed once its first frame is old enough, unless it filled up first.
+  flush_task_ = task_runner_->PostDelayedTask(
+      [weak = weak_factory_.GetWeakPtr()]() {
+        if (weak) {
+          weak->Flush();
+        }
+      },
+      report_interval_);
+}
+
+void FrameTimingsBatcher::Flush() {
+  FML_DCHECK(task_runner_->RunsTasksOnCurrentThread());
+
+  flush_task_.Cancel();
+  if (pending_.empty()) {
+    return;
+  }
+
+  std::vector<blink::FrameTiming> timings;
+  timings.swap(pending_);
+  TRACE_EVENT1("flutter", "FrameTimingsBatcher::Flush", "frames",
+               std::to_string(timings.size()).c_str());
+  flush_(std::move(timings));
+}
+
+}  // namespace shell
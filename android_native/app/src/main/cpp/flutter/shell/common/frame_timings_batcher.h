@@ -0,0 +1,61 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_COMMON_FRAME_TIMINGS_BATCHER_H_
+#define SHELL_COMMON_FRAME_TIMINGS_BATCHER_H_
+
+#include <stddef.h>
+
+#include <functional>
+#include <vector>
+
+#include "flutter/common/settings.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/fml/task_runner.h"
+#include "flutter/fml/time/time_delta.h"
+
+namespace shell {
+
+// Collects frame timings and hands them to |flush| in batches. A batch is
+// flushed once it holds |report_count| frames or once its oldest frame was
+// added |report_interval| ago, whichever comes first. Must be created, used
+// and destroyed on |task_runner|. Pending timings are dropped on destruction.
+class FrameTimingsBatcher {
+ public:
+  using FlushCallback =
+      std::function<void(std::vector<blink::FrameTiming> /* timings */)>;
+
+  FrameTimingsBatcher(fml::RefPtr<fml::TaskRunner> task_runner,
+                      size_t report_count,
+                      fml::TimeDelta report_interval,
+                      FlushCallback flush);
+
+  ~FrameTimingsBatcher();
+
+  void Add(const blink::FrameTiming& timing);
+
+  // Hands the pending timings to the flush callback right away. Does nothing
+  // if there are none.
+  void Flush();
+
+  size_t pending_count() const { return pending_.size(); }
+
+ private:
+  fml::RefPtr<fml::TaskRunner> task_runner_;
+  const size_t report_count_;
+  const fml::TimeDelta report_interval_;
+  FlushCallback flush_;
+  std::vector<blink::FrameTiming> pending_;
+  // The delayed flush of the pending batch. Cancelled by every flush so that
+  // it does not cut the next batch short.
+  fml::TaskHandle flush_task_;
+  fml::WeakPtrFactory<FrameTimingsBatcher> weak_factory_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameTimingsBatcher);
+};
+
+}  // namespace shell
+
+#endif  // SHELL_COMMON_FRAME_TIMINGS_BATCHER_H_
@@ -0,0 +1,145 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
+#include "flutter/fml/time/time_point.h"
+#include "flutter/shell/common/frame_timings_batcher.h"
+#include "gtest/gtest.h"
+
+namespace shell {
+namespace {
+
+blink::FrameTiming MakeTiming(int64_t vsync_start_micros) {
+  blink::FrameTiming timing;
+  timing.Set(blink::FrameTiming::kVsyncStart,
+             fml::TimePoint::FromEpochDelta(
+                 fml::TimeDelta::FromMicroseconds(vsync_start_micros)));
+  return timing;
+}
+
+}  // namespace
+
+TEST(FrameTimingsBatcherTest, FlushesFullBatchesRightAway) {
+  fml::Thread thread("gpu");
+  auto task_runner = thread.GetTaskRunner();
+  std::vector<size_t> batches;
+  size_t pending = 0;
+  fml::AutoResetWaitableEvent latch;
+  task_runner->PostTask([&]() {
+    FrameTimingsBatcher batcher(
+        task_runner, 3, fml::TimeDelta::FromSeconds(3600),
+        [&batches](std::vector<blink::FrameTiming> timings) {
+          batches.push_back(timings.size());
+        });
+    for (int64_t frame = 0; frame < 7; frame++) {
+      batcher.Add(MakeTiming(frame));
+    }
+    pending = batcher.pending_count();
+    latch.Signal();
+  });
+  latch.Wait();
+  ASSERT_EQ(batches, (std::vector<size_t>{3, 3}));
+  ASSERT_EQ(pending, 1u);
+}
+
+TEST(FrameTimingsBatcherTest, FlushesPartialBatchesAfterTheInterval) {
+  fml::Thread thread("gpu");
+  auto task_runner = thread.GetTaskRunner();
+  const auto interval = fml::TimeDelta::FromMilliseconds(20);
+  std::unique_ptr<FrameTimingsBatcher> batcher;
+  std::vector<blink::FrameTiming> flushed;
+  fml::TimePoint added;
+  fml::TimePoint flushed_at;
+  fml::AutoResetWaitableEvent latch;
+  task_runner->PostTask([&]() {
+    batcher = std::make_unique<FrameTimingsBatcher>(
+        task_runner, 100, interval,
+        [&](std::vector<blink::FrameTiming> timings) {
+          flushed = std::move(timings);
+          flushed_at = fml::TimePoint::Now();
+          latch.Signal();
+        });
+    added = fml::TimePoint::Now();
+    batcher->Add(MakeTiming(1));
+    batcher->Add(MakeTiming(2));
+  });
+  latch.Wait();
+  ASSERT_EQ(flushed.size(), 2u);
+  ASSERT_EQ(flushed[0].Get(blink::FrameTiming::kVsyncStart),
+            MakeTiming(1).Get(blink::FrameTiming::kVsyncStart));
+  ASSERT_GE(flushed_at - added, interval);
+  task_runner->PostTask([&]() {
+    batcher.reset();
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
+TEST(FrameTimingsBatcherTest, FullBatchesDoNotCutTheNextBatchShort) {
+  fml::Thread thread("gpu");
+  auto task_runner = thread.GetTaskRunner();
+  const auto interval = fml::TimeDelta::FromMilliseconds(40);
+  std::unique_ptr<FrameTimingsBatcher> batcher;
+  std::vector<size_t> batches;
+  fml::TimePoint added;
+  fml::TimePoint flushed_at;
+  fml::AutoResetWaitableEvent latch;
+  task_runner->PostTask([&]() {
+    batcher = std::make_unique<FrameTimingsBatcher>(
+        task_runner, 2, interval,
+        [&](std::vector<blink::FrameTiming> timings) {
+          batches.push_back(timings.size());
+          if (batches.size() == 2) {
+            flushed_at = fml::TimePoint::Now();
+            latch.Signal();
+          }
+        });
+    // Fills up before its delayed flush is due.
+    batcher->Add(MakeTiming(1));
+    batcher->Add(MakeTiming(2));
+  });
+  task_runner->PostDelayedTask(
+      [&]() {
+        added = fml::TimePoint::Now();
+        batcher->Add(MakeTiming(3));
+      },
+      interval / 2);
+  latch.Wait();
+  ASSERT_EQ(batches, (std::vector<size_t>{2, 1}));
+  ASSERT_GE(flushed_at - added, interval);
+  task_runner->PostTask([&]() {
+    batcher.reset();
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
+TEST(FrameTimingsBatcherTest, FlushesOnDemand) {
+  fml::Thread thread("gpu");
+  auto task_runner = thread.GetTaskRunner();
+  std::vector<size_t> batches;
+  fml::AutoResetWaitableEvent latch;
+  task_runner->PostTask([&]() {
+    FrameTimingsBatcher batcher(
+        task_runner, 100, fml::TimeDelta::FromSeconds(3600),
+        [&batches](std::vector<blink::FrameTiming> timings) {
+          batches.push_back(timings.size());
+        });
+    // Nothing to flush yet.
+    batcher.Flush();
+    batcher.Add(MakeTiming(1));
+    batcher.Add(MakeTiming(2));
+    batcher.Flush();
+    batcher.Flush();
+    latch.Signal();
+  });
+  latch.Wait();
+  ASSERT_EQ(batches, (std::vector<size_t>{2}));
+}
+
+}  // namespace shell
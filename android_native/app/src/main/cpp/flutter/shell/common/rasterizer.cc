@@ -4,8 +4,10 @@
 
 #include "flutter/shell/common/rasterizer.h"
 
+#include <string>
 #include <utility>
 
+#include "flutter/fml/thread.h"
 #include "third_party/skia/include/core/SkEncodedImageFormat.h"
 #include "third_party/skia/include/core/SkImageEncoder.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
@@ -20,14 +22,17 @@ namespace shell {
 // used within this interval.
 static constexpr std::chrono::milliseconds kSkiaCleanupExpiration(15000);
 
-Rasterizer::Rasterizer(blink::TaskRunners task_runners)
-    : Rasterizer(std::move(task_runners),
+Rasterizer::Rasterizer(Delegate& delegate, blink::TaskRunners task_runners)
+    : Rasterizer(delegate,
+                 std::move(task_runners),
                  std::make_unique<flow::CompositorContext>()) {}
 
 Rasterizer::Rasterizer(
+    Delegate& delegate,
     blink::TaskRunners task_runners,
     std::unique_ptr<flow::CompositorContext> compositor_context)
-    : task_runners_(std::move(task_runners)),
+    : delegate_(delegate),
+      task_runners_(std::move(task_runners)),
       compositor_context_(std::move(compositor_context)),
       weak_factory_(this) {
   FML_DCHECK(compositor_context_);
@@ -45,6 +50,7 @@ fml::WeakPtr<blink::SnapshotDelegate> Rasterizer::GetSnapshotDelegate() const {
 
 void Rasterizer::Setup(std::unique_ptr<Surface> surface) {
   surface_ = std::move(surface);
+  ResetDamageTracking();
   compositor_context_->OnGrContextCreated();
 }
 
@@ -52,6 +58,12 @@ void Rasterizer::Teardown() {
   compositor_context_->OnGrContextDestroyed();
   surface_.reset();
   last_layer_tree_.reset();
+  ResetDamageTracking();
+}
+
+void Rasterizer::ResetDamageTracking() {
+  damage_tracker_.Reset();
+  last_frame_image_.reset();
 }
 
 flow::TextureRegistry* Rasterizer::GetTextureRegistry() {
@@ -71,14 +83,17 @@ void Rasterizer::DrawLastLayerTree() {
 
 void Rasterizer::Draw(
     fml::RefPtr<flutter::Pipeline<flow::LayerTree>> pipeline) {
-  TRACE_EVENT0("flutter", "GPURasterizer::Draw");
+  TRACE_EVENT1("flutter", "GPURasterizer::Draw", "cpu",
+               std::to_string(fml::Thread::GetCurrentCPU()).c_str());
 
   flutter::Pipeline<flow::LayerTree>::Consumer consumer =
       std::bind(&Rasterizer::DoDraw, this, std::placeholders::_1);
+  flutter::Pipeline<flow::LayerTree>::Consumer dropped =
+      std::bind(&Rasterizer::DoDrop, this, std::placeholders::_1);
 
   // Consume as many pipeline items as possible. But yield the event loop
   // between successive tries.
-  switch (pipeline->Consume(consumer)) {
+  switch (pipeline->Consume(consumer, dropped)) {
     case flutter::PipelineConsumeResult::MoreAvailable: {
       task_runners_.GetGPUTaskRunner()->PostTask(
           [weak_this = weak_factory_.GetWeakPtr(), pipeline]() {
@@ -149,14 +164,51 @@ void Rasterizer::DoDraw(std::unique_ptr<flow::LayerTree> layer_tree) {
     return;
   }
 
-  if (DrawToSurface(*layer_tree)) {
+  blink::FrameTiming timing;
+  timing.Set(blink::FrameTiming::kVsyncStart, layer_tree->vsync_start());
+  timing.Set(blink::FrameTiming::kBuildStart, layer_tree->build_start());
+  timing.Set(blink::FrameTiming::kBuildFinish, layer_tree->build_finish());
+
+  if (DrawToSurface(*layer_tree, &timing)) {
+    const fml::TimeDelta frame_time =
+        timing.Get(blink::FrameTiming::kSubmit) -
+        timing.Get(blink::FrameTiming::kVsyncStart);
+    const uint32_t tracing_threshold =
+        layer_tree->rasterizer_tracing_threshold();
+    if (tracing_threshold > 0 &&
+        frame_time.ToMillisecondsF() > tracing_threshold * flow::kOneFrameMS &&
+        timing.Get(blink::FrameTiming::kVsyncStart) >=
+            slow_frame_capture_cooldown_end_) {
+      CaptureSlowFrame(*layer_tree, timing);
+    }
     last_layer_tree_ = std::move(layer_tree);
+    compositor_context_->vsync_to_submit_time().SetLapTime(frame_time);
+    delegate_.OnFrameRasterized(timing);
+  }
+}
+
+void Rasterizer::DoDrop(std::unique_ptr<flow::LayerTree> layer_tree) {
+  if (!layer_tree) {
+    return;
   }
+
+  // The raster phases stay at zero to tell the frame apart from the ones
+  // that were rasterized.
+  blink::FrameTiming timing;
+  timing.Set(blink::FrameTiming::kVsyncStart, layer_tree->vsync_start());
+  timing.Set(blink::FrameTiming::kBuildStart, layer_tree->build_start());
+  timing.Set(blink::FrameTiming::kBuildFinish, layer_tree->build_finish());
+  delegate_.OnFrameDropped(timing);
 }
 
-bool Rasterizer::DrawToSurface(flow::LayerTree& layer_tree) {
+bool Rasterizer::DrawToSurface(flow::LayerTree& layer_tree,
+                               blink::FrameTiming* timing) {
   FML_DCHECK(surface_);
 
+  if (timing != nullptr) {
+    timing->Set(blink::FrameTiming::kRasterStart, fml::TimePoint::Now());
+  }
+
   auto frame = surface_->AcquireFrame(layer_tree.frame_size());
 
   if (frame == nullptr) {
@@ -180,15 +232,49 @@ bool Rasterizer::DrawToSurface(flow::LayerTree& layer_tree) {
       surface_->GetContext(), canvas, external_view_embedder,
       surface_->GetRootTransformation(), true);
 
-  if (canvas) {
-    canvas->clear(SK_ColorTRANSPARENT);
+  // Only repaint what changed since the last frame. Platform views are drawn
+  // into canvases the damage tracker knows nothing about. So frames with an
+  // external view embedder are always repainted fully.
+  flow::FrameDamage frame_damage;
+  flow::FrameDamage* damage = nullptr;
+  if (canvas && external_view_embedder == nullptr) {
+    frame_damage.tracker = &damage_tracker_;
+    frame_damage.buffer_age = PrepareFrameBuffer(*frame);
+    damage = &frame_damage;
+  } else {
+    ResetDamageTracking();
+    if (canvas) {
+      canvas->clear(SK_ColorTRANSPARENT);
+    }
   }
 
-  if (compositor_frame && compositor_frame->Raster(layer_tree, false)) {
-    frame->Submit();
+  if (compositor_frame && compositor_frame->Raster(layer_tree, false, damage)) {
+    layer_tree.set_layer_profile(compositor_frame->TakeLayerProfile());
+    if (timing != nullptr) {
+      timing->Set(blink::FrameTiming::kRasterFinish, fml::TimePoint::Now());
+    }
+    if (damage != nullptr) {
+      frame->set_damage(damage_tracker_.last_frame_damage());
+      // Only buffers with unknown contents are copied back into. A snapshot
+      // of a buffer that keeps its contents would be a wasted full copy.
+      const auto& framebuffer_info = frame->framebuffer_info();
+      if (framebuffer_info.supports_copy_back &&
+          framebuffer_info.buffer_age == 0) {
+        last_frame_image_ = frame->SkiaSurface()->makeImageSnapshot();
+      } else {
+        last_frame_image_.reset();
+      }
+    }
+    if (!frame->Submit()) {
+      // The damage tracker assumes the frame made it on screen.
+      ResetDamageTracking();
+    }
     if (external_view_embedder != nullptr) {
       external_view_embedder->SubmitFrame(surface_->GetContext());
     }
+    if (timing != nullptr) {
+      timing->Set(blink::FrameTiming::kSubmit, fml::TimePoint::Now());
+    }
     FireNextFrameCallbackIfPresent();
 
     if (surface_->GetContext())
@@ -200,11 +286,33 @@ bool Rasterizer::DrawToSurface(flow::LayerTree& layer_tree) {
   return false;
 }
 
+// Returns the age of the frame buffer after restoring the last frame into it if
+// necessary and supported by the surface.
+int Rasterizer::PrepareFrameBuffer(SurfaceFrame& frame) {
+  const auto& framebuffer_info = frame.framebuffer_info();
+  if (framebuffer_info.buffer_age > 0) {
+    return framebuffer_info.buffer_age;
+  }
+
+  auto surface = frame.SkiaSurface();
+  if (!framebuffer_info.supports_copy_back || !last_frame_image_ ||
+      !surface || last_frame_image_->width() != surface->width() ||
+      last_frame_image_->height() != surface->height()) {
+    return 0;
+  }
+
+  TRACE_EVENT0("flutter", "Rasterizer::CopyBackLastFrame");
+  SkPaint paint;
+  paint.setBlendMode(SkBlendMode::kSrc);
+  surface->getCanvas()->drawImage(last_frame_image_, 0, 0, &paint);
+  return 1;
+}
+
 static sk_sp<SkData> SerializeTypeface(SkTypeface* typeface, void* ctx) {
   return typeface->serialize(SkTypeface::SerializeBehavior::kDoIncludeData);
 }
 
-static sk_sp<SkData> ScreenshotLayerTreeAsPicture(
+static sk_sp<SkPicture> RecordLayerTree(
     flow::LayerTree* tree,
     flow::CompositorContext& compositor_context) {
   FML_DCHECK(tree != nullptr);
@@ -219,14 +327,48 @@ static sk_sp<SkData> ScreenshotLayerTreeAsPicture(
   // https://github.com/flutter/flutter/issues/23435
   auto frame = compositor_context.AcquireFrame(
       nullptr, recorder.getRecordingCanvas(), nullptr,
-      root_surface_transformation, false);
+      root_surface_transformation, false, false);
 
   frame->Raster(*tree, true);
 
+  return recorder.finishRecordingAsPicture();
+}
+
+static sk_sp<SkData> ScreenshotLayerTreeAsPicture(
+    flow::LayerTree* tree,
+    flow::CompositorContext& compositor_context) {
   SkSerialProcs procs = {0};
   procs.fTypefaceProc = SerializeTypeface;
 
-  return recorder.finishRecordingAsPicture()->serialize(&procs);
+  return RecordLayerTree(tree, compositor_context)->serialize(&procs);
+}
+
+// The number of frames after a capture in which slow frames are not captured.
+// A capture delays the frames right after it, which would otherwise be
+// captured as well and push the frame that was slow in the first place out
+// of the ring.
+static constexpr int64_t kSlowFrameCaptureCooldownFrames = 30;
+
+void Rasterizer::CaptureSlowFrame(flow::LayerTree& layer_tree,
+                                  const blink::FrameTiming& timing) {
+  TRACE_EVENT0("flutter", "Rasterizer::CaptureSlowFrame");
+  FrameCapture capture;
+  capture.timing = timing;
+  // Dumped first so that the dump describes the preroll of the frame that
+  // was on screen rather than the one of the picture.
+  capture.layer_tree =
+      layer_tree.Dump(compositor_context_->raster_cache().cost_model());
+  if (const auto* profile = layer_tree.layer_profile()) {
+    capture.layer_profile = profile->ToFoldedStacks();
+    capture.layer_type_profile = profile->ToTypeSummary();
+  }
+  // Only recorded here. The ring serializes the picture in the background.
+  capture.picture = RecordLayerTree(&layer_tree, *compositor_context_);
+  delegate_.OnSlowFrameCaptured(std::move(capture));
+  slow_frame_capture_cooldown_end_ =
+      fml::TimePoint::Now() +
+      fml::TimeDelta::FromMicroseconds(kSlowFrameCaptureCooldownFrames *
+                                       flow::kOneFrameMS * 1000);
 }
 
 static sk_sp<SkSurface> CreateSnapshotSurface(GrContext* surface_context,
@@ -268,8 +410,9 @@ static sk_sp<SkData> ScreenshotLayerTreeAsImage(
   SkMatrix root_surface_transformation;
   root_surface_transformation.reset();
 
-  auto frame = compositor_context.AcquireFrame(
-      surface_context, canvas, nullptr, root_surface_transformation, false);
+  auto frame = compositor_context.AcquireFrame(surface_context, canvas, nullptr,
+                                               root_surface_transformation,
+                                               false, false);
   canvas->clear(SK_ColorTRANSPARENT);
   frame->Raster(*tree, true);
   canvas->flush();
@@ -7,13 +7,16 @@
 
 #include <memory>
 
+#include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
 #include "flutter/flow/compositor_context.h"
+#include "flutter/flow/damage_tracker.h"
 #include "flutter/flow/layers/layer_tree.h"
 #include "flutter/fml/closure.h"
 #include "flutter/fml/memory/weak_ptr.h"
 #include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/lib/ui/snapshot_delegate.h"
+#include "flutter/shell/common/frame_capture_ring.h"
 #include "flutter/shell/common/surface.h"
 #include "flutter/synchronization/pipeline.h"
 
@@ -21,9 +24,26 @@ namespace shell {
 
 class Rasterizer final : public blink::SnapshotDelegate {
  public:
-  Rasterizer(blink::TaskRunners task_runners);
+  class Delegate {
+   public:
+    // Called on the GPU task runner once a frame from the pipeline has been
+    // submitted to the surface.
+    virtual void OnFrameRasterized(const blink::FrameTiming& timing) = 0;
+
+    // Called on the GPU task runner for a frame the pipeline dropped in favor
+    // of a newer one. Only the build phases of |timing| are set.
+    virtual void OnFrameDropped(const blink::FrameTiming& timing) = 0;
+
+    // Called on the GPU task runner with the capture of a frame that took
+    // longer than the rasterizer tracing threshold of its layer tree. See
+    // |flow::LayerTree::rasterizer_tracing_threshold|.
+    virtual void OnSlowFrameCaptured(FrameCapture capture) = 0;
+  };
+
+  Rasterizer(Delegate& delegate, blink::TaskRunners task_runners);
 
-  Rasterizer(blink::TaskRunners task_runners,
+  Rasterizer(Delegate& delegate,
+             blink::TaskRunners task_runners,
              std::unique_ptr<flow::CompositorContext> compositor_context);
 
   ~Rasterizer();
@@ -74,11 +94,18 @@ class Rasterizer final : public blink::SnapshotDelegate {
   }
 
  private:
+  Delegate& delegate_;
   blink::TaskRunners task_runners_;
   std::unique_ptr<Surface> surface_;
   std::unique_ptr<flow::CompositorContext> compositor_context_;
   std::unique_ptr<flow::LayerTree> last_layer_tree_;
+  flow::DamageTracker damage_tracker_;
+  // A copy of the last frame for surfaces that support copy back.
+  sk_sp<SkImage> last_frame_image_;
   fml::closure next_frame_callback_;
+  // Slow frames with an earlier vsync are not captured. See
+  // |CaptureSlowFrame|.
+  fml::TimePoint slow_frame_capture_cooldown_end_;
   fml::WeakPtrFactory<Rasterizer> weak_factory_;
 
   // |blink::SnapshotDelegate|
@@ -87,7 +114,20 @@ class Rasterizer final : public blink::SnapshotDelegate {
 
   void DoDraw(std::unique_ptr<flow::LayerTree> layer_tree);
 
-  bool DrawToSurface(flow::LayerTree& layer_tree);
+  void DoDrop(std::unique_ptr<flow::LayerTree> layer_tree);
+
+  // Records the raster phases of the frame in |timing| if it is not null.
+  bool DrawToSurface(flow::LayerTree& layer_tree,
+                     blink::FrameTiming* timing = nullptr);
+
+  // Records the picture and the layer tree of a slow frame for the delegate.
+  // The frames right after a capture are not captured.
+  void CaptureSlowFrame(flow::LayerTree& layer_tree,
+                        const blink::FrameTiming& timing);
+
+  int PrepareFrameBuffer(SurfaceFrame& frame);
+
+  void ResetDamageTracking();
 
   void FireNextFrameCallbackIfPresent();
 
@@ -40,6 +40,10 @@ namespace shell {
 //     : isolate_configuration_(std::move(configuration)),
 //       asset_manager_(std::move(asset_manager)) {}
 
+RunConfiguration::RunConfiguration(
+    std::shared_ptr<blink::AssetManager> asset_manager)
+    : asset_manager_(std::move(asset_manager)) {}
+
 RunConfiguration::RunConfiguration(RunConfiguration&&) = default;
 
 RunConfiguration::~RunConfiguration() = default;
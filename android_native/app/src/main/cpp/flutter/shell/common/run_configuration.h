@@ -31,6 +31,9 @@ class RunConfiguration {
   // RunConfiguration(std::unique_ptr<IsolateConfiguration> configuration,
   //                  std::shared_ptr<blink::AssetManager> asset_manager);
 
+  explicit RunConfiguration(
+      std::shared_ptr<blink::AssetManager> asset_manager);
+
   RunConfiguration(RunConfiguration&&);
 
   ~RunConfiguration();
@@ -0,0 +1,81 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/shared_thread_host.h"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/serial_task_runner.h"
+
+namespace shell {
+
+std::shared_ptr<SharedThreadHost> SharedThreadHost::GetShared(
+    const blink::Settings& settings) {
+  static std::mutex mutex;
+  static std::weak_ptr<SharedThreadHost> shared_host;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto host = shared_host.lock();
+  if (!host) {
+    // A UI and a GPU thread per pair of cores.
+    const size_t thread_count =
+        std::max<size_t>(1, std::thread::hardware_concurrency() / 2);
+    host = std::make_shared<SharedThreadHost>("io.flutter.shared",
+                                              thread_count, settings);
+    shared_host = host;
+  } else if (!host->HasThreadConfigsOf(settings)) {
+    FML_LOG(WARNING) << "The threads shared by the engines of the process "
+                        "were created with other thread configs. Those of "
+                        "the new engine are ignored.";
+  }
+  return host;
+}
+
+SharedThreadHost::SharedThreadHost(std::string name_prefix,
+                                   size_t thread_count,
+                                   const blink::Settings& settings)
+    : platform_thread_config_(settings.platform_thread_config),
+      ui_thread_config_(settings.ui_thread_config),
+      gpu_thread_config_(settings.gpu_thread_config),
+      io_thread_config_(settings.io_thread_config),
+      next_thread_index_(0) {
+  FML_DCHECK(thread_count > 0);
+  platform_thread_ = std::make_unique<fml::Thread>(
+      name_prefix + ".platform", settings.platform_thread_config);
+  io_thread_ = std::make_unique<fml::Thread>(name_prefix + ".io",
+                                             settings.io_thread_config);
+  for (size_t i = 0; i < thread_count; i++) {
+    ui_threads_.emplace_back(std::make_unique<fml::Thread>(
+        name_prefix + ".ui." + std::to_string(i), settings.ui_thread_config));
+    gpu_threads_.emplace_back(std::make_unique<fml::Thread>(
+        name_prefix + ".gpu." + std::to_string(i),
+        settings.gpu_thread_config));
+  }
+}
+
+SharedThreadHost::~SharedThreadHost() = default;
+
+bool SharedThreadHost::HasThreadConfigsOf(
+    const blink::Settings& settings) const {
+  return settings.platform_thread_config == platform_thread_config_ &&
+         settings.ui_thread_config == ui_thread_config_ &&
+         settings.gpu_thread_config == gpu_thread_config_ &&
+         settings.io_thread_config == io_thread_config_;
+}
+
+blink::TaskRunners SharedThreadHost::CreateTaskRunners(std::string label) {
+  const size_t index = next_thread_index_++ % ui_threads_.size();
+  return blink::TaskRunners(
+      std::move(label),
+      fml::SerialTaskRunner::Create(platform_thread_->GetTaskRunner()),
+      fml::SerialTaskRunner::Create(gpu_threads_[index]->GetTaskRunner()),
+      fml::SerialTaskRunner::Create(ui_threads_[index]->GetTaskRunner()),
+      fml::SerialTaskRunner::Create(io_thread_->GetTaskRunner()));
+}
+
+}  // namespace shell
@@ -0,0 +1,67 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_SHARED_THREAD_HOST_H_
+#define FLUTTER_SHELL_COMMON_SHARED_THREAD_HOST_H_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/common/settings.h"
+#include "flutter/common/task_runners.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/thread.h"
+
+namespace shell {
+
+// Threads that the engines of a process share instead of each engine creating
+// its own four. Every engine gets its own |fml::SerialTaskRunner|s on the
+// shared threads. So the tasks of an engine still run in order on a single
+// thread per role while engines on the same thread take turns task by task.
+// The thread count follows the number of cores instead of the number of
+// engines.
+class SharedThreadHost {
+ public:
+  // Returns the host that the engines alive in the process share. It is
+  // created with the thread configs of |settings| on first use and its
+  // threads are joined once the last engine releases it. Engines started
+  // while it is alive run on its threads as they are. Their own thread
+  // configs are ignored, and a warning is logged if they differ.
+  static std::shared_ptr<SharedThreadHost> GetShared(
+      const blink::Settings& settings);
+
+  // Creates |thread_count| UI and GPU threads each. The platform and IO
+  // threads are shared by all engines.
+  SharedThreadHost(std::string name_prefix,
+                   size_t thread_count,
+                   const blink::Settings& settings);
+
+  ~SharedThreadHost();
+
+  // Task runners for a new engine. Engines are spread round robin over the UI
+  // and GPU threads.
+  blink::TaskRunners CreateTaskRunners(std::string label);
+
+ private:
+  const fml::ThreadConfig platform_thread_config_;
+  const fml::ThreadConfig ui_thread_config_;
+  const fml::ThreadConfig gpu_thread_config_;
+  const fml::ThreadConfig io_thread_config_;
+  std::unique_ptr<fml::Thread> platform_thread_;
+  std::unique_ptr<fml::Thread> io_thread_;
+  std::vector<std::unique_ptr<fml::Thread>> ui_threads_;
+  std::vector<std::unique_ptr<fml::Thread>> gpu_threads_;
+  std::atomic_size_t next_thread_index_;
+
+  // Whether the threads were created with the thread configs of |settings|.
+  bool HasThreadConfigsOf(const blink::Settings& settings) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(SharedThreadHost);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_COMMON_SHARED_THREAD_HOST_H_
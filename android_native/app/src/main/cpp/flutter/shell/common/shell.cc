@@ -7,11 +7,14 @@
 #include "flutter/shell/common/shell.h"
 
 #include <memory>
+#include <mutex>
 #include <sstream>
+#include <string>
 #include <vector>
 
 #include "flutter/assets/directory_asset_bundle.h"
 #include "flutter/fml/file.h"
+#include "flutter/fml/future.h"
 #include "flutter/fml/icu_util.h"
 #include "flutter/fml/log_settings.h"
 #include "flutter/fml/logging.h"
@@ -19,6 +22,7 @@
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/paths.h"
 #include "flutter/fml/trace_event.h"
+#include "flutter/fml/trace_recorder.h"
 #include "flutter/fml/unique_fd.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/runtime/start_up.h"
@@ -33,6 +37,22 @@
 
 namespace shell {
 
+// The shells of a process share their worker threads. The workers are joined
+// once the last shell is collected.
+static std::shared_ptr<fml::ConcurrentMessageLoop>
+GetSharedConcurrentMessageLoop() {
+  static std::mutex mutex;
+  static std::weak_ptr<fml::ConcurrentMessageLoop> shared_loop;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto loop = shared_loop.lock();
+  if (!loop) {
+    loop = fml::ConcurrentMessageLoop::Create();
+    shared_loop = loop;
+  }
+  return loop;
+}
+
 std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
     blink::TaskRunners task_runners,
     blink::Settings settings,
@@ -57,91 +77,97 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
     return nullptr;
   }
 
-  // Create the IO manager on the IO thread. The IO manager must be initialized
-  // first because it has state that the other subsystems depend on. It must
-  // first be booted and the necessary references obtained to initialize the
-  // other subsystems.
-  fml::AutoResetWaitableEvent io_latch;
-  std::unique_ptr<IOManager> io_manager;
-  fml::WeakPtr<GrContext> resource_context;
-  fml::RefPtr<flow::SkiaUnrefQueue> unref_queue;
+  // Create the IO manager on the IO thread and the rasterizer on the GPU
+  // thread at the same time. The engine depends on both. So it is created on
+  // the UI thread once they are ready.
+  struct IOSetup {
+    std::unique_ptr<IOManager> io_manager;
+    fml::WeakPtr<GrContext> resource_context;
+    fml::RefPtr<flow::SkiaUnrefQueue> unref_queue;
+  };
   auto io_task_runner = shell->GetTaskRunners().GetIOTaskRunner();
-  fml::TaskRunner::RunNowOrPostTask(
-      io_task_runner,
-      [&io_latch,          //
-       &io_manager,        //
-       &resource_context,  //
-       &unref_queue,       //
-       &platform_view,     //
-       io_task_runner      //
-  ]() {
-        io_manager = std::make_unique<IOManager>(
+  auto io_setup = fml::RunNowOrPostTaskForResult(
+      io_task_runner, [&platform_view, io_task_runner]() {
+        IOSetup setup;
+        setup.io_manager = std::make_unique<IOManager>(
             platform_view->CreateResourceContext(), io_task_runner);
-        resource_context = io_manager->GetResourceContext();
-        unref_queue = io_manager->GetSkiaUnrefQueue();
-        io_latch.Signal();
+        setup.resource_context = setup.io_manager->GetResourceContext();
+        setup.unref_queue = setup.io_manager->GetSkiaUnrefQueue();
+        return setup;
       });
-  io_latch.Wait();
 
-  // Create the rasterizer on the GPU thread.
-  fml::AutoResetWaitableEvent gpu_latch;
-  std::unique_ptr<Rasterizer> rasterizer;
-  fml::WeakPtr<blink::SnapshotDelegate> snapshot_delegate;
-  fml::TaskRunner::RunNowOrPostTask(
-      task_runners.GetGPUTaskRunner(), [&gpu_latch,            //
-                                        &rasterizer,           //
-                                        on_create_rasterizer,  //
-                                        shell = shell.get(),   //
-                                        &snapshot_delegate     //
-  ]() {
+  struct GPUSetup {
+    std::unique_ptr<Rasterizer> rasterizer;
+    fml::WeakPtr<blink::SnapshotDelegate> snapshot_delegate;
+  };
+  auto gpu_setup = fml::RunNowOrPostTaskForResult(
+      task_runners.GetGPUTaskRunner(),
+      [on_create_rasterizer, shell = shell.get()]() {
+        GPUSetup setup;
+        shell->weak_factory_gpu_ =
+            std::make_unique<fml::WeakPtrFactory<Shell>>(shell);
+        shell->frame_timings_batcher_ = std::make_unique<FrameTimingsBatcher>(
+            shell->GetTaskRunners().GetGPUTaskRunner(),
+            shell->GetSettings().frame_timings_report_count,
+            fml::TimeDelta::FromMilliseconds(
+                shell->GetSettings().frame_timings_report_interval_ms),
+            [shell](std::vector<blink::FrameTiming> timings) {
+              shell->ReportTimings(std::move(timings));
+            });
         if (auto new_rasterizer = on_create_rasterizer(*shell)) {
-          rasterizer = std::move(new_rasterizer);
-          snapshot_delegate = rasterizer->GetSnapshotDelegate();
+          new_rasterizer->compositor_context()->set_layer_profiling_enabled(
+              shell->GetSettings().enable_layer_profiling);
+          if (shell->GetSettings().enable_async_raster_cache) {
+            new_rasterizer->compositor_context()
+                ->raster_cache()
+                .SetRasterizationTaskRunner(
+                    shell->GetConcurrentWorkerTaskRunner());
+          }
+          setup.rasterizer = std::move(new_rasterizer);
+          setup.snapshot_delegate = setup.rasterizer->GetSnapshotDelegate();
         }
-        gpu_latch.Signal();
+        return setup;
       });
 
-  gpu_latch.Wait();
-
-  // Create the engine on the UI thread.
-  fml::AutoResetWaitableEvent ui_latch;
-  std::unique_ptr<Engine> engine;
-  fml::TaskRunner::RunNowOrPostTask(
+  auto engine_setup = fml::WhenAll(io_setup, gpu_setup).Then(
       shell->GetTaskRunners().GetUITaskRunner(),
-      fml::MakeCopyable([&ui_latch,                                         //
-                         &engine,                                           //
-                         shell = shell.get(),                               //
-                         vsync_waiter = std::move(vsync_waiter),            //
-                         snapshot_delegate = std::move(snapshot_delegate),  //
-                         resource_context = std::move(resource_context),    //
-                         unref_queue = std::move(unref_queue)               //
+      [shell = shell.get(),                     //
+       vsync_waiter = std::move(vsync_waiter),  //
+       io_setup,                                //
+       gpu_setup                                //
   ]() mutable {
         const auto& task_runners = shell->GetTaskRunners();
 
         // The animator is owned by the UI thread but it gets its vsync pulses
         // from the platform.
-        auto animator = std::make_unique<Animator>(*shell, task_runners,
-                                                   std::move(vsync_waiter));
-
-        engine = std::make_unique<Engine>(*shell,                        //
-                                          task_runners,                  //
-                                          shell->GetSettings(),          //
-                                          std::move(animator),           //
-                                          std::move(snapshot_delegate),  //
-                                          std::move(resource_context),   //
-                                          std::move(unref_queue)         //
+        auto animator = std::make_unique<Animator>(
+            *shell, task_runners, std::move(vsync_waiter),
+            shell->GetSettings());
+
+        return std::make_unique<Engine>(
+            *shell,                                        //
+            task_runners,                                  //
+            shell->GetSettings(),                          //
+            std::move(animator),                           //
+            std::move(gpu_setup.Get().snapshot_delegate),  //
+            std::move(io_setup.Get().resource_context),    //
+            std::move(io_setup.Get().unref_queue)          //
         );
-        ui_latch.Signal();
-      }));
+      });
 
-  ui_latch.Wait();
-  // We are already on the platform thread. So there is no platform latch to
-  // wait on.
+  // We are already on the platform thread. So there is nothing to wait for
+  // there. The IO and GPU tasks refer to locals of this frame. So they are
+  // waited for even if the other one was dropped along with its thread.
+  io_setup.Wait();
+  gpu_setup.Wait();
+  if (!engine_setup.Wait()) {
+    return nullptr;
+  }
 
-  if (!shell->Setup(std::move(platform_view),  //
-                    std::move(engine),         //
-                    std::move(rasterizer),     //
-                    std::move(io_manager))     //
+  if (!shell->Setup(std::move(platform_view),               //
+                    std::move(engine_setup.Get()),          //
+                    std::move(gpu_setup.Get().rasterizer),  //
+                    std::move(io_setup.Get().io_manager))   //
   ) {
     return nullptr;
   }
@@ -178,6 +204,21 @@ static void PerformInitializationTasks(const blink::Settings& settings) {
 //    tonic::SetLogHandler(
 //        [](const char* message) { FML_LOG(ERROR) << message; });
 
+    {
+      // Startup tracing must not lose the events recorded early on.
+      const bool endless =
+          settings.endless_trace_buffer || settings.trace_startup;
+      auto& recorder = fml::tracing::TraceRecorder::GetInstance();
+      recorder.SetEndlessBuffer(endless);
+      // The captures of slow frames include the events of the frame.
+      const bool capture_slow_frames =
+          settings.slow_frame_capture_threshold > 0 &&
+          !settings.slow_frame_capture_path.empty();
+      if (endless || capture_slow_frames) {
+        recorder.SetEnabled(true);
+      }
+    }
+
     if (settings.trace_skia) {
       InitSkiaEventTracer(settings.trace_skia);
     }
@@ -224,34 +265,36 @@ std::unique_ptr<Shell> Shell::Create(
     return nullptr;
   }
 
-  fml::AutoResetWaitableEvent latch;
-  std::unique_ptr<Shell> shell;
-  fml::TaskRunner::RunNowOrPostTask(
+  auto shell = fml::RunNowOrPostTaskForResult(
       task_runners.GetPlatformTaskRunner(),
-      [&latch,                                          //
-       &shell,                                          //
-       task_runners = std::move(task_runners),          //
-       settings,                                        //
-       on_create_platform_view,                         //
-       on_create_rasterizer                             //
-  ]() {
-        shell = CreateShellOnPlatformThread(std::move(task_runners),      //
-                                            settings,                     //
-                                            on_create_platform_view,      //
-                                            on_create_rasterizer          //
+      [task_runners = std::move(task_runners),  //
+       settings,                                //
+       on_create_platform_view,                 //
+       on_create_rasterizer                     //
+  ]() mutable {
+        return CreateShellOnPlatformThread(std::move(task_runners),  //
+                                           settings,                 //
+                                           on_create_platform_view,  //
+                                           on_create_rasterizer      //
         );
-        latch.Signal();
       });
-  latch.Wait();
-  return shell;
+  return shell.Wait() ? std::move(shell.Get()) : nullptr;
 }
 
 Shell::Shell(blink::TaskRunners task_runners, blink::Settings settings)
     : task_runners_(std::move(task_runners)),
-      settings_(std::move(settings)) {
+      settings_(std::move(settings)),
+      concurrent_message_loop_(GetSharedConcurrentMessageLoop()) {
   FML_DCHECK(task_runners_.IsValid());
   FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
 
+  if (settings_.slow_frame_capture_threshold > 0 &&
+      !settings_.slow_frame_capture_path.empty()) {
+    frame_capture_ring_ = std::make_unique<FrameCaptureRing>(
+        task_runners_.GetIOTaskRunner(), settings_.slow_frame_capture_path,
+        settings_.slow_frame_capture_count);
+  }
+
   // Install service protocol handlers.
 
   // service_protocol_handlers_[blink::ServiceProtocol::kScreenshotExtensionName
@@ -283,7 +326,7 @@ Shell::Shell(blink::TaskRunners task_runners, blink::Settings settings)
 
 Shell::~Shell() {
   PersistentCache::GetCacheForProcess()->RemoveWorkerTaskRunner(
-      task_runners_.GetIOTaskRunner());
+      GetConcurrentWorkerTaskRunner());
 
   // if (auto vm = blink::DartVM::ForProcessIfInitialized()) {
   //   vm->GetServiceProtocol().RemoveHandler(this);
@@ -301,11 +344,13 @@ Shell::~Shell() {
 
   fml::TaskRunner::RunNowOrPostTask(
       task_runners_.GetGPUTaskRunner(),
-      fml::MakeCopyable(
-          [rasterizer = std::move(rasterizer_), &gpu_latch]() mutable {
-            rasterizer.reset();
-            gpu_latch.Signal();
-          }));
+      fml::MakeCopyable([this, rasterizer = std::move(rasterizer_),
+                         &gpu_latch]() mutable {
+        rasterizer.reset();
+        frame_timings_batcher_.reset();
+        weak_factory_gpu_.reset();
+        gpu_latch.Signal();
+      }));
   gpu_latch.Wait();
 
   fml::TaskRunner::RunNowOrPostTask(
@@ -353,6 +398,7 @@ bool Shell::Setup(std::unique_ptr<PlatformView> platform_view,
 
   platform_view_ = std::move(platform_view);
   engine_ = std::move(engine);
+  weak_engine_ = engine_->GetWeakPtr();
   rasterizer_ = std::move(rasterizer);
   io_manager_ = std::move(io_manager);
 
@@ -363,7 +409,7 @@ bool Shell::Setup(std::unique_ptr<PlatformView> platform_view,
   // }
 
   PersistentCache::GetCacheForProcess()->AddWorkerTaskRunner(
-      task_runners_.GetIOTaskRunner());
+      GetConcurrentWorkerTaskRunner());
 
   return true;
 }
@@ -376,6 +422,10 @@ const blink::TaskRunners& Shell::GetTaskRunners() const {
   return task_runners_;
 }
 
+fml::RefPtr<fml::TaskRunner> Shell::GetConcurrentWorkerTaskRunner() const {
+  return concurrent_message_loop_->GetTaskRunner();
+}
+
 fml::WeakPtr<Rasterizer> Shell::GetRasterizer() {
   FML_DCHECK(is_setup_);
   return rasterizer_->GetWeakPtr();
@@ -405,34 +455,23 @@ void Shell::OnPlatformViewCreated(std::unique_ptr<Surface> surface) {
   // setup/suspension of all activities that may be interacting with the GPU in
   // a synchronous fashion.
 
-  fml::AutoResetWaitableEvent latch;
-  auto gpu_task = fml::MakeCopyable([rasterizer = rasterizer_->GetWeakPtr(),  //
-                                     surface = std::move(surface),            //
-                                     &latch]() mutable {
-    if (rasterizer) {
-      rasterizer->Setup(std::move(surface));
-    }
-    // Step 2: All done. Signal the latch that the platform thread is waiting
-    // on.
-    latch.Signal();
-  });
-
-  auto ui_task = [engine = engine_->GetWeakPtr(),                      //
-                  gpu_task_runner = task_runners_.GetGPUTaskRunner(),  //
-                  gpu_task                                             //
-  ] {
-    if (engine) {
-      engine->OnOutputSurfaceCreated();
-    }
-    // Step 1: Next, tell the GPU thread that it should create a surface for its
-    // rasterizer.
-    fml::TaskRunner::RunNowOrPostTask(gpu_task_runner, gpu_task);
-  };
-
-  // Step 0: Post a task onto the UI thread to tell the engine that it has an
-  // output surface.
-  fml::TaskRunner::RunNowOrPostTask(task_runners_.GetUITaskRunner(), ui_task);
-  latch.Wait();
+  // Step 0: Tell the engine on the UI thread that it has an output surface.
+  // Step 1: Next, tell the GPU thread that it should create a surface for its
+  // rasterizer.
+  fml::RunNowOrPostTaskForResult(task_runners_.GetUITaskRunner(),
+                                 [engine = engine_->GetWeakPtr()]() {
+                                   if (engine) {
+                                     engine->OnOutputSurfaceCreated();
+                                   }
+                                 })
+      .Then(task_runners_.GetGPUTaskRunner(),
+            [rasterizer = rasterizer_->GetWeakPtr(),
+             surface = std::move(surface)]() mutable {
+              if (rasterizer) {
+                rasterizer->Setup(std::move(surface));
+              }
+            })
+      .Wait();
 }
 
 // |shell::PlatformView::Delegate|
@@ -445,42 +484,30 @@ void Shell::OnPlatformViewDestroyed() {
   // setup/suspension of all activities that may be interacting with the GPU in
   // a synchronous fashion.
 
-  fml::AutoResetWaitableEvent latch;
-
-  auto io_task = [io_manager = io_manager_.get(), &latch]() {
-    // Execute any pending Skia object deletions while GPU access is still
-    // allowed.
-    io_manager->GetSkiaUnrefQueue()->Drain();
-    // Step 3: All done. Signal the latch that the platform thread is waiting
-    // on.
-    latch.Signal();
-  };
-
-  auto gpu_task = [rasterizer = rasterizer_->GetWeakPtr(),
-                   io_task_runner = task_runners_.GetIOTaskRunner(),
-                   io_task]() {
-    if (rasterizer) {
-      rasterizer->Teardown();
-    }
-    // Step 2: Next, tell the IO thread to complete its remaining work.
-    fml::TaskRunner::RunNowOrPostTask(io_task_runner, io_task);
-  };
-
-  auto ui_task = [engine = engine_->GetWeakPtr(),
-                  gpu_task_runner = task_runners_.GetGPUTaskRunner(),
-                  gpu_task]() {
-    if (engine) {
-      engine->OnOutputSurfaceDestroyed();
-    }
-    // Step 1: Next, tell the GPU thread that its rasterizer should suspend
-    // access to the underlying surface.
-    fml::TaskRunner::RunNowOrPostTask(gpu_task_runner, gpu_task);
-  };
-
-  // Step 0: Post a task onto the UI thread to tell the engine that its output
-  // surface is about to go away.
-  fml::TaskRunner::RunNowOrPostTask(task_runners_.GetUITaskRunner(), ui_task);
-  latch.Wait();
+  // Step 0: Tell the engine on the UI thread that its output surface is about
+  // to go away.
+  // Step 1: Next, tell the GPU thread that its rasterizer should suspend
+  // access to the underlying surface.
+  // Step 2: Next, tell the IO thread to complete its remaining work.
+  fml::RunNowOrPostTaskForResult(task_runners_.GetUITaskRunner(),
+                                 [engine = engine_->GetWeakPtr()]() {
+                                   if (engine) {
+                                     engine->OnOutputSurfaceDestroyed();
+                                   }
+                                 })
+      .Then(task_runners_.GetGPUTaskRunner(),
+            [rasterizer = rasterizer_->GetWeakPtr()]() {
+              if (rasterizer) {
+                rasterizer->Teardown();
+              }
+            })
+      .Then(task_runners_.GetIOTaskRunner(),
+            [io_manager = io_manager_.get()]() {
+              // Execute any pending Skia object deletions while GPU access is
+              // still allowed.
+              io_manager->GetSkiaUnrefQueue()->Drain();
+            })
+      .Wait();
 }
 
 // |shell::PlatformView::Delegate|
@@ -521,7 +548,8 @@ void Shell::OnPlatformViewDispatchPointerDataPacket(
         if (engine) {
           engine->DispatchPointerDataPacket(*packet);
         }
-      }));
+      }),
+      fml::TaskPriority::kInput);
 }
 
 // |shell::PlatformView::Delegate|
@@ -671,7 +699,8 @@ void Shell::OnAnimatorDraw(
         if (rasterizer) {
           rasterizer->Draw(pipeline);
         }
-      });
+      },
+      fml::TaskPriority::kFrame);
 }
 
 // |shell::Animator::Delegate|
@@ -721,18 +750,74 @@ void Shell::OnPreEngineRestart() {
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
 
-  fml::AutoResetWaitableEvent latch;
-  fml::TaskRunner::RunNowOrPostTask(
-      task_runners_.GetPlatformTaskRunner(),
-      [view = platform_view_->GetWeakPtr(), &latch]() {
-        if (view) {
-          view->OnPreEngineRestart();
-        }
-        latch.Signal();
-      });
   // This is blocking as any embedded platform views has to be flushed before
   // we re-run the Dart code.
-  latch.Wait();
+  fml::RunNowOrPostTaskForResult(task_runners_.GetPlatformTaskRunner(),
+                                 [view = platform_view_->GetWeakPtr()]() {
+                                   if (view) {
+                                     view->OnPreEngineRestart();
+                                   }
+                                 })
+      .Wait();
+}
+
+// |shell::Rasterizer::Delegate|
+void Shell::OnFrameRasterized(const blink::FrameTiming& timing) {
+  FML_DCHECK(is_setup_);
+  FML_DCHECK(task_runners_.GetGPUTaskRunner()->RunsTasksOnCurrentThread());
+  frame_timings_batcher_->Add(timing);
+}
+
+// |shell::Rasterizer::Delegate|
+void Shell::OnFrameDropped(const blink::FrameTiming& timing) {
+  FML_DCHECK(is_setup_);
+  FML_DCHECK(task_runners_.GetGPUTaskRunner()->RunsTasksOnCurrentThread());
+  frame_timings_batcher_->Add(timing);
+}
+
+// |shell::Rasterizer::Delegate|
+void Shell::OnSlowFrameCaptured(FrameCapture capture) {
+  FML_DCHECK(task_runners_.GetGPUTaskRunner()->RunsTasksOnCurrentThread());
+  if (frame_capture_ring_) {
+    frame_capture_ring_->Add(std::move(capture));
+  }
+}
+
+void Shell::ReportTimings(std::vector<blink::FrameTiming> timings) {
+  FML_DCHECK(task_runners_.GetGPUTaskRunner()->RunsTasksOnCurrentThread());
+
+  // The UI library gets the phases of each frame in order as microseconds
+  // since the epoch.
+  std::vector<int64_t> flattened;
+  flattened.reserve(timings.size() * blink::FrameTiming::kCount);
+  for (const auto& timing : timings) {
+    for (int phase = 0; phase < blink::FrameTiming::kCount; phase++) {
+      flattened.push_back(
+          timing.Get(static_cast<blink::FrameTiming::Phase>(phase))
+              .ToEpochDelta()
+              .ToMicroseconds());
+    }
+  }
+
+  task_runners_.GetUITaskRunner()->PostTask(
+      [engine = weak_engine_, flattened = std::move(flattened)]() {
+        if (engine) {
+          engine->ReportTimings(std::move(flattened));
+        }
+      });
+
+  if (settings_.frame_timings_callback) {
+    task_runners_.GetPlatformTaskRunner()->PostTask(
+        [view = platform_view_->GetWeakPtr(),
+         callback = settings_.frame_timings_callback,
+         timings = std::move(timings)]() {
+          // The platform view goes last. So no callbacks are made once the
+          // shell is gone.
+          if (view) {
+            callback(timings);
+          }
+        });
+  }
 }
 
 // |shell::Engine::Delegate|
@@ -749,23 +834,33 @@ Rasterizer::Screenshot Shell::Screenshot(
     Rasterizer::ScreenshotType screenshot_type,
     bool base64_encode) {
   TRACE_EVENT0("flutter", "Shell::Screenshot");
-  fml::AutoResetWaitableEvent latch;
-  Rasterizer::Screenshot screenshot;
-  fml::TaskRunner::RunNowOrPostTask(
-      task_runners_.GetGPUTaskRunner(), [&latch,                        //
-                                         rasterizer = GetRasterizer(),  //
-                                         &screenshot,                   //
-                                         screenshot_type,               //
-                                         base64_encode                  //
-  ]() {
-        if (rasterizer) {
-          screenshot = rasterizer->ScreenshotLastLayerTree(screenshot_type,
-                                                           base64_encode);
+  auto screenshot = ScreenshotAsync(screenshot_type, base64_encode);
+  return screenshot.Wait() ? screenshot.Get() : Rasterizer::Screenshot();
+}
+
+fml::Future<Rasterizer::Screenshot> Shell::ScreenshotAsync(
+    Rasterizer::ScreenshotType screenshot_type,
+    bool base64_encode) {
+  return fml::RunNowOrPostTaskForResult(
+      task_runners_.GetGPUTaskRunner(),
+      [rasterizer = GetRasterizer(), screenshot_type, base64_encode]() {
+        TRACE_EVENT0("flutter", "Shell::ScreenshotAsync");
+        if (!rasterizer) {
+          return Rasterizer::Screenshot();
+        }
+        return rasterizer->ScreenshotLastLayerTree(screenshot_type,
+                                                   base64_encode);
+      });
+}
+
+fml::Future<flow::FrameStatistics> Shell::GetFrameStatistics() {
+  return fml::RunNowOrPostTaskForResult(
+      task_runners_.GetGPUTaskRunner(), [rasterizer = GetRasterizer()]() {
+        if (!rasterizer) {
+          return flow::FrameStatistics();
         }
-        latch.Signal();
+        return rasterizer->compositor_context()->GetFrameStatistics();
       });
-  latch.Wait();
-  return screenshot;
 }
 
 }  // namespace shell
@@ -7,11 +7,14 @@
 
 #include <functional>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
 #include "flutter/flow/texture.h"
 #include "flutter/fml/closure.h"
+#include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/future.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_ptr.h"
 #include "flutter/fml/memory/thread_checker.h"
@@ -26,6 +29,8 @@
 //#include "flutter/runtime/service_protocol.h"
 #include "flutter/shell/common/animator.h"
 #include "flutter/shell/common/engine.h"
+#include "flutter/shell/common/frame_capture_ring.h"
+#include "flutter/shell/common/frame_timings_batcher.h"
 #include "flutter/shell/common/io_manager.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/rasterizer.h"
@@ -35,7 +40,8 @@ namespace shell {
 
 class Shell final : public PlatformView::Delegate,
                     public Animator::Delegate,
-                    public Engine::Delegate {
+                    public Engine::Delegate,
+                    public Rasterizer::Delegate {
  public:
   template <class T>
   using CreateCallback = std::function<std::unique_ptr<T>(Shell&)>;
@@ -62,6 +68,11 @@ class Shell final : public PlatformView::Delegate,
 
   const blink::TaskRunners& GetTaskRunners() const;
 
+  // Runs tasks on worker threads, one per core, that all shells of the process
+  // share. For work that does not need to run on a particular thread or in
+  // order, like writing to caches.
+  fml::RefPtr<fml::TaskRunner> GetConcurrentWorkerTaskRunner() const;
+
   fml::WeakPtr<Rasterizer> GetRasterizer();
 
   fml::WeakPtr<Engine> GetEngine();
@@ -75,6 +86,16 @@ class Shell final : public PlatformView::Delegate,
   Rasterizer::Screenshot Screenshot(Rasterizer::ScreenshotType type,
                                     bool base64_encode);
 
+  // Like |Screenshot()| but does not block the calling thread while the GPU
+  // thread takes the screenshot.
+  fml::Future<Rasterizer::Screenshot> ScreenshotAsync(
+      Rasterizer::ScreenshotType type,
+      bool base64_encode);
+
+  // The frame, raster and UI times of every frame rasterized so far. See
+  // |flow::CompositorContext::GetFrameStatistics|.
+  fml::Future<flow::FrameStatistics> GetFrameStatistics();
+
  private:
 //   using ServiceProtocolHandler = std::function<bool(
 //       const blink::ServiceProtocol::Handler::ServiceProtocolMap&,
@@ -82,11 +103,14 @@ class Shell final : public PlatformView::Delegate,
 
   const blink::TaskRunners task_runners_;
   const blink::Settings settings_;
+  std::shared_ptr<fml::ConcurrentMessageLoop> concurrent_message_loop_;
   //fml::RefPtr<blink::DartVM> vm_;
   std::unique_ptr<PlatformView> platform_view_;  // on platform task runner
   std::unique_ptr<Engine> engine_;               // on UI task runner
   std::unique_ptr<Rasterizer> rasterizer_;       // on GPU task runner
   std::unique_ptr<IOManager> io_manager_;        // on IO task runner
+  // For the threads that may outlive |engine_|.
+  fml::WeakPtr<Engine> weak_engine_;
 
 //   std::unordered_map<std::string,  // method
 //                      std::pair<fml::RefPtr<fml::TaskRunner>,
@@ -96,6 +120,14 @@ class Shell final : public PlatformView::Delegate,
 //       service_protocol_handlers_;
   bool is_setup_ = false;
 
+  // Batches the timings of the rasterized and dropped frames for
+  // |ReportTimings|. Created and destroyed on the GPU task runner.
+  std::unique_ptr<FrameTimingsBatcher> frame_timings_batcher_;
+  // Created and destroyed on the GPU task runner.
+  std::unique_ptr<fml::WeakPtrFactory<Shell>> weak_factory_gpu_;
+  // Only set if slow frames are captured.
+  std::unique_ptr<FrameCaptureRing> frame_capture_ring_;
+
   Shell(blink::TaskRunners task_runners, blink::Settings settings);
 
   static std::unique_ptr<Shell> CreateShellOnPlatformThread(
@@ -177,6 +209,18 @@ class Shell final : public PlatformView::Delegate,
   // |shell::Engine::Delegate|
   void OnPreEngineRestart() override;
 
+  // |shell::Rasterizer::Delegate|
+  void OnFrameRasterized(const blink::FrameTiming& timing) override;
+
+  // |shell::Rasterizer::Delegate|
+  void OnFrameDropped(const blink::FrameTiming& timing) override;
+
+  // |shell::Rasterizer::Delegate|
+  void OnSlowFrameCaptured(FrameCapture capture) override;
+
+  // Hands a batch of frame timings to the engine and the embedder.
+  void ReportTimings(std::vector<blink::FrameTiming> timings);
+
   // |shell::Engine::Delegate|
 //   void UpdateIsolateDescription(const std::string isolate_name,
 //                                 int64_t isolate_port) override;
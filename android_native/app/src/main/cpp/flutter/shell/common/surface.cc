@@ -12,9 +12,19 @@ namespace shell {
 
 SurfaceFrame::SurfaceFrame(sk_sp<SkSurface> surface,
                            SubmitCallback submit_callback)
-    : submitted_(false), surface_(surface), submit_callback_(submit_callback) {
+    : SurfaceFrame(std::move(surface), {}, std::move(submit_callback)) {}
+
+SurfaceFrame::SurfaceFrame(sk_sp<SkSurface> surface,
+                           FramebufferInfo framebuffer_info,
+                           SubmitCallback submit_callback)
+    : submitted_(false),
+      surface_(surface),
+      framebuffer_info_(framebuffer_info),
+      damage_(SkIRect::MakeEmpty()),
+      submit_callback_(submit_callback) {
   FML_DCHECK(submit_callback_);
   if (surface_) {
+    damage_ = SkIRect::MakeWH(surface_->width(), surface_->height());
     xform_canvas_ = SkCreateColorSpaceXformCanvas(surface_->getCanvas(),
                                                   SkColorSpace::MakeSRGB());
   }
@@ -21,8 +21,27 @@ class SurfaceFrame {
   using SubmitCallback =
       std::function<bool(const SurfaceFrame& surface_frame, SkCanvas* canvas)>;
 
+  // Describes the contents of the buffer backing a frame. The rasterizer uses
+  // this to repaint only the parts of the frame that changed.
+  struct FramebufferInfo {
+    // The number of frames since this buffer was last presented. For example,
+    // 1 if the buffer holds the previous frame (like single buffered software
+    // surfaces) and 2 for double buffered surfaces. 0 if the contents of the
+    // buffer are undefined.
+    int buffer_age = 0;
+
+    // Whether the rasterizer may restore the previous frame into a buffer with
+    // undefined contents by drawing a copy of it. This is cheaper than
+    // repainting the frame on software surfaces but usually not on GPU ones.
+    bool supports_copy_back = false;
+  };
+
   SurfaceFrame(sk_sp<SkSurface> surface, SubmitCallback submit_callback);
 
+  SurfaceFrame(sk_sp<SkSurface> surface,
+               FramebufferInfo framebuffer_info,
+               SubmitCallback submit_callback);
+
   ~SurfaceFrame();
 
   bool Submit();
@@ -31,9 +50,20 @@ class SurfaceFrame {
 
   sk_sp<SkSurface> SkiaSurface() const;
 
+  const FramebufferInfo& framebuffer_info() const { return framebuffer_info_; }
+
+  // The rect of the frame that changed since the previous frame. This is the
+  // whole frame unless the rasterizer could compute the damage. Submit
+  // callbacks may use this to present partial updates.
+  const SkIRect& damage() const { return damage_; }
+
+  void set_damage(const SkIRect& damage) { damage_ = damage; }
+
  private:
   bool submitted_;
   sk_sp<SkSurface> surface_;
+  FramebufferInfo framebuffer_info_;
+  SkIRect damage_;
   std::unique_ptr<SkCanvas> xform_canvas_;
   SubmitCallback submit_callback_;
 
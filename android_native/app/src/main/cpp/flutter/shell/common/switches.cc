@@ -121,6 +121,69 @@ static bool GetSwitchValue(const fml::CommandLine& command_line,
   return false;
 }
 
+// Parses the value of a thread config switch like
+// "policy=normal,nice=-4,cpus=0xf0".
+static bool ParseThreadConfig(const std::string& value,
+                              fml::ThreadConfig* config) {
+  fml::ThreadConfig parsed;
+  std::stringstream stream(value);
+  std::string entry;
+  while (std::getline(stream, entry, ',')) {
+    const auto separator = entry.find('=');
+    if (separator == std::string::npos) {
+      return false;
+    }
+    const std::string key = entry.substr(0, separator);
+    std::stringstream entry_value(entry.substr(separator + 1));
+    if (key == "policy") {
+      const std::string policy = entry_value.str();
+      if (policy == "normal") {
+        parsed.policy = fml::ThreadConfig::Policy::kNormal;
+      } else if (policy == "batch") {
+        parsed.policy = fml::ThreadConfig::Policy::kBatch;
+      } else if (policy == "idle") {
+        parsed.policy = fml::ThreadConfig::Policy::kIdle;
+      } else if (policy == "fifo") {
+        parsed.policy = fml::ThreadConfig::Policy::kFifo;
+      } else if (policy == "rr") {
+        parsed.policy = fml::ThreadConfig::Policy::kRoundRobin;
+      } else {
+        return false;
+      }
+    } else if (key == "nice") {
+      if (!(entry_value >> parsed.nice)) {
+        return false;
+      }
+    } else if (key == "priority") {
+      if (!(entry_value >> parsed.realtime_priority)) {
+        return false;
+      }
+    } else if (key == "cpus") {
+      if (!(entry_value >> std::hex >> parsed.cpu_affinity_mask)) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+  *config = parsed;
+  return true;
+}
+
+static void GetThreadConfig(const fml::CommandLine& command_line,
+                            Switch sw,
+                            fml::ThreadConfig* config) {
+  std::string value;
+  if (!command_line.GetOptionValue(FlagForSwitch(sw), &value)) {
+    return;
+  }
+  if (!ParseThreadConfig(value, config)) {
+    FML_LOG(ERROR) << "The thread config '" << value << "' of --"
+                   << FlagForSwitch(sw).ToString()
+                   << " was malformed. The thread keeps its defaults.";
+  }
+}
+
 blink::Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   blink::Settings settings = {};
 
@@ -153,6 +216,72 @@ blink::Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.enable_software_rendering =
       command_line.HasOption(FlagForSwitch(Switch::EnableSoftwareRendering));
 
+  settings.enable_async_raster_cache =
+      command_line.HasOption(FlagForSwitch(Switch::EnableAsyncRasterCache));
+
+  if (command_line.HasOption(FlagForSwitch(Switch::LayerTreePipelineDepth))) {
+    if (!GetSwitchValue(command_line, Switch::LayerTreePipelineDepth,
+                        &settings.layer_tree_pipeline_depth) ||
+        settings.layer_tree_pipeline_depth == 0) {
+      settings.layer_tree_pipeline_depth = 2;
+      FML_LOG(INFO) << "Layer tree pipeline depth specified was malformed. "
+                       "Will default to "
+                    << settings.layer_tree_pipeline_depth;
+    }
+  }
+
+  settings.drop_superseded_frames =
+      command_line.HasOption(FlagForSwitch(Switch::DropSupersededFrames));
+
+  if (command_line.HasOption(FlagForSwitch(Switch::FrameTimingsReportCount))) {
+    if (!GetSwitchValue(command_line, Switch::FrameTimingsReportCount,
+                        &settings.frame_timings_report_count) ||
+        settings.frame_timings_report_count == 0) {
+      settings.frame_timings_report_count = 100;
+      FML_LOG(INFO) << "Frame timings report count specified was malformed. "
+                       "Will default to "
+                    << settings.frame_timings_report_count;
+    }
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::FrameTimingsReportInterval))) {
+    if (!GetSwitchValue(command_line, Switch::FrameTimingsReportInterval,
+                        &settings.frame_timings_report_interval_ms)) {
+      settings.frame_timings_report_interval_ms = 100;
+      FML_LOG(INFO) << "Frame timings report interval specified was "
+                       "malformed. Will default to "
+                    << settings.frame_timings_report_interval_ms;
+    }
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::SlowFrameCaptureThreshold))) {
+    if (!GetSwitchValue(command_line, Switch::SlowFrameCaptureThreshold,
+                        &settings.slow_frame_capture_threshold)) {
+      settings.slow_frame_capture_threshold = 0;
+      FML_LOG(INFO) << "Slow frame capture threshold specified was "
+                       "malformed. Slow frames will not be captured.";
+    }
+  }
+
+  command_line.GetOptionValue(FlagForSwitch(Switch::SlowFrameCapturePath),
+                              &settings.slow_frame_capture_path);
+
+  if (command_line.HasOption(FlagForSwitch(Switch::SlowFrameCaptureCount))) {
+    if (!GetSwitchValue(command_line, Switch::SlowFrameCaptureCount,
+                        &settings.slow_frame_capture_count) ||
+        settings.slow_frame_capture_count == 0) {
+      settings.slow_frame_capture_count = 10;
+      FML_LOG(INFO) << "Slow frame capture count specified was malformed. "
+                       "Will default to "
+                    << settings.slow_frame_capture_count;
+    }
+  }
+
+  settings.enable_layer_profiling =
+      command_line.HasOption(FlagForSwitch(Switch::EnableLayerProfiling));
+
   settings.endless_trace_buffer =
       command_line.HasOption(FlagForSwitch(Switch::EndlessTraceBuffer));
 
@@ -233,6 +362,15 @@ blink::Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
       settings.dart_flags.push_back(*it);
   }
 
+  GetThreadConfig(command_line, Switch::PlatformThreadConfig,
+                  &settings.platform_thread_config);
+  GetThreadConfig(command_line, Switch::UIThreadConfig,
+                  &settings.ui_thread_config);
+  GetThreadConfig(command_line, Switch::GPUThreadConfig,
+                  &settings.gpu_thread_config);
+  GetThreadConfig(command_line, Switch::IOThreadConfig,
+                  &settings.io_thread_config);
+
 #if FLUTTER_RUNTIME_MODE != FLUTTER_RUNTIME_MODE_RELEASE && \
     FLUTTER_RUNTIME_MODE != FLUTTER_RUNTIME_MODE_DYNAMIC_RELEASE
   settings.trace_skia =
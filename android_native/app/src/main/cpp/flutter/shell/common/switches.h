@@ -78,6 +78,46 @@ DEF_SWITCH(EnableSoftwareRendering,
            "Enable rendering using the Skia software backend. This is useful"
            "when testing Flutter on emulators. By default, Flutter will"
            "attempt to either use OpenGL or Vulkan.")
+DEF_SWITCH(EnableAsyncRasterCache,
+           "enable-async-raster-cache",
+           "Populate the raster cache of software surfaces on a background "
+           "thread. Frames keep drawing pictures directly till their cached "
+           "images are ready instead of rasterizing them during the frame.")
+DEF_SWITCH(LayerTreePipelineDepth,
+           "layer-tree-pipeline-depth",
+           "The number of frames the UI thread may build ahead of the GPU "
+           "thread. Defaults to 2.")
+DEF_SWITCH(DropSupersededFrames,
+           "drop-superseded-frames",
+           "When the GPU thread falls behind, rasterize only the latest frame "
+           "the UI thread built and drop the older ones. Requires a layer "
+           "tree pipeline depth of more than 1 to have an effect.")
+DEF_SWITCH(FrameTimingsReportCount,
+           "frame-timings-report-count",
+           "The number of frames whose timings are reported together. "
+           "Defaults to 100.")
+DEF_SWITCH(FrameTimingsReportInterval,
+           "frame-timings-report-interval",
+           "The time in milliseconds after which the timings of a frame are "
+           "reported even if the batch is not full yet. Defaults to 100.")
+DEF_SWITCH(SlowFrameCaptureThreshold,
+           "slow-frame-capture-threshold",
+           "Capture the picture, layer tree and trace of frames that take "
+           "longer than this many frame intervals. Requires "
+           "--slow-frame-capture-path. Defaults to 0, which disables "
+           "capturing.")
+DEF_SWITCH(SlowFrameCapturePath,
+           "slow-frame-capture-path",
+           "The directory slow frames are captured to.")
+DEF_SWITCH(SlowFrameCaptureCount,
+           "slow-frame-capture-count",
+           "The number of the most recent slow frame captures that are kept. "
+           "Defaults to 10.")
+DEF_SWITCH(EnableLayerProfiling,
+           "enable-layer-profiling",
+           "Measure the time each layer takes to preroll and paint and count "
+           "its save layers and raster cache hits. Slow frame captures then "
+           "include the profile as folded stacks for flame graph tools.")
 DEF_SWITCH(SkiaDeterministicRendering,
            "skia-deterministic-rendering",
            "Skips the call to SkGraphics::Init(), thus avoiding swapping out"
@@ -129,6 +169,23 @@ DEF_SWITCH(DartNonCheckedMode,
            "precompiled and checked mode is unsupported. However, this flag "
            "may be specified if the user wishes to run in the debug product "
            "mode (i.e. with JIT or DBC) with checked mode off.")
+DEF_SWITCH(PlatformThreadConfig,
+           "platform-thread-config",
+           "How to schedule the platform thread on Linux and Android. A comma "
+           "separated list of policy=normal|batch|idle|fifo|rr, nice=<-20 to "
+           "19> for the normal and batch policies, which implies the normal "
+           "policy if none is given, priority=<1 to 99> for the fifo and rr "
+           "policies and cpus=<hexadecimal mask of the allowed CPUs>. For "
+           "example, --ui-thread-config=policy=normal,nice=-4,cpus=0xf0.")
+DEF_SWITCH(UIThreadConfig,
+           "ui-thread-config",
+           "How to schedule the UI thread. See --platform-thread-config.")
+DEF_SWITCH(GPUThreadConfig,
+           "gpu-thread-config",
+           "How to schedule the GPU thread. See --platform-thread-config.")
+DEF_SWITCH(IOThreadConfig,
+           "io-thread-config",
+           "How to schedule the IO thread. See --platform-thread-config.")
 DEF_SWITCHES_END
 
 void PrintUsage(const std::string& executable_name);
@@ -4,27 +4,38 @@
 
 #include "flutter/shell/common/thread_host.h"
 
+#include <utility>
+
 namespace shell {
 
 ThreadHost::ThreadHost() = default;
 
 ThreadHost::ThreadHost(ThreadHost&&) = default;
 
-ThreadHost::ThreadHost(std::string name_prefix, uint64_t mask) {
+ThreadHost::ThreadHost(std::string name_prefix, uint64_t mask)
+    : ThreadHost(std::move(name_prefix), mask, blink::Settings()) {}
+
+ThreadHost::ThreadHost(std::string name_prefix,
+                       uint64_t mask,
+                       const blink::Settings& settings) {
   if (mask & ThreadHost::Type::Platform) {
-    platform_thread = std::make_unique<fml::Thread>(name_prefix + ".platform");
+    platform_thread = std::make_unique<fml::Thread>(
+        name_prefix + ".platform", settings.platform_thread_config);
   }
 
   if (mask & ThreadHost::Type::UI) {
-    ui_thread = std::make_unique<fml::Thread>(name_prefix + ".ui");
+    ui_thread = std::make_unique<fml::Thread>(name_prefix + ".ui",
+                                              settings.ui_thread_config);
   }
 
   if (mask & ThreadHost::Type::GPU) {
-    gpu_thread = std::make_unique<fml::Thread>(name_prefix + ".gpu");
+    gpu_thread = std::make_unique<fml::Thread>(name_prefix + ".gpu",
+                                               settings.gpu_thread_config);
   }
 
   if (mask & ThreadHost::Type::IO) {
-    io_thread = std::make_unique<fml::Thread>(name_prefix + ".io");
+    io_thread = std::make_unique<fml::Thread>(name_prefix + ".io",
+                                              settings.io_thread_config);
   }
 }
 
@@ -35,6 +46,7 @@ void ThreadHost::Reset() {
   ui_thread.reset();
   gpu_thread.reset();
   io_thread.reset();
+  shared_threads.reset();
 }
 
 }  // namespace shell
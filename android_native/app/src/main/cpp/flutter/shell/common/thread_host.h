@@ -7,8 +7,10 @@
 
 #include <memory>
 
+#include "flutter/common/settings.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/thread.h"
+#include "flutter/shell/common/shared_thread_host.h"
 
 namespace shell {
 
@@ -24,6 +26,8 @@ struct ThreadHost {
   std::unique_ptr<fml::Thread> ui_thread;
   std::unique_ptr<fml::Thread> gpu_thread;
   std::unique_ptr<fml::Thread> io_thread;
+  // Set instead of the threads above for engines that run on shared threads.
+  std::shared_ptr<SharedThreadHost> shared_threads;
 
   ThreadHost();
 
@@ -33,6 +37,12 @@ struct ThreadHost {
 
   ThreadHost(std::string name_prefix, uint64_t type_mask);
 
+  // Like the above but schedules the threads as the thread configs of
+  // |settings| ask for.
+  ThreadHost(std::string name_prefix,
+             uint64_t type_mask,
+             const blink::Settings& settings);
+
   ~ThreadHost();
 
   void Reset();
@@ -36,7 +36,8 @@ void VsyncWaiter::FireCallback(fml::TimePoint frame_start_time,
   }
 
   task_runners_.GetUITaskRunner()->PostTask(
-      [callback, frame_start_time, frame_target_time]() {
+      [callback = std::move(callback), frame_start_time,
+       frame_target_time]() mutable {
 #if defined(OS_FUCHSIA)
         // In general, traces on Fuchsia are recorded across the whole system.
         // Because of this, emitting a "VSYNC" event per flutter process is
@@ -49,7 +50,8 @@ void VsyncWaiter::FireCallback(fml::TimePoint frame_start_time,
         TRACE_EVENT0("flutter", "VSYNC");
 #endif
         callback(frame_start_time, frame_target_time);
-      });
+      },
+      fml::TaskPriority::kFrame);
 }
 
 }  // namespace shell
@@ -11,13 +11,14 @@
 
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/time/time_point.h"
+#include "flutter/fml/unique_function.h"
 
 namespace shell {
 
 class VsyncWaiter : public std::enable_shared_from_this<VsyncWaiter> {
  public:
-  using Callback = std::function<void(fml::TimePoint frame_start_time,
-                                      fml::TimePoint frame_target_time)>;
+  using Callback = fml::UniqueFunction<void(fml::TimePoint frame_start_time,
+                                            fml::TimePoint frame_target_time)>;
 
   virtual ~VsyncWaiter();
 
@@ -25,7 +25,10 @@ VsyncWaiterFallback::VsyncWaiterFallback(blink::TaskRunners task_runners)
       phase_(fml::TimePoint::Now()),
       weak_factory_(this) {}
 
-VsyncWaiterFallback::~VsyncWaiterFallback() = default;
+VsyncWaiterFallback::~VsyncWaiterFallback() {
+  // The task would do nothing without the waiter.
+  pending_vsync_.Cancel();
+}
 
 constexpr fml::TimeDelta interval = fml::TimeDelta::FromSecondsF(1.0 / 60.0);
 
@@ -34,14 +37,14 @@ void VsyncWaiterFallback::AwaitVSync() {
   fml::TimePoint now = fml::TimePoint::Now();
   fml::TimePoint next = SnapToNextTick(now, phase_, interval);
 
-  task_runners_.GetUITaskRunner()->PostDelayedTask(
+  pending_vsync_ = task_runners_.GetUITaskRunner()->PostDelayedTask(
       [self = weak_factory_.GetWeakPtr()] {
         if (self) {
           const auto frame_time = fml::TimePoint::Now();
           self->FireCallback(frame_time, frame_time + interval);
         }
       },
-      next - now);
+      next - now, fml::TaskPriority::kFrame);
 }
 
 }  // namespace shell
@@ -7,6 +7,7 @@
 
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/fml/task_handle.h"
 #include "flutter/fml/time/time_point.h"
 #include "flutter/shell/common/vsync_waiter.h"
 
@@ -20,6 +21,7 @@ class VsyncWaiterFallback final : public VsyncWaiter {
 
  private:
   fml::TimePoint phase_;
+  fml::TaskHandle pending_vsync_;
   fml::WeakPtrFactory<VsyncWaiterFallback> weak_factory_;
 
   // |shell::VsyncWaiter|
@@ -2,25 +2,233 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-
 #include "flutter/shell/platform/embedder/embedder.h"
 
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/common/task_runners.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_recorder.h"
+#include "flutter/shell/common/rasterizer.h"
+#include "flutter/shell/common/run_configuration.h"
+#include "flutter/shell/common/switches.h"
+#include "flutter/shell/common/thread_host.h"
+#include "flutter/shell/platform/embedder/embedder_engine.h"
+#include "flutter/shell/platform/embedder/platform_view_embedder.h"
+
+// Reads |member| only if the embedder built |pointer| with a version of this
+// header that has the member. Structs grow with new members at their end.
+#define SAFE_ACCESS(pointer, member, default_value)                      \
+  ([=]() {                                                               \
+    if (offsetof(std::remove_pointer<decltype(pointer)>::type, member) + \
+            sizeof(pointer->member) <=                                   \
+        pointer->struct_size) {                                          \
+      return pointer->member;                                            \
+    }                                                                    \
+    return static_cast<decltype(pointer->member)>((default_value));      \
+  })()
+
+// Writes |member| only if the embedder built |pointer| with a version of this
+// header that has the member. See |SAFE_ACCESS|.
+#define SAFE_STORE(pointer, member, value)                               \
+  do {                                                                   \
+    if (offsetof(std::remove_pointer<decltype(pointer)>::type, member) + \
+            sizeof(pointer->member) <=                                   \
+        pointer->struct_size) {                                          \
+      pointer->member = (value);                                         \
+    }                                                                    \
+  } while (0)
+
+static bool IsSoftwareRendererConfigValid(const FlutterRendererConfig* config) {
+  if (config->type != kSoftware) {
+    return false;
+  }
+
+  const FlutterSoftwareRendererConfig* software_config = &config->software;
+
+  return SAFE_ACCESS(software_config, surface_present_callback, nullptr) !=
+         nullptr;
+}
+
+static shell::EmbedderSurfaceSoftware::SoftwareDispatchTable
+CreateSoftwareDispatchTable(const FlutterRendererConfig* config,
+                            void* user_data) {
+  const FlutterSoftwareRendererConfig* software_config = &config->software;
+
+  auto present = SAFE_ACCESS(software_config, surface_present_callback,
+                             nullptr);
+  auto acquire = SAFE_ACCESS(software_config, surface_acquire_buffer_callback,
+                             nullptr);
+
+  shell::EmbedderSurfaceSoftware::SoftwareDispatchTable dispatch_table;
+  dispatch_table.software_present_backing_store =
+      [present, user_data](const void* allocation, size_t row_bytes,
+                           size_t height) {
+        return present(user_data, allocation, row_bytes, height);
+      };
+  if (acquire != nullptr) {
+    dispatch_table.software_acquire_backing_store =
+        [acquire, user_data](const SkISize& size, size_t* row_bytes) {
+          return acquire(user_data, size.width(), size.height(), row_bytes);
+        };
+    dispatch_table.software_buffer_count =
+        SAFE_ACCESS(software_config, surface_buffer_count, 0);
+  }
+  return dispatch_table;
+}
+
+static blink::FrameTimingsCallback CreateFrameTimingsCallback(
+    FlutterFrameTimingsCallback callback,
+    void* user_data) {
+  return [callback,
+          user_data](const std::vector<blink::FrameTiming>& timings) {
+    auto nanoseconds = [](fml::TimePoint time) {
+      return time.ToEpochDelta().ToNanoseconds();
+    };
+    std::vector<FlutterFrameTiming> embedder_timings(timings.size());
+    for (size_t i = 0; i < timings.size(); i++) {
+      const auto& timing = timings[i];
+      auto& embedder_timing = embedder_timings[i];
+      embedder_timing.struct_size = sizeof(FlutterFrameTiming);
+      embedder_timing.vsync_start =
+          nanoseconds(timing.Get(blink::FrameTiming::kVsyncStart));
+      embedder_timing.build_start =
+          nanoseconds(timing.Get(blink::FrameTiming::kBuildStart));
+      embedder_timing.build_finish =
+          nanoseconds(timing.Get(blink::FrameTiming::kBuildFinish));
+      embedder_timing.raster_start =
+          nanoseconds(timing.Get(blink::FrameTiming::kRasterStart));
+      embedder_timing.raster_finish =
+          nanoseconds(timing.Get(blink::FrameTiming::kRasterFinish));
+      embedder_timing.submit =
+          nanoseconds(timing.Get(blink::FrameTiming::kSubmit));
+    }
+    callback(user_data, embedder_timings.data(), embedder_timings.size());
+  };
+}
+
 FlutterResult FlutterEngineRun(size_t version,
-                               const void* config,
-                               const void* args,
+                               const FlutterRendererConfig* config,
+                               const FlutterProjectArgs* args,
                                void* user_data,
-                               FlutterEngine* engine_out){
+                               FlutterEngine* engine_out) {
   // Step 0: Figure out arguments for shell creation.
   if (version != FLUTTER_ENGINE_VERSION) {
     return kInvalidLibraryVersion;
   }
 
-  if (engine_out == nullptr) {
+  if (engine_out == nullptr || config == nullptr || args == nullptr) {
+    return kInvalidArguments;
+  }
+
+  if (SAFE_ACCESS(args, assets_path, nullptr) == nullptr ||
+      SAFE_ACCESS(args, main_path, nullptr) == nullptr) {
+    return kInvalidArguments;
+  }
+
+  // Only the software renderer is supported. It works without a GPU, which
+  // makes it usable for rendering on servers, benchmarks and snapshots.
+  if (!IsSoftwareRendererConfigValid(config)) {
+    FML_LOG(ERROR) << "The renderer configuration was invalid.";
+    return kInvalidArguments;
+  }
+
+  blink::Settings settings;
+  const int argc = SAFE_ACCESS(args, command_line_argc, 0);
+  const char* const* argv = SAFE_ACCESS(args, command_line_argv, nullptr);
+  if (argc > 0 && argv != nullptr) {
+    settings = shell::SettingsFromCommandLine(
+        fml::CommandLineFromArgcArgv(argc, argv));
+  }
+  settings.assets_path = args->assets_path;
+  settings.main_dart_file_path = args->main_path;
+  if (const char* icu_data_path = SAFE_ACCESS(args, icu_data_path, nullptr)) {
+    settings.icu_data_path = icu_data_path;
+  }
+  if (auto frame_timings_callback =
+          SAFE_ACCESS(args, frame_timings_callback, nullptr)) {
+    settings.frame_timings_callback =
+        CreateFrameTimingsCallback(frame_timings_callback, user_data);
+  }
+
+  // Step 1: Create the threads. The engine owns all its threads. So the
+  // embedder does not have to pump a message loop on the calling thread.
+  shell::ThreadHost thread_host;
+  if (SAFE_ACCESS(args, shared_threads, false)) {
+    thread_host.shared_threads = shell::SharedThreadHost::GetShared(settings);
+  } else {
+    thread_host = shell::ThreadHost("io.flutter.embedder",
+                                    shell::ThreadHost::Type::Platform |
+                                        shell::ThreadHost::Type::GPU |
+                                        shell::ThreadHost::Type::UI |
+                                        shell::ThreadHost::Type::IO,
+                                    settings);
+  }
+
+  blink::TaskRunners task_runners =
+      thread_host.shared_threads
+          ? thread_host.shared_threads->CreateTaskRunners("io.flutter")
+          : blink::TaskRunners(
+                "io.flutter",                                  // label
+                thread_host.platform_thread->GetTaskRunner(),  // platform
+                thread_host.gpu_thread->GetTaskRunner(),       // gpu
+                thread_host.ui_thread->GetTaskRunner(),        // ui
+                thread_host.io_thread->GetTaskRunner()         // io
+            );
+
+  // Step 2: Create the shell along with the software surface.
+  auto software_dispatch_table = CreateSoftwareDispatchTable(config, user_data);
+
+  shell::Shell::CreateCallback<shell::PlatformView> on_create_platform_view =
+      [software_dispatch_table](shell::Shell& shell) {
+        return std::make_unique<shell::PlatformViewEmbedder>(
+            shell,                    // delegate
+            shell.GetTaskRunners(),   // task runners
+            software_dispatch_table   // software dispatch table
+        );
+      };
+
+  shell::Shell::CreateCallback<shell::Rasterizer> on_create_rasterizer =
+      [](shell::Shell& shell) {
+        return std::make_unique<shell::Rasterizer>(shell,
+                                                    shell.GetTaskRunners());
+      };
+
+  auto engine = std::make_unique<shell::EmbedderEngine>(
+      std::move(thread_host),    //
+      std::move(task_runners),   //
+      settings,                  //
+      on_create_platform_view,   //
+      on_create_rasterizer       //
+  );
+
+  if (!engine->IsValid()) {
+    return kInvalidArguments;
+  }
+
+  if (!engine->NotifyCreated()) {
     return kInvalidArguments;
   }
 
-  // TODO:
+  // Step 3: Launch the application.
+  auto asset_manager = std::make_shared<blink::AssetManager>();
+  asset_manager->PushBack(std::make_unique<blink::DirectoryAssetBundle>(
+      fml::OpenDirectory(settings.assets_path.c_str(), false,
+                         fml::FilePermission::kRead)));
+
+  if (!engine->Run(shell::RunConfiguration(std::move(asset_manager)))) {
+    return kInvalidArguments;
+  }
 
+  // Finally! Release the ownership of the engine to the embedder.
+  *engine_out = reinterpret_cast<FlutterEngine>(engine.release());
   return kSuccess;
 }
 
@@ -29,7 +237,96 @@ FlutterResult FlutterEngineShutdown(FlutterEngine engine) {
     return kInvalidArguments;
   }
 
-  // TODO:
+  auto embedder_engine = reinterpret_cast<shell::EmbedderEngine*>(engine);
+  embedder_engine->NotifyDestroyed();
+  delete embedder_engine;
+  return kSuccess;
+}
+
+FlutterResult FlutterEngineSendWindowMetricsEvent(
+    FlutterEngine engine,
+    const FlutterWindowMetricsEvent* event) {
+  if (engine == nullptr || event == nullptr) {
+    return kInvalidArguments;
+  }
+
+  blink::ViewportMetrics metrics;
+  metrics.physical_width = SAFE_ACCESS(event, width, 0);
+  metrics.physical_height = SAFE_ACCESS(event, height, 0);
+  metrics.device_pixel_ratio = SAFE_ACCESS(event, pixel_ratio, 1.0);
+
+  return reinterpret_cast<shell::EmbedderEngine*>(engine)->SetViewportMetrics(
+             std::move(metrics))
+             ? kSuccess
+             : kInvalidArguments;
+}
+
+static FlutterDurationStatistics ToEmbedderStatistics(
+    const flow::LapStatistics& statistics) {
+  const auto& laps = statistics.laps;
+  FlutterDurationStatistics embedder_statistics = {};
+  embedder_statistics.count = laps.count();
+  embedder_statistics.missed_frames = statistics.missed_frames;
+  embedder_statistics.p50 = laps.Percentile(50).ToNanoseconds();
+  embedder_statistics.p90 = laps.Percentile(90).ToNanoseconds();
+  embedder_statistics.p99 = laps.Percentile(99).ToNanoseconds();
+  embedder_statistics.max = laps.max().ToNanoseconds();
+  return embedder_statistics;
+}
+
+FlutterResult FlutterEngineGetFrameStatistics(
+    FlutterEngine engine,
+    bool start_new_window,
+    FlutterFrameStatistics* statistics) {
+  if (engine == nullptr || statistics == nullptr) {
+    return kInvalidArguments;
+  }
+
+  flow::FrameStatistics window;
+  if (!reinterpret_cast<shell::EmbedderEngine*>(engine)->GetFrameStatistics(
+          start_new_window, &window)) {
+    return kInvalidArguments;
+  }
 
+  SAFE_STORE(statistics, frame, ToEmbedderStatistics(window.frame));
+  SAFE_STORE(statistics, raster, ToEmbedderStatistics(window.raster));
+  SAFE_STORE(statistics, ui, ToEmbedderStatistics(window.ui));
   return kSuccess;
-}
\ No newline at end of file
+}
+
+FlutterResult FlutterEngineSetTraceRecording(bool enabled,
+                                             const char* const* categories,
+                                             size_t category_count) {
+  if (category_count > 0 && categories == nullptr) {
+    return kInvalidArguments;
+  }
+
+  std::vector<std::string> enabled_categories;
+  for (size_t i = 0; i < category_count; i++) {
+    if (categories[i] == nullptr) {
+      return kInvalidArguments;
+    }
+    enabled_categories.emplace_back(categories[i]);
+  }
+
+  auto& recorder = fml::tracing::TraceRecorder::GetInstance();
+  recorder.SetEnabledCategories(enabled_categories);
+  recorder.SetEnabled(enabled);
+  return kSuccess;
+}
+
+FlutterResult FlutterEngineGetTrace(bool clear,
+                                    FlutterTraceCallback callback,
+                                    void* user_data) {
+  if (callback == nullptr) {
+    return kInvalidArguments;
+  }
+
+  auto& recorder = fml::tracing::TraceRecorder::GetInstance();
+  const std::string trace = recorder.GetChromeTraceJSON();
+  if (clear) {
+    recorder.Clear();
+  }
+  callback(user_data, trace.c_str(), trace.size());
+  return kSuccess;
+}
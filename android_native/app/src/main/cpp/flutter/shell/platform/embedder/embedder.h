@@ -33,19 +33,191 @@ typedef enum {
 
 typedef struct _FlutterEngine* FlutterEngine;
 
+// Called on the GPU thread with the pixels of each frame once it is fully
+// rendered. The pixels are 32-bit premultiplied in the native byte order of
+// Skia (kN32_SkColorType) and stay valid only for the duration of the call.
+// Returns whether the frame was presented.
+typedef bool (*SoftwareSurfacePresentCallback)(void* /* user data */,
+                                               const void* /* allocation */,
+                                               size_t /* row bytes */,
+                                               size_t /* height */);
 
+// Called on the GPU thread before a frame of the given size is rendered.
+// Returns a buffer of at least |row bytes| * |height| bytes that the frame is
+// rendered into directly, or NULL to have the engine render into its own
+// buffer. |row bytes| is preset to the minimum and may be increased by the
+// callee. The buffer must stay valid till the present callback of the frame
+// returns. Its contents do not need to be preserved between frames unless
+// |surface_buffer_count| says so.
+typedef void* (*SoftwareSurfaceAcquireBufferCallback)(
+    void* /* user data */,
+    size_t /* width */,
+    size_t /* height */,
+    size_t* /* row bytes, in/out */);
+
+typedef struct {
+  // The size of this struct. Must be sizeof(FlutterSoftwareRendererConfig).
+  size_t struct_size;
+  // Required.
+  SoftwareSurfacePresentCallback surface_present_callback;
+  // Optional. Enables rendering straight into buffers owned by the embedder.
+  SoftwareSurfaceAcquireBufferCallback surface_acquire_buffer_callback;
+  // Optional. The number of buffers |surface_acquire_buffer_callback| cycles
+  // through in turn, if they keep their contents between frames. A buffer
+  // then still holds the frame presented that many frames ago and only what
+  // changed since is rendered into it. 0 if the contents are not preserved.
+  // The engine then copies the previous frame into each buffer before
+  // rendering the changes.
+  size_t surface_buffer_count;
+} FlutterSoftwareRendererConfig;
+
+typedef struct {
+  FlutterRendererType type;
+  union {
+    FlutterSoftwareRendererConfig software;
+  };
+} FlutterRendererConfig;
+
+typedef struct {
+  // The size of this struct. Must be sizeof(FlutterFrameTiming).
+  size_t struct_size;
+  // When the phases of a frame happened, in nanoseconds on the monotonic clock
+  // of the engine. The vsync start is the vsync the frame was built for and
+  // the submit time is when the rendered frame was handed to the surface.
+  // Frames dropped in favor of a newer frame before they were rendered have
+  // zero raster and submit times.
+  int64_t vsync_start;
+  int64_t build_start;
+  int64_t build_finish;
+  int64_t raster_start;
+  int64_t raster_finish;
+  int64_t submit;
+} FlutterFrameTiming;
+
+// Called on the platform thread with the timings of the frames rendered since
+// the previous call. Frames are reported in batches whose size and maximum
+// delay are set by the "--frame-timings-report-count" and
+// "--frame-timings-report-interval" switches. The timings stay valid only for
+// the duration of the call.
+typedef void (*FlutterFrameTimingsCallback)(
+    void* /* user data */,
+    const FlutterFrameTiming* /* timings */,
+    size_t /* timings count */);
+
+typedef struct {
+  // The size of this struct. Must be sizeof(FlutterProjectArgs).
+  size_t struct_size;
+  // The path to the directory with the assets of the application.
+  const char* assets_path;
+  // The path to the main script of the application.
+  const char* main_path;
+  // Optional. The path to the ICU data file.
+  const char* icu_data_path;
+  // Optional. Engine switches like "--ui-thread-config=policy=normal,nice=-4"
+  // that are parsed into the settings of the engine. The first argument is
+  // skipped like the name of an executable.
+  int command_line_argc;
+  const char* const* command_line_argv;
+  // Optional. Runs the engine on threads shared with the other engines of the
+  // process that set this instead of on four threads of its own.
+  bool shared_threads;
+  // Optional. Receives the timings of the frames for jank detection.
+  FlutterFrameTimingsCallback frame_timings_callback;
+} FlutterProjectArgs;
+
+typedef struct {
+  // The size of this struct. Must be sizeof(FlutterWindowMetricsEvent).
+  size_t struct_size;
+  // Physical width of the window.
+  size_t width;
+  // Physical height of the window.
+  size_t height;
+  // Scale factor for the physical screen.
+  double pixel_ratio;
+} FlutterWindowMetricsEvent;
+
+typedef struct {
+  // The number of frames.
+  uint64_t count;
+  // The frames that took longer than a frame interval at 60Hz.
+  uint64_t missed_frames;
+  // Percentiles of the durations in nanoseconds. They are accurate to within
+  // about 3%. The maximum is exact unless a new window was started.
+  int64_t p50;
+  int64_t p90;
+  int64_t p99;
+  int64_t max;
+} FlutterDurationStatistics;
+
+typedef struct {
+  // The size of this struct. Only the members that fit in it are filled in.
+  size_t struct_size;
+  // From the vsync a frame was built for till it was submitted.
+  FlutterDurationStatistics frame;
+  FlutterDurationStatistics raster;
+  // From the vsync a frame was built for till the UI thread built it.
+  FlutterDurationStatistics ui;
+} FlutterFrameStatistics;
+
+// Starts an engine that renders into the surface described by |config|. The
+// engine runs on threads of its own. So the calling thread does not need to
+// run a message loop. Only the software renderer is supported. Frames are only
+// rendered once the window metrics are known. See
+// |FlutterEngineSendWindowMetricsEvent|.
 FLUTTER_EXPORT
 FlutterResult FlutterEngineRun(size_t version,
-                               const void* config,
-                               const void* args,
+                               const FlutterRendererConfig* config,
+                               const FlutterProjectArgs* args,
                                void* user_data,
                                FlutterEngine* engine_out);
 
+// Stops the engine and joins its threads. No callbacks are made after this
+// returns.
 FLUTTER_EXPORT
 FlutterResult FlutterEngineShutdown(FlutterEngine engine);
 
+FLUTTER_EXPORT
+FlutterResult FlutterEngineSendWindowMetricsEvent(
+    FlutterEngine engine,
+    const FlutterWindowMetricsEvent* event);
+
+// Fills |statistics| with those of the frames rendered since the last call
+// that started a new window, or since the engine started. Pass
+// |start_new_window| to start one after this call. Blocks till the GPU thread
+// has looked them up. So it must not be called on that thread.
+FLUTTER_EXPORT
+FlutterResult FlutterEngineGetFrameStatistics(
+    FlutterEngine engine,
+    bool start_new_window,
+    FlutterFrameStatistics* statistics);
+
+// Starts or stops recording trace events. The recorder is shared by all the
+// engines of the process and may be toggled at any time, before or after
+// engines are started. Stopping keeps the events recorded so far. If
+// |category_count| is not zero, only the category groups in |categories| are
+// recorded. Otherwise, all of them are.
+FLUTTER_EXPORT
+FlutterResult FlutterEngineSetTraceRecording(bool enabled,
+                                             const char* const* categories,
+                                             size_t category_count);
+
+// Called with the recorded trace events in the Chrome trace event format,
+// which chrome://tracing and the Perfetto UI load. The trace stays valid only
+// for the duration of the call.
+typedef void (*FlutterTraceCallback)(void* /* user data */,
+                                     const char* /* trace */,
+                                     size_t /* trace length */);
+
+// Exports the trace events recorded so far on the calling thread. Recording
+// goes on meanwhile. If |clear| is set, the events are discarded afterwards,
+// together with any recorded during the export.
+FLUTTER_EXPORT
+FlutterResult FlutterEngineGetTrace(bool clear,
+                                    FlutterTraceCallback callback,
+                                    void* user_data);
+
 #if defined(__cplusplus)
 }  // extern "C"
 #endif
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,132 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/embedder/embedder_engine.h"
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/make_copyable.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+
+namespace shell {
+
+EmbedderEngine::EmbedderEngine(
+    ThreadHost thread_host,
+    blink::TaskRunners task_runners,
+    blink::Settings settings,
+    Shell::CreateCallback<PlatformView> on_create_platform_view,
+    Shell::CreateCallback<Rasterizer> on_create_rasterizer)
+    : thread_host_(std::move(thread_host)),
+      shell_(Shell::Create(std::move(task_runners),
+                           std::move(settings),
+                           on_create_platform_view,
+                           on_create_rasterizer)) {
+  if (!shell_) {
+    return;
+  }
+
+  is_valid_ = true;
+}
+
+EmbedderEngine::~EmbedderEngine() {
+  // The shell tears itself down on the threads of the thread host. So it has
+  // to be collected before the threads are joined.
+  shell_.reset();
+  thread_host_.Reset();
+}
+
+bool EmbedderEngine::IsValid() const {
+  return is_valid_;
+}
+
+void EmbedderEngine::RunOnPlatformThreadAndWait(fml::closure task) {
+  fml::AutoResetWaitableEvent latch;
+  fml::TaskRunner::RunNowOrPostTask(
+      shell_->GetTaskRunners().GetPlatformTaskRunner(), [&latch, &task]() {
+        task();
+        latch.Signal();
+      });
+  latch.Wait();
+}
+
+bool EmbedderEngine::NotifyCreated() {
+  if (!shell_) {
+    return false;
+  }
+
+  RunOnPlatformThreadAndWait([this]() {
+    if (auto platform_view = shell_->GetPlatformView()) {
+      platform_view->NotifyCreated();
+    }
+  });
+  return true;
+}
+
+bool EmbedderEngine::NotifyDestroyed() {
+  if (!shell_) {
+    return false;
+  }
+
+  RunOnPlatformThreadAndWait([this]() {
+    if (auto platform_view = shell_->GetPlatformView()) {
+      platform_view->NotifyDestroyed();
+    }
+  });
+  return true;
+}
+
+bool EmbedderEngine::Run(RunConfiguration run_configuration) {
+  if (!IsValid()) {
+    return false;
+  }
+
+  shell_->GetTaskRunners().GetUITaskRunner()->PostTask(fml::MakeCopyable(
+      [engine = shell_->GetEngine(),
+       configuration = std::move(run_configuration)]() mutable {
+        if (!engine) {
+          return;
+        }
+        auto result = engine->Run(std::move(configuration));
+        if (result == Engine::RunStatus::Failure) {
+          FML_LOG(ERROR) << "Could not launch the engine with configuration.";
+        }
+      }));
+
+  return true;
+}
+
+bool EmbedderEngine::SetViewportMetrics(blink::ViewportMetrics metrics) {
+  if (!IsValid()) {
+    return false;
+  }
+
+  shell_->GetTaskRunners().GetPlatformTaskRunner()->PostTask(
+      [platform_view = shell_->GetPlatformView(), metrics]() {
+        if (platform_view) {
+          platform_view->SetViewportMetrics(metrics);
+        }
+      });
+  return true;
+}
+
+bool EmbedderEngine::GetFrameStatistics(bool start_new_window,
+                                        flow::FrameStatistics* statistics) {
+  if (!IsValid()) {
+    return false;
+  }
+
+  auto total = shell_->GetFrameStatistics();
+  if (!total.Wait()) {
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lock(frame_statistics_mutex_);
+  *statistics = total.Get();
+  statistics->Subtract(frame_statistics_window_start_);
+  if (start_new_window) {
+    frame_statistics_window_start_ = total.Get();
+  }
+  return true;
+}
+
+}  // namespace shell
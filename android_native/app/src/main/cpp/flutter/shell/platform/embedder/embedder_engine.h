@@ -6,8 +6,12 @@
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_ENGINE_H_
 
 #include <memory>
+#include <mutex>
 
+#include "flutter/flow/instrumentation.h"
 #include "flutter/fml/macros.h"
+#include "flutter/lib/ui/window/viewport_metrics.h"
+#include "flutter/shell/common/run_configuration.h"
 #include "flutter/shell/common/shell.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/shell/platform/embedder/embedder.h"
@@ -16,37 +20,49 @@ namespace shell {
 
 // The object that is returned to the embedder as an opaque pointer to the
 // instance of the Flutter engine.
-    class EmbedderEngine {
-    public:
-        EmbedderEngine(ThreadHost thread_host,
-                       blink::TaskRunners task_runners,
-                       blink::Settings settings,
-                       Shell::CreateCallback<PlatformView> on_create_platform_view,
-                       Shell::CreateCallback<Rasterizer> on_create_rasterizer);
+class EmbedderEngine {
+ public:
+  EmbedderEngine(ThreadHost thread_host,
+                 blink::TaskRunners task_runners,
+                 blink::Settings settings,
+                 Shell::CreateCallback<PlatformView> on_create_platform_view,
+                 Shell::CreateCallback<Rasterizer> on_create_rasterizer);
 
-        ~EmbedderEngine();
+  ~EmbedderEngine();
 
-        bool NotifyCreated();
+  // Sets up the rendering surface. Blocks till the surface is ready.
+  bool NotifyCreated();
 
-        bool NotifyDestroyed();
+  // Tears down the rendering surface. Blocks till no more frames are
+  // rendered into it.
+  bool NotifyDestroyed();
 
-        bool Run(void* run_configuration);
+  // Launches the application on the UI thread. Failures to launch are only
+  // logged.
+  bool Run(RunConfiguration run_configuration);
 
-        bool IsValid() const;
+  bool IsValid() const;
 
-        //bool SetViewportMetrics(blink::ViewportMetrics metrics);
+  bool SetViewportMetrics(blink::ViewportMetrics metrics);
 
-        //bool DispatchPointerDataPacket(std::unique_ptr<blink::PointerDataPacket> packet);
+  // Fills |statistics| with those of the frames since the window was last
+  // started. Blocks till the GPU thread has looked them up.
+  bool GetFrameStatistics(bool start_new_window,
+                          flow::FrameStatistics* statistics);
 
-        //bool SendPlatformMessage(fml::RefPtr<blink::PlatformMessage> message);
+ private:
+  // Declared first so that the threads outlive the shell.
+  ThreadHost thread_host_;
+  std::unique_ptr<Shell> shell_;
+  bool is_valid_ = false;
+  std::mutex frame_statistics_mutex_;
+  flow::FrameStatistics frame_statistics_window_start_;
 
-    private:
-        const ThreadHost thread_host_;
-        std::unique_ptr<Shell> shell_;
-        bool is_valid_ = false;
+  // Runs |task| on the platform thread and waits for it.
+  void RunOnPlatformThreadAndWait(fml::closure task);
 
-        FML_DISALLOW_COPY_AND_ASSIGN(EmbedderEngine);
-    };
+  FML_DISALLOW_COPY_AND_ASSIGN(EmbedderEngine);
+};
 
 }  // namespace shell
 
@@ -0,0 +1,138 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/embedder/embedder_surface_software.h"
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace shell {
+
+EmbedderSurfaceSoftware::EmbedderSurfaceSoftware(
+    SoftwareDispatchTable software_dispatch_table)
+    : software_dispatch_table_(std::move(software_dispatch_table)) {
+  if (!software_dispatch_table_.software_present_backing_store) {
+    return;
+  }
+  valid_ = true;
+}
+
+EmbedderSurfaceSoftware::~EmbedderSurfaceSoftware() = default;
+
+bool EmbedderSurfaceSoftware::IsValid() {
+  return valid_;
+}
+
+sk_sp<SkSurface> EmbedderSurfaceSoftware::AcquireBackingStore(
+    const SkISize& size,
+    SurfaceFrame::FramebufferInfo* framebuffer_info) {
+  const auto image_info = SkImageInfo::MakeN32Premul(size);
+
+  // Reset till the frame about to be rendered is presented.
+  const bool sk_surface_was_current = sk_surface_is_current_;
+  sk_surface_is_current_ = false;
+  if (embedder_buffer_size_ != size) {
+    embedder_buffers_presented_ = 0;
+    embedder_buffer_size_ = size;
+  }
+
+  if (software_dispatch_table_.software_acquire_backing_store) {
+    size_t row_bytes = image_info.minRowBytes();
+    void* pixels = software_dispatch_table_.software_acquire_backing_store(
+        size, &row_bytes);
+    if (pixels != nullptr) {
+      if (row_bytes < image_info.minRowBytes()) {
+        FML_LOG(ERROR) << "The embedder provided a buffer with too few bytes "
+                          "per row.";
+        return nullptr;
+      }
+      const size_t buffer_count =
+          software_dispatch_table_.software_buffer_count;
+      if (buffer_count == 0) {
+        // The rasterizer restores the last frame into buffers with unknown
+        // contents. That is cheaper than repainting it on the CPU.
+        framebuffer_info->supports_copy_back = true;
+      } else if (embedder_buffers_presented_ >= buffer_count) {
+        framebuffer_info->buffer_age = buffer_count;
+      }
+      return SkSurface::MakeRasterDirect(image_info, pixels, row_bytes);
+    }
+  }
+  embedder_buffers_presented_ = 0;
+
+  // The engine buffer keeps its contents. So it is neither copied back into
+  // nor snapshotted.
+  if (sk_surface_ != nullptr && sk_surface_->width() == size.width() &&
+      sk_surface_->height() == size.height()) {
+    framebuffer_info->buffer_age = sk_surface_was_current ? 1 : 0;
+    return sk_surface_;
+  }
+
+  sk_surface_ = SkSurface::MakeRaster(image_info);
+  if (sk_surface_ == nullptr) {
+    FML_LOG(ERROR) << "Could not create a raster surface of size "
+                   << size.width() << "x" << size.height() << ".";
+  }
+  return sk_surface_;
+}
+
+std::unique_ptr<SurfaceFrame> EmbedderSurfaceSoftware::AcquireFrame(
+    const SkISize& size) {
+  if (!IsValid() || size.isEmpty()) {
+    return nullptr;
+  }
+
+  SurfaceFrame::FramebufferInfo framebuffer_info;
+  sk_sp<SkSurface> surface = AcquireBackingStore(size, &framebuffer_info);
+  if (surface == nullptr) {
+    return nullptr;
+  }
+
+  SurfaceFrame::SubmitCallback on_submit = [this](const SurfaceFrame& frame,
+                                                  SkCanvas* canvas) -> bool {
+    TRACE_EVENT0("flutter", "EmbedderSurfaceSoftware::Present");
+    if (canvas == nullptr) {
+      // The frame was dropped. An embedder buffer it was rendered into no
+      // longer holds the frame expected of its age.
+      if (frame.SkiaSurface() != sk_surface_) {
+        embedder_buffers_presented_ = 0;
+      }
+      return false;
+    }
+
+    canvas->flush();
+
+    sk_sp<SkSurface> surface = frame.SkiaSurface();
+    SkPixmap pixmap;
+    if (!surface->peekPixels(&pixmap)) {
+      return false;
+    }
+
+    const bool presented =
+        software_dispatch_table_.software_present_backing_store(
+            pixmap.addr(), pixmap.rowBytes(), pixmap.height());
+    sk_surface_is_current_ = presented && surface == sk_surface_;
+    if (surface != sk_surface_) {
+      embedder_buffers_presented_ =
+          presented ? embedder_buffers_presented_ + 1 : 0;
+    }
+    return presented;
+  };
+
+  return std::make_unique<SurfaceFrame>(std::move(surface), framebuffer_info,
+                                        on_submit);
+}
+
+SkMatrix EmbedderSurfaceSoftware::GetRootTransformation() const {
+  SkMatrix matrix;
+  matrix.reset();
+  return matrix;
+}
+
+GrContext* EmbedderSurfaceSoftware::GetContext() {
+  // The CPU backend has no context.
+  return nullptr;
+}
+
+}  // namespace shell
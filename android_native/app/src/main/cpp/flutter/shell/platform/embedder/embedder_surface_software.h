@@ -0,0 +1,70 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
+#define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
+
+#include <functional>
+
+#include "flutter/fml/macros.h"
+#include "flutter/shell/common/surface.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace shell {
+
+// A surface that renders frames on the CPU and hands their pixels to the
+// embedder. Needs no GPU or windowing system.
+class EmbedderSurfaceSoftware final : public Surface {
+ public:
+  struct SoftwareDispatchTable {
+    // Required. See |SoftwareSurfacePresentCallback|.
+    std::function<bool(const void* allocation, size_t row_bytes, size_t height)>
+        software_present_backing_store;
+    // Optional. See |SoftwareSurfaceAcquireBufferCallback|.
+    std::function<void*(const SkISize& size, size_t* row_bytes)>
+        software_acquire_backing_store;
+    // See |FlutterSoftwareRendererConfig::surface_buffer_count|.
+    size_t software_buffer_count = 0;
+  };
+
+  explicit EmbedderSurfaceSoftware(
+      SoftwareDispatchTable software_dispatch_table);
+
+  ~EmbedderSurfaceSoftware() override;
+
+  // |shell::Surface|
+  bool IsValid() override;
+
+  // |shell::Surface|
+  std::unique_ptr<SurfaceFrame> AcquireFrame(const SkISize& size) override;
+
+  // |shell::Surface|
+  SkMatrix GetRootTransformation() const override;
+
+  // |shell::Surface|
+  GrContext* GetContext() override;
+
+ private:
+  bool valid_ = false;
+  SoftwareDispatchTable software_dispatch_table_;
+  // The buffer frames are rendered into when the embedder does not provide
+  // one. Kept across frames so that only the damaged parts are repainted.
+  sk_sp<SkSurface> sk_surface_;
+  // Whether |sk_surface_| holds the last presented frame.
+  bool sk_surface_is_current_ = false;
+  // The number of frames presented in a row from embedder buffers of
+  // |embedder_buffer_size_|.
+  size_t embedder_buffers_presented_ = 0;
+  SkISize embedder_buffer_size_ = SkISize::MakeEmpty();
+
+  sk_sp<SkSurface> AcquireBackingStore(
+      const SkISize& size,
+      SurfaceFrame::FramebufferInfo* framebuffer_info);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(EmbedderSurfaceSoftware);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_SURFACE_SOFTWARE_H_
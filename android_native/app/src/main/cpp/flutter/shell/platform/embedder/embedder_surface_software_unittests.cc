@@ -0,0 +1,102 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "flutter/shell/platform/embedder/embedder_surface_software.h"
+#include "gtest/gtest.h"
+
+namespace shell {
+namespace {
+
+// Hands out |buffer_count| buffers in turn and counts the presented frames.
+struct TestBuffers {
+  explicit TestBuffers(size_t buffer_count) : buffers(buffer_count) {}
+
+  std::vector<std::vector<uint32_t>> buffers;
+  size_t next_buffer = 0;
+  size_t presented = 0;
+
+  EmbedderSurfaceSoftware::SoftwareDispatchTable DispatchTable(
+      bool preserved) {
+    EmbedderSurfaceSoftware::SoftwareDispatchTable table;
+    table.software_present_backing_store = [this](const void*, size_t,
+                                                  size_t) {
+      presented++;
+      return true;
+    };
+    if (!buffers.empty()) {
+      table.software_acquire_backing_store = [this](const SkISize& size,
+                                                    size_t* row_bytes) {
+        auto& buffer = buffers[next_buffer++ % buffers.size()];
+        buffer.resize(size.width() * size.height());
+        return static_cast<void*>(buffer.data());
+      };
+      table.software_buffer_count = preserved ? buffers.size() : 0;
+    }
+    return table;
+  }
+};
+
+}  // namespace
+
+TEST(EmbedderSurfaceSoftware, EngineBufferKeepsItsContents) {
+  TestBuffers buffers(0);
+  EmbedderSurfaceSoftware surface(buffers.DispatchTable(false));
+  ASSERT_TRUE(surface.IsValid());
+
+  auto frame = surface.AcquireFrame(SkISize::Make(16, 16));
+  ASSERT_TRUE(frame);
+  ASSERT_EQ(frame->framebuffer_info().buffer_age, 0);
+  ASSERT_FALSE(frame->framebuffer_info().supports_copy_back);
+  ASSERT_TRUE(frame->Submit());
+
+  // The same buffer is rendered into again and is neither copied back into
+  // nor snapshotted.
+  frame = surface.AcquireFrame(SkISize::Make(16, 16));
+  ASSERT_TRUE(frame);
+  ASSERT_EQ(frame->framebuffer_info().buffer_age, 1);
+  ASSERT_FALSE(frame->framebuffer_info().supports_copy_back);
+
+  // A dropped frame leaves the buffer in an unknown state.
+  frame.reset();
+  frame = surface.AcquireFrame(SkISize::Make(16, 16));
+  ASSERT_EQ(frame->framebuffer_info().buffer_age, 0);
+}
+
+TEST(EmbedderSurfaceSoftware, EmbedderBuffersWithUnknownContentsAreCopiedBack) {
+  TestBuffers buffers(2);
+  EmbedderSurfaceSoftware surface(buffers.DispatchTable(false));
+
+  for (int i = 0; i < 3; i++) {
+    auto frame = surface.AcquireFrame(SkISize::Make(16, 16));
+    ASSERT_TRUE(frame);
+    ASSERT_EQ(frame->framebuffer_info().buffer_age, 0);
+    ASSERT_TRUE(frame->framebuffer_info().supports_copy_back);
+    ASSERT_TRUE(frame->Submit());
+  }
+  ASSERT_EQ(buffers.presented, 3u);
+}
+
+TEST(EmbedderSurfaceSoftware, PreservedEmbedderBuffersAreRenderedIntoInPlace) {
+  TestBuffers buffers(2);
+  EmbedderSurfaceSoftware surface(buffers.DispatchTable(true));
+
+  // Each buffer has to be presented once before its contents are known.
+  const int expected_ages[] = {0, 0, 2, 2};
+  for (int expected_age : expected_ages) {
+    auto frame = surface.AcquireFrame(SkISize::Make(16, 16));
+    ASSERT_TRUE(frame);
+    ASSERT_EQ(frame->framebuffer_info().buffer_age, expected_age);
+    ASSERT_FALSE(frame->framebuffer_info().supports_copy_back);
+    ASSERT_TRUE(frame->Submit());
+  }
+
+  // Resizing discards the contents.
+  auto frame = surface.AcquireFrame(SkISize::Make(32, 16));
+  ASSERT_TRUE(frame);
+  ASSERT_EQ(frame->framebuffer_info().buffer_age, 0);
+}
+
+}  // namespace shell
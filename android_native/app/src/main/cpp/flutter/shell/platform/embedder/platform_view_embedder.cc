@@ -0,0 +1,30 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/embedder/platform_view_embedder.h"
+
+#include "flutter/fml/logging.h"
+
+namespace shell {
+
+PlatformViewEmbedder::PlatformViewEmbedder(
+    PlatformView::Delegate& delegate,
+    blink::TaskRunners task_runners,
+    EmbedderSurfaceSoftware::SoftwareDispatchTable software_dispatch_table)
+    : PlatformView(delegate, std::move(task_runners)),
+      software_dispatch_table_(std::move(software_dispatch_table)) {}
+
+PlatformViewEmbedder::~PlatformViewEmbedder() = default;
+
+std::unique_ptr<Surface> PlatformViewEmbedder::CreateRenderingSurface() {
+  auto surface =
+      std::make_unique<EmbedderSurfaceSoftware>(software_dispatch_table_);
+  if (!surface->IsValid()) {
+    FML_LOG(ERROR) << "Could not create the embedder software surface.";
+    return nullptr;
+  }
+  return surface;
+}
+
+}  // namespace shell
@@ -0,0 +1,35 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_PLATFORM_VIEW_EMBEDDER_H_
+#define FLUTTER_SHELL_PLATFORM_EMBEDDER_PLATFORM_VIEW_EMBEDDER_H_
+
+#include "flutter/fml/macros.h"
+#include "flutter/shell/common/platform_view.h"
+#include "flutter/shell/platform/embedder/embedder_surface_software.h"
+
+namespace shell {
+
+class PlatformViewEmbedder final : public PlatformView {
+ public:
+  // Creates a platform view that sets up a software rendering surface.
+  PlatformViewEmbedder(
+      PlatformView::Delegate& delegate,
+      blink::TaskRunners task_runners,
+      EmbedderSurfaceSoftware::SoftwareDispatchTable software_dispatch_table);
+
+  ~PlatformViewEmbedder() override;
+
+ private:
+  EmbedderSurfaceSoftware::SoftwareDispatchTable software_dispatch_table_;
+
+  // |shell::PlatformView|
+  std::unique_ptr<Surface> CreateRenderingSurface() override;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PlatformViewEmbedder);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_PLATFORM_EMBEDDER_PLATFORM_VIEW_EMBEDDER_H_
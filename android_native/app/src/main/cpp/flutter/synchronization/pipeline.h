@@ -5,15 +5,15 @@
 #ifndef SYNCHRONIZATION_PIPELINE_H_
 #define SYNCHRONIZATION_PIPELINE_H_
 
+#include "flutter/fml/compiler_specific.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
 #include "flutter/fml/trace_event.h"
-#include "flutter/synchronization/pipeline.h"
-#include "flutter/synchronization/semaphore.h"
+#include "flutter/fml/unique_function.h"
 
+#include <atomic>
+#include <functional>
 #include <memory>
-#include <mutex>
-#include <queue>
 
 namespace flutter {
 
@@ -23,6 +23,13 @@ enum class PipelineConsumeResult {
   MoreAvailable,
 };
 
+enum class PipelineConsumePolicy {
+  // Every resource is consumed in the order it was produced.
+  InOrder,
+  // Only the latest resource is consumed. The ones it supersedes are dropped.
+  LatestWins,
+};
+
 size_t GetNextPipelineTraceID();
 
 template <class R>
@@ -38,7 +45,8 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
     ProducerContinuation() : trace_id_(0) {}
 
     ProducerContinuation(ProducerContinuation&& other)
-        : continuation_(other.continuation_), trace_id_(other.trace_id_) {
+        : continuation_(std::move(other.continuation_)),
+          trace_id_(other.trace_id_) {
       other.continuation_ = nullptr;
       other.trace_id_ = 0;
     }
@@ -71,13 +79,13 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
 
    private:
     friend class Pipeline;
-    using Continuation = std::function<void(ResourcePtr, size_t)>;
+    using Continuation = fml::UniqueFunction<void(ResourcePtr, size_t)>;
 
     Continuation continuation_;
     size_t trace_id_;
 
     ProducerContinuation(Continuation continuation, size_t trace_id)
-        : continuation_(continuation), trace_id_(trace_id) {
+        : continuation_(std::move(continuation)), trace_id_(trace_id) {
       TRACE_FLOW_BEGIN("flutter", "PipelineItem", trace_id_);
       TRACE_EVENT_ASYNC_BEGIN0("flutter", "PipelineProduce", trace_id_);
     }
@@ -85,73 +93,147 @@ class Pipeline : public fml::RefCountedThreadSafe<Pipeline<R>> {
     FML_DISALLOW_COPY_AND_ASSIGN(ProducerContinuation);
   };
 
-  explicit Pipeline(uint32_t depth) : empty_(depth), available_(0) {}
+  // A ring of |depth| slots that one producer and one consumer thread share
+  // without locks. |depth| bounds the resources that are produced, either
+  // still being prepared or waiting to be consumed.
+  explicit Pipeline(
+      uint32_t depth,
+      PipelineConsumePolicy policy = PipelineConsumePolicy::InOrder)
+      : depth_(depth),
+        policy_(policy),
+        slots_(new Slot[depth]),
+        head_(0),
+        tail_(0),
+        reserved_(0),
+        dropped_count_(0) {}
 
   ~Pipeline() = default;
 
-  bool IsValid() const { return empty_.IsValid() && available_.IsValid(); }
+  bool IsValid() const { return depth_ > 0; }
+
+  uint32_t GetDepth() const { return depth_; }
+
+  PipelineConsumePolicy GetConsumePolicy() const { return policy_; }
+
+  // The number of resources superseded before they could be consumed. Only
+  // resources of a |PipelineConsumePolicy::LatestWins| pipeline are dropped.
+  size_t GetDroppedCount() const {
+    return dropped_count_.load(std::memory_order_relaxed);
+  }
 
+  // Must only be called on the producer thread.
   ProducerContinuation Produce() {
-    if (!empty_.TryWait()) {
+    const size_t in_flight = tail_.load(std::memory_order_relaxed) +
+                             reserved_.load(std::memory_order_relaxed) -
+                             head_.load(std::memory_order_acquire);
+    if (in_flight >= depth_) {
       return {};
     }
+    reserved_.fetch_add(1, std::memory_order_relaxed);
 
     return ProducerContinuation{
-        std::bind(&Pipeline::ProducerCommit, this, std::placeholders::_1,
-                  std::placeholders::_2),  // continuation
-        GetNextPipelineTraceID()};         // trace id
+        [this](ResourcePtr resource, size_t trace_id) {
+          ProducerCommit(std::move(resource), trace_id);
+        },                          // continuation
+        GetNextPipelineTraceID()};  // trace id
   }
 
   using Consumer = std::function<void(ResourcePtr)>;
 
+  // Must only be called on the consumer thread. If not null, |dropped| is
+  // called with every resource a |PipelineConsumePolicy::LatestWins| pipeline
+  // drops, oldest first and before |consumer|.
   FML_WARN_UNUSED_RESULT
-  PipelineConsumeResult Consume(Consumer consumer) {
+  PipelineConsumeResult Consume(Consumer consumer,
+                                Consumer dropped = nullptr) {
     if (consumer == nullptr) {
       return PipelineConsumeResult::NoneAvailable;
     }
 
-    if (!available_.TryWait()) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    const size_t tail = tail_.load(std::memory_order_acquire);
+    if (head == tail) {
       return PipelineConsumeResult::NoneAvailable;
     }
 
-    ResourcePtr resource;
-    size_t trace_id = 0;
-    size_t items_count = 0;
-
-    {
-      std::lock_guard<std::mutex> lock(queue_mutex_);
-      std::tie(resource, trace_id) = std::move(queue_.front());
-      queue_.pop();
-      items_count = queue_.size();
+    size_t next = head;
+    size_t end = head + 1;
+    if (policy_ == PipelineConsumePolicy::LatestWins) {
+      // Take the newest resource and release all the slots. The producer
+      // completes the continuations it drops with no resource, so these do
+      // not supersede anything.
+      next = tail - 1;
+      while (next > head && !SlotAt(next).resource) {
+        next--;
+      }
+      end = tail;
+      size_t dropped_count = 0;
+      for (size_t index = head; index < end; index++) {
+        if (index == next) {
+          continue;
+        }
+        Slot& slot = SlotAt(index);
+        if (slot.resource) {
+          dropped_count++;
+          if (dropped) {
+            dropped(std::move(slot.resource));
+          }
+          slot.resource.reset();
+        }
+        TRACE_FLOW_END("flutter", "PipelineItem", slot.trace_id);
+      }
+      if (dropped_count > 0) {
+        FML_TRACE_COUNTER(
+            "flutter", "PipelineItemsDropped",
+            dropped_count_.fetch_add(dropped_count) + dropped_count);
+      }
     }
 
+    Slot& slot = SlotAt(next);
+    ResourcePtr resource = std::move(slot.resource);
+    const size_t trace_id = slot.trace_id;
+
     {
       TRACE_EVENT0("flutter", "PipelineConsume");
       consumer(std::move(resource));
     }
 
-    empty_.Signal();
+    // Only now may the producer reuse the slots.
+    head_.store(end, std::memory_order_release);
 
     TRACE_FLOW_END("flutter", "PipelineItem", trace_id);
 
-    return items_count > 0 ? PipelineConsumeResult::MoreAvailable
-                           : PipelineConsumeResult::Done;
+    return tail_.load(std::memory_order_acquire) > end
+               ? PipelineConsumeResult::MoreAvailable
+               : PipelineConsumeResult::Done;
   }
 
  private:
-  Semaphore empty_;
-  Semaphore available_;
-  std::mutex queue_mutex_;
-  std::queue<std::pair<ResourcePtr, size_t>> queue_;
+  struct Slot {
+    ResourcePtr resource;
+    size_t trace_id = 0;
+  };
 
-  void ProducerCommit(ResourcePtr resource, size_t trace_id) {
-    {
-      std::lock_guard<std::mutex> lock(queue_mutex_);
-      queue_.emplace(std::move(resource), trace_id);
-    }
+  const uint32_t depth_;
+  const PipelineConsumePolicy policy_;
+  std::unique_ptr<Slot[]> slots_;
+  // The count of resources consumed or dropped. Written by the consumer.
+  std::atomic_size_t head_;
+  // The count of resources committed. Written by the producer.
+  std::atomic_size_t tail_;
+  // The count of continuations not completed yet. Used by the producer.
+  std::atomic_size_t reserved_;
+  std::atomic_size_t dropped_count_;
 
-    // Ensure the queue mutex is not held as that would be a pessimization.
-    available_.Signal();
+  Slot& SlotAt(size_t index) { return slots_[index % depth_]; }
+
+  void ProducerCommit(ResourcePtr resource, size_t trace_id) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    Slot& slot = SlotAt(tail);
+    slot.resource = std::move(resource);
+    slot.trace_id = trace_id;
+    reserved_.fetch_sub(1, std::memory_order_relaxed);
+    tail_.store(tail + 1, std::memory_order_release);
   }
 
   FML_DISALLOW_COPY_AND_ASSIGN(Pipeline);
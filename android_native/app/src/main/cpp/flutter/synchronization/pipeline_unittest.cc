@@ -0,0 +1,131 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "flutter/synchronization/pipeline.h"
+#include "gtest/gtest.h"
+
+using IntPipeline = flutter::Pipeline<int>;
+
+static void ProduceValue(IntPipeline* pipeline, int value) {
+  auto continuation = pipeline->Produce();
+  ASSERT_TRUE(continuation);
+  continuation.Complete(std::make_unique<int>(value));
+}
+
+static int ConsumeValue(IntPipeline* pipeline,
+                        flutter::PipelineConsumeResult expected_result) {
+  int consumed = -1;
+  auto result = pipeline->Consume(
+      [&consumed](std::unique_ptr<int> value) { consumed = *value; });
+  EXPECT_EQ(result, expected_result);
+  return consumed;
+}
+
+TEST(PipelineTest, ConsumesInOrder) {
+  auto pipeline = fml::MakeRefCounted<IntPipeline>(2);
+  ASSERT_TRUE(pipeline->IsValid());
+  ProduceValue(pipeline.get(), 1);
+  ProduceValue(pipeline.get(), 2);
+  // The pipeline is full.
+  ASSERT_FALSE(pipeline->Produce());
+
+  ASSERT_EQ(ConsumeValue(pipeline.get(),
+                         flutter::PipelineConsumeResult::MoreAvailable),
+            1);
+  ProduceValue(pipeline.get(), 3);
+  ASSERT_EQ(ConsumeValue(pipeline.get(),
+                         flutter::PipelineConsumeResult::MoreAvailable),
+            2);
+  ASSERT_EQ(
+      ConsumeValue(pipeline.get(), flutter::PipelineConsumeResult::Done), 3);
+  ASSERT_EQ(pipeline->Consume([](std::unique_ptr<int>) {}),
+            flutter::PipelineConsumeResult::NoneAvailable);
+  ASSERT_EQ(pipeline->GetDroppedCount(), 0u);
+}
+
+TEST(PipelineTest, PendingContinuationsCountTowardsTheDepth) {
+  auto pipeline = fml::MakeRefCounted<IntPipeline>(1);
+  {
+    auto continuation = pipeline->Produce();
+    ASSERT_TRUE(continuation);
+    ASSERT_FALSE(pipeline->Produce());
+    // Dropping the continuation commits nothing to consume.
+  }
+  bool called = false;
+  ASSERT_EQ(pipeline->Consume([&called](std::unique_ptr<int> value) {
+    called = true;
+    ASSERT_EQ(value, nullptr);
+  }),
+            flutter::PipelineConsumeResult::Done);
+  ASSERT_TRUE(called);
+  ASSERT_TRUE(pipeline->Produce());
+}
+
+TEST(PipelineTest, LatestWinsDropsSupersededResources) {
+  auto pipeline = fml::MakeRefCounted<IntPipeline>(
+      3, flutter::PipelineConsumePolicy::LatestWins);
+  ProduceValue(pipeline.get(), 1);
+  ProduceValue(pipeline.get(), 2);
+  ProduceValue(pipeline.get(), 3);
+
+  ASSERT_EQ(
+      ConsumeValue(pipeline.get(), flutter::PipelineConsumeResult::Done), 3);
+  ASSERT_EQ(pipeline->GetDroppedCount(), 2u);
+
+  // A dropped continuation does not supersede the resources before it.
+  ProduceValue(pipeline.get(), 4);
+  { auto dropped = pipeline->Produce(); }
+  ASSERT_EQ(
+      ConsumeValue(pipeline.get(), flutter::PipelineConsumeResult::Done), 4);
+  ASSERT_EQ(pipeline->GetDroppedCount(), 2u);
+}
+
+TEST(PipelineTest, LatestWinsHandsOutDroppedResources) {
+  auto pipeline = fml::MakeRefCounted<IntPipeline>(
+      3, flutter::PipelineConsumePolicy::LatestWins);
+  ProduceValue(pipeline.get(), 1);
+  ProduceValue(pipeline.get(), 2);
+  ProduceValue(pipeline.get(), 3);
+
+  std::vector<int> values;
+  auto result = pipeline->Consume(
+      [&values](std::unique_ptr<int> value) { values.push_back(*value); },
+      [&values](std::unique_ptr<int> value) { values.push_back(-*value); });
+  ASSERT_EQ(result, flutter::PipelineConsumeResult::Done);
+  ASSERT_EQ(values, (std::vector<int>{-1, -2, 3}));
+  ASSERT_EQ(pipeline->GetDroppedCount(), 2u);
+}
+
+TEST(PipelineTest, ProducerAndConsumerThreads) {
+  constexpr int kCount = 10000;
+  auto pipeline = fml::MakeRefCounted<IntPipeline>(3);
+
+  std::thread producer([pipeline]() {
+    for (int i = 0; i < kCount;) {
+      if (auto continuation = pipeline->Produce()) {
+        continuation.Complete(std::make_unique<int>(i++));
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  std::vector<int> consumed;
+  while (consumed.size() < static_cast<size_t>(kCount)) {
+    auto result = pipeline->Consume(
+        [&consumed](std::unique_ptr<int> value) { consumed.push_back(*value); });
+    if (result == flutter::PipelineConsumeResult::NoneAvailable) {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+
+  for (int i = 0; i < kCount; i++) {
+    ASSERT_EQ(consumed[i], i);
+  }
+}
@@ -93,6 +93,43 @@ class PlatformSemaphore {
 
 }  // namespace flutter
 
+#elif OS_LINUX || OS_ANDROID
+#include <atomic>
+
+namespace flutter {
+
+// Nothing ever blocks on a |Semaphore|, so a counter is all it takes. Unlike
+// |sem_trywait()| and |sem_post()|, this never enters the kernel.
+class PlatformSemaphore {
+ public:
+  explicit PlatformSemaphore(uint32_t count) : count_(count) {}
+
+  ~PlatformSemaphore() = default;
+
+  bool IsValid() const { return true; }
+
+  bool TryWait() {
+    uint32_t count = count_.load(std::memory_order_relaxed);
+    while (count > 0) {
+      if (count_.compare_exchange_weak(count, count - 1,
+                                       std::memory_order_acquire,
+                                       std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void Signal() { count_.fetch_add(1, std::memory_order_release); }
+
+ private:
+  std::atomic<uint32_t> count_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PlatformSemaphore);
+};
+
+}  // namespace flutter
+
 #else
 #include <semaphore.h>
 #include "flutter/fml/eintr_wrapper.h"